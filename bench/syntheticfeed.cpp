@@ -0,0 +1,137 @@
+/**
+ * @file syntheticfeed.cpp
+ * @brief This source file contains the definitions of the synthetic simplestreams document generator used by the benchmark
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "syntheticfeed.h"
+
+#include "sha256.h"
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+struct ReleaseInfo{
+    const char* version;
+    const char* release;
+    const char* codename;
+    bool lts;
+};
+
+const ReleaseInfo releaseInfos[] = {
+    {"14.04", "trusty", "Trusty Tahr", true},
+    {"16.04", "xenial", "Xenial Xerus", true},
+    {"17.10", "artful", "Artful Aardvark", false},
+    {"18.04", "bionic", "Bionic Beaver", true},
+    {"19.10", "eoan", "Eoan Ermine", false},
+    {"20.04", "focal", "Focal Fossa", true},
+    {"21.10", "impish", "Impish Indri", false},
+    {"22.04", "jammy", "Jammy Jellyfish", true},
+    {"23.10", "mantic", "Mantic Minotaur", false},
+    {"24.04", "noble", "Noble Numbat", true},
+    {"24.10", "oracular", "Oracular Oriole", false}
+};
+
+const char* const archs[] = {"amd64", "arm64", "ppc64el", "s390x"};
+const char* const itemNames[] = {"disk1.img", "lxd.tar.xz", "root.tar.xz", "manifest"};
+
+// Versions of a release at scale 1
+#define versions_per_release 20
+
+// Serial of the i-th version, dated serials repeat every 336 versions so a suffix keeps them unique
+std::string serialOf(unsigned i){
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "2018%02u%02u", 1 + (i / 28) % 12, 1 + i % 28);
+    std::string serial(buffer);
+    if(i >= 336){
+        serial += "." + std::to_string(i);
+    }
+    return serial;
+}
+
+}
+
+SyntheticFeed generateSyntheticFeed(unsigned scale){
+    SyntheticFeed feed;
+
+    // Deterministic item sizes
+    std::uint64_t seed = 1;
+    auto nextSize = [&seed](){
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<Json::UInt64>(1000000 + (seed >> 33) % 899000000);
+    };
+
+    Json::Value root(Json::objectValue);
+    Json::Value& products = root["products"];
+    const unsigned versionCount = versions_per_release * (scale ? scale : 1);
+
+    for(const ReleaseInfo& info : releaseInfos){
+        std::string title = std::string(info.version) + (info.lts ? " LTS" : "");
+
+        SyntheticRelease release{title, info.codename, {}};
+        for(unsigned i = 0; i < versionCount; i++){
+            release.versions.push_back(serialOf(i));
+        }
+
+        for(const char* arch : archs){
+            Json::Value product(Json::objectValue);
+            product["aliases"] = std::string(info.version) + "," + info.release;
+            product["arch"] = arch;
+            product["os"] = "ubuntu";
+            product["release"] = info.release;
+            product["release_codename"] = info.codename;
+            product["release_title"] = title;
+            product["support_eol"] = "20" + std::to_string(std::stoi(info.version) + (info.lts ? 5 : 1)) + "-04-25";
+            product["supported"] = std::stoi(info.version) >= 20;
+            product["version"] = info.version;
+
+            Json::Value& versions = product["versions"];
+            for(const std::string& serial : release.versions){
+                Json::Value version(Json::objectValue);
+                Json::Value& items = version["items"];
+
+                for(const char* itemName : itemNames){
+                    std::string path = std::string("server/releases/") + info.release + "/release-" + serial + "/ubuntu-" + info.version
+                        + "-server-cloudimg-" + arch + "-" + itemName;
+
+                    Sha256 hasher;
+                    hasher.update(path.data(), path.size());
+
+                    Json::Value item(Json::objectValue);
+                    item["ftype"] = itemName;
+                    item["path"] = path;
+                    item["sha256"] = hasher.hexDigest();
+                    item["size"] = nextSize();
+                    items[itemName] = item;
+                }
+
+                version["label"] = "release";
+                version["pubname"] = std::string("ubuntu-") + info.release + "-" + info.version + "-" + arch + "-server-" + serial;
+                versions[serial] = version;
+                feed.versionCount++;
+            }
+
+            products[std::string("com.ubuntu.cloud:server:") + info.version + ":" + arch] = product;
+            feed.productCount++;
+        }
+
+        feed.releases.push_back(std::move(release));
+    }
+
+    root["content_id"] = "com.ubuntu.cloud:released:download";
+    root["datatype"] = "image-downloads";
+    root["format"] = "products:1.0";
+    root["updated"] = "Thu, 17 Oct 2024 10:00:00 +0000";
+
+    // The published feed is indented by a single space
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = " ";
+    feed.document = Json::writeString(writerBuilder, root);
+
+    return feed;
+}
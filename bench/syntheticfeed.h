@@ -0,0 +1,42 @@
+/**
+ * @file syntheticfeed.h
+ * @brief This header file contains the declarations of the synthetic simplestreams document generator used by the benchmark
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef SYNTHETICFEED_H
+#define SYNTHETICFEED_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct SyntheticRelease
+ * @brief Identity and generated versions of a release of the synthetic document
+ */
+struct SyntheticRelease{
+    std::string title;
+    std::string codename;
+    std::vector<std::string> versions;
+};
+
+/**
+ * @struct SyntheticFeed
+ * @brief Generated document and the releases it contains, so that the queries can be drawn from known data
+ */
+struct SyntheticFeed{
+    std::string document;
+    std::vector<SyntheticRelease> releases;
+    std::size_t productCount{0};
+    std::size_t versionCount{0};
+};
+
+/**
+ * @brief generates a download.json like document. At scale 1 the document has the product and version counts of the
+ * real feed, 11 releases on 4 architectures with 20 versions each carrying 4 items, the number of versions grows
+ * linearly with the scale. The output is deterministic for a given scale.
+*/
+SyntheticFeed generateSyntheticFeed(unsigned scale);
+
+#endif // SYNTHETICFEED_H
@@ -0,0 +1,927 @@
+/**
+ * @file uciibench.cpp
+ * @brief This source file contains the benchmark of the parsing, catalog building and lookup paths on synthetic feeds
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "syntheticfeed.h"
+
+#include "catalog.h"
+#include "catalogsnapshot.h"
+#include "columnarcatalog.h"
+#include "jsonstreamparser.h"
+#include "jsonstructuralparser.h"
+#include "productview.h"
+#include "ucii.h"
+
+#include <boost/program_options.hpp>
+#include <json/json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The usable size of a block is queried from the allocator of the platform, __GLIBC__ is known after any libc header
+#if defined(__GLIBC__) || defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace po = boost::program_options;
+
+/**
+ * Every allocation of the process goes through the replaced global operators below, the benchmark reads the counters
+ * before and after a measured section to report the allocations it made. The live bytes count the usable size of the
+ * blocks, including the rounding of the allocator, to report what a structure keeps resident.
+ */
+static std::atomic<std::uint64_t> allocationCount{0};
+static std::atomic<std::uint64_t> allocatedBytes{0};
+static std::atomic<std::int64_t> liveBytes{0};
+
+// Size of the block including the rounding of the allocator, 0 where the allocator can not tell it (the live bytes and
+// the footprint are then not counted)
+static std::size_t usableSize(void* pointer) noexcept{
+#if defined(__GLIBC__)
+    return malloc_usable_size(pointer);
+#elif defined(_WIN32)
+    return _msize(pointer);
+#elif defined(__APPLE__)
+    return malloc_size(pointer);
+#else
+    (void)pointer;
+    return 0;
+#endif
+}
+
+static void* allocate(std::size_t size) noexcept{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void* pointer = std::malloc(size ? size : 1);
+    if(pointer){
+        liveBytes.fetch_add(static_cast<std::int64_t>(usableSize(pointer)), std::memory_order_relaxed);
+    }
+    return pointer;
+}
+
+static void release(void* pointer) noexcept{
+    if(pointer){
+        liveBytes.fetch_sub(static_cast<std::int64_t>(usableSize(pointer)), std::memory_order_relaxed);
+        std::free(pointer);
+    }
+}
+
+void* operator new(std::size_t size){
+    if(void* pointer = allocate(size)){
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size){
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { release(pointer); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Allocation counters of a measured section
+struct AllocationScope{
+    std::uint64_t count{allocationCount.load(std::memory_order_relaxed)};
+    std::uint64_t bytes{allocatedBytes.load(std::memory_order_relaxed)};
+
+    std::uint64_t countSince() const { return allocationCount.load(std::memory_order_relaxed) - count; }
+    std::uint64_t bytesSince() const { return allocatedBytes.load(std::memory_order_relaxed) - bytes; }
+};
+
+struct Query{
+    std::string title;
+    std::string codename;
+    std::string version;
+    bool byTitle;
+};
+
+double millisecondsSince(Clock::time_point start){
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double median(std::vector<double> samples){
+    if(samples.empty()){
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+double percentile(std::vector<double>& sortedSamples, double fraction){
+    if(sortedSamples.empty()){
+        return 0;
+    }
+    std::size_t index = static_cast<std::size_t>(fraction * (sortedSamples.size() - 1) + 0.5);
+    return sortedSamples[index];
+}
+
+// Times the given step 'iterations' times and reports the median duration and the allocations of the last run, the
+// optional preparation runs before every step outside of the measurement
+Json::Value measureStep(unsigned iterations, const std::function<void()>& step, const std::function<void()>& prepare = nullptr){
+    std::vector<double> samples;
+    std::uint64_t allocations = 0, bytes = 0;
+
+    for(unsigned i = 0; i < iterations; i++){
+        if(prepare){
+            prepare();
+        }
+        AllocationScope scope;
+        auto start = Clock::now();
+        step();
+        samples.push_back(millisecondsSince(start));
+        allocations = scope.countSince();
+        bytes = scope.bytesSince();
+    }
+
+    Json::Value result(Json::objectValue);
+    result["median_ms"] = median(samples);
+    result["min_ms"] = *std::min_element(samples.begin(), samples.end());
+    result["allocations"] = static_cast<Json::UInt64>(allocations);
+    result["allocated_bytes"] = static_cast<Json::UInt64>(bytes);
+    return result;
+}
+
+// Adds the throughput of the median run of a step that processed the given number of bytes
+Json::Value withThroughput(Json::Value step, std::size_t bytes){
+    double seconds = step["median_ms"].asDouble() / 1000.0;
+    step["gb_per_s"] = seconds > 0 ? static_cast<double>(bytes) / seconds / 1e9 : 0.0;
+    return step;
+}
+
+// Times every call of the query individually and reports the latency distribution and the allocations per call
+Json::Value measureQuery(std::size_t calls, const std::function<void(std::size_t)>& query){
+    std::vector<double> samples;
+    samples.reserve(calls);
+
+    // The sample vector has its capacity reserved, nothing but the queries allocates in the loop
+    AllocationScope scope;
+    for(std::size_t i = 0; i < calls; i++){
+        auto start = Clock::now();
+        query(i);
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+
+    double total = 0;
+    for(double sample : samples){
+        total += sample;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Json::Value result(Json::objectValue);
+    result["calls"] = static_cast<Json::UInt64>(calls);
+    result["mean_ns"] = calls ? total / calls : 0;
+    result["p50_ns"] = percentile(samples, 0.50);
+    result["p99_ns"] = percentile(samples, 0.99);
+    result["max_ns"] = samples.empty() ? 0 : samples.back();
+    result["allocations_per_query"] = calls ? static_cast<double>(scope.countSince()) / calls : 0;
+    result["bytes_per_query"] = calls ? static_cast<double>(scope.bytesSince()) / calls : 0;
+    return result;
+}
+
+/**
+ * Lookups over the parsed Json::Value document, the way the application answered every query before the catalog
+ * existed: a linear scan of the products with string copies of the compared fields.
+ */
+void legacyListAll(const Json::Value& root, std::string& output){
+    for(const Json::Value& product : root["products"]){
+        if(product["arch"].asString() != "amd64"){
+            continue;
+        }
+        output += product["release_title"].asString() + " " + product["release_codename"].asString() + " amd64\n";
+    }
+}
+
+void legacyListCurrent(const Json::Value& root, std::string& output){
+    const Json::Value& products = root["products"];
+    if(products.empty()){
+        return;
+    }
+
+    Json::Value::const_iterator product = products.end();
+    do{
+        product--;
+        if((*product)["arch"].asString() != "amd64"){
+            continue;
+        }
+        std::string t_releaseTitle = (*product)["release_title"].asString();
+        if(t_releaseTitle.find("LTS") != std::string::npos){
+            output += t_releaseTitle + " " + (*product)["release_codename"].asString() + " amd64\n";
+            break;
+        }
+    }while(product != products.begin());
+}
+
+void legacySha(const Json::Value& root, const Query& query, std::string& output){
+    for(const Json::Value& product : root["products"]){
+        if(product["arch"].asString() != "amd64"){
+            continue;
+        }
+
+        bool matches = query.byTitle ? product["release_title"].asString() == query.title
+                                     : product["release_codename"].asString() == query.codename;
+        if(!matches){
+            continue;
+        }
+
+        std::vector<std::string> versions = product["versions"].getMemberNames();
+        if(std::find(versions.begin(), versions.end(), query.version) != versions.end()){
+            output += product["versions"][query.version]["items"]["disk1.img"]["sha256"].asString();
+        }
+        return;
+    }
+}
+
+// Lookups over the indexed catalog, the way the application answers them now
+void catalogListAll(const Catalog& catalog, std::string& output){
+    for(const ProductView& product : catalog.products()){
+        output.append(product.releaseTitle).append(" ").append(product.releaseCodename).append(" amd64\n");
+    }
+}
+
+void catalogListCurrent(const Catalog& catalog, std::string& output){
+    if(const ProductView* product = catalog.latestLTS()){
+        output.append(product->releaseTitle).append(" ").append(product->releaseCodename).append(" amd64\n");
+    }
+}
+
+void catalogSha(const Catalog& catalog, const Query& query, std::string& output){
+    const ProductView* product = query.byTitle ? catalog.findByTitle(query.title) : catalog.findByCodename(query.codename);
+    if(!product){
+        return;
+    }
+    if(const VersionView* version = Catalog::findVersion(*product, query.version)){
+        output += version->sha256;
+    }
+}
+
+// Lookups over the columnar catalog of the resident server
+void columnarListAll(const ColumnarCatalog& catalog, std::string& output){
+    for(std::uint32_t product = 0; product < catalog.productCount(); product++){
+        output.append(catalog.releaseTitle(product)).append(" ").append(catalog.releaseCodename(product)).append(" amd64\n");
+    }
+}
+
+void columnarListCurrent(const ColumnarCatalog& catalog, std::string& output){
+    std::uint32_t product = catalog.latestLTS();
+    if(product != ColumnarCatalog::npos){
+        output.append(catalog.releaseTitle(product)).append(" ").append(catalog.releaseCodename(product)).append(" amd64\n");
+    }
+}
+
+void columnarSha(const ColumnarCatalog& catalog, const Query& query, std::string& output){
+    std::uint32_t product = query.byTitle ? catalog.findByTitle(query.title) : catalog.findByCodename(query.codename);
+    if(product == ColumnarCatalog::npos){
+        return;
+    }
+    std::uint32_t version = catalog.findVersion(product, query.version);
+    if(version != ColumnarCatalog::npos){
+        output += catalog.versionSha256(version);
+    }
+}
+
+/**
+ * Full scans over every item of every architecture: the total size of the items and the number of items with the
+ * given sha256, the kind of question that can not be answered by an index.
+ */
+struct ScanResult{
+    std::uint64_t totalSize{0};
+    std::uint64_t matches{0};
+
+    bool operator==(const ScanResult& other) const { return totalSize == other.totalSize && matches == other.matches; }
+};
+
+ScanResult jsoncppScan(const Json::Value& root, const std::string& sha256){
+    ScanResult result;
+    for(const Json::Value& product : root["products"]){
+        for(const Json::Value& version : product["versions"]){
+            for(const Json::Value& item : version["items"]){
+                result.totalSize += item["size"].asUInt64();
+                result.matches += item["sha256"].asString() == sha256;
+            }
+        }
+    }
+    return result;
+}
+
+ScanResult catalogScan(const Catalog& catalog, const std::string& sha256){
+    ScanResult result;
+    for(const ProductView& product : catalog.products()){
+        for(const VersionView& version : product.versions){
+            for(const ItemView& item : version.items){
+                result.totalSize += item.size;
+                result.matches += item.sha256 == sha256;
+            }
+        }
+    }
+    return result;
+}
+
+ScanResult columnarScan(const ColumnarCatalog& catalog, const std::uint8_t* digest){
+    ScanResult result;
+    for(std::uint32_t item = 0; item < catalog.itemCount(); item++){
+        result.totalSize += catalog.itemSize(item);
+        const std::uint8_t* itemDigest = catalog.itemDigest(item);
+        result.matches += itemDigest && std::equal(digest, digest + 32, itemDigest);
+    }
+    return result;
+}
+
+// Field by field comparison of two views, the parsers must build the same view from the same document
+bool sameView(const FeedView& lhs, const FeedView& rhs){
+    if(lhs.updated != rhs.updated || lhs.products.size() != rhs.products.size()){
+        return false;
+    }
+
+    for(std::size_t i = 0; i < lhs.products.size(); i++){
+        const ProductView& a = lhs.products[i];
+        const ProductView& b = rhs.products[i];
+        if(a.id != b.id || a.arch != b.arch || a.releaseTitle != b.releaseTitle || a.releaseCodename != b.releaseCodename
+           || a.release != b.release || a.releaseVersion != b.releaseVersion || a.versions.size() != b.versions.size()){
+            return false;
+        }
+
+        for(std::size_t j = 0; j < a.versions.size(); j++){
+            const VersionView& x = a.versions[j];
+            const VersionView& y = b.versions[j];
+            if(x.version != y.version || x.sha256 != y.sha256 || x.path != y.path || x.size != y.size || x.items.size() != y.items.size()){
+                return false;
+            }
+
+            for(std::size_t k = 0; k < x.items.size(); k++){
+                const ItemView& m = x.items[k];
+                const ItemView& n = y.items[k];
+                if(m.name != n.name || m.ftype != n.ftype || m.sha256 != n.sha256 || m.path != n.path || m.size != n.size){
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Draws the sha queries from the generated releases, one in ten asks for a version that does not exist
+std::vector<Query> makeQueries(const SyntheticFeed& feed, std::size_t count){
+    std::vector<Query> queries;
+    std::uint64_t seed = 7;
+    auto next = [&seed](std::uint64_t bound){
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+
+    for(std::size_t i = 0; i < count; i++){
+        const SyntheticRelease& release = feed.releases[next(feed.releases.size())];
+        std::string version = (i % 10 == 9) ? "19700101" : release.versions[next(release.versions.size())];
+        queries.push_back({release.title, release.codename, version, i % 2 == 0});
+    }
+
+    return queries;
+}
+
+// Every parser and classifier must build the same view of every architecture and item as jsoncpp
+bool parsersAgreeOn(const std::string& document, const Json::Value& reference){
+    const char* begin = document.data();
+
+    FeedView expected;
+    ProductViewBuilder::fromJson(reference, expected, "amd64", ViewFields::Items);
+
+    FeedView streamed;
+    ProductViewBuilder streamBuilder(streamed, "amd64", ViewFields::Items);
+    JsonStreamParser streamParser(streamBuilder);
+    bool agree = streamParser.feed(begin, document.size()) && streamParser.finish();
+    streamBuilder.finish();
+    agree = agree && sameView(expected, streamed);
+
+    for(const char* name : {"avx2", "sse4.2", "scalar"}){
+        if(!JsonStructuralParser::useImplementation(name)){
+            continue;
+        }
+        FeedView indexed;
+        ProductViewBuilder indexBuilder(indexed, "amd64", ViewFields::Items);
+        JsonStructuralParser indexParser(indexBuilder);
+        bool parsed = indexParser.parse(begin, document.size());
+        indexBuilder.finish();
+        agree = agree && parsed && sameView(expected, indexed);
+    }
+    JsonStructuralParser::useImplementation("auto");
+
+    return agree;
+}
+
+// Parser cross-check alone, run by ctest on small documents without measuring anything
+bool checkParsers(unsigned scale){
+    SyntheticFeed feed = generateSyntheticFeed(scale);
+
+    Json::Value reference;
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    std::string error;
+    if(!reader->parse(feed.document.data(), feed.document.data() + feed.document.size(), &reference, &error)){
+        std::cerr << "The synthetic feed at scale " << scale << " is not valid json: " << error << std::endl;
+        return false;
+    }
+
+    bool agree = parsersAgreeOn(feed.document, reference);
+    std::cerr << "Scale " << scale << ": " << feed.productCount << " products, " << feed.versionCount << " versions, parsers "
+              << (agree ? "agree" : "disagree") << std::endl;
+
+    return agree;
+}
+
+// Documents every parser must reject: invalid utf-8, lone surrogate escapes, truncated input and bad literals
+struct MalformedDocument{
+    const char* name;
+    std::string document;
+};
+
+const MalformedDocument malformedDocuments[] = {
+    {"invalid utf-8 continuation", "{\"a\": \"\xC3\x28\"}"},
+    {"stray continuation byte", "{\"a\": \"\x80\"}"},
+    {"overlong encoding", "{\"a\": \"\xC0\xAF\"}"},
+    {"encoded surrogate", "{\"a\": \"\xED\xA0\x80\"}"},
+    {"code point above U+10FFFF", "{\"a\": \"\xF4\x90\x80\x80\"}"},
+    {"invalid byte", "{\"a\": \"\xFF\"}"},
+    {"invalid utf-8 in a key", "{\"\xE2\x28\xA1\": 1}"},
+    {"lone high surrogate", "{\"a\": \"\\ud800\"}"},
+    {"lone low surrogate", "{\"a\": \"\\udc00\"}"},
+    {"high surrogate before text", "{\"a\": \"\\ud800x\"}"},
+    {"high surrogate before an escape", "{\"a\": \"\\ud800\\n\"}"},
+    {"two high surrogates", "{\"a\": \"\\ud800\\ud800\"}"},
+    {"empty document", ""},
+    {"truncated object", "{\"a\": 1"},
+    {"truncated key", "{\"a"},
+    {"truncated value", "{\"a\": "},
+    {"truncated string", "{\"a\": \"b"},
+    {"truncated escape", "{\"a\": \"\\u12"},
+    {"truncated utf-8 sequence", "{\"a\": \"\xE2\x82"},
+    {"truncated array", "[1, 2"},
+    {"truncated literal", "[tru"},
+    {"bad literal", "[nul]"},
+    {"capitalized literal", "[True]"},
+    {"literal with a suffix", "[truex]"},
+    {"leading zero", "[01]"},
+    {"fraction without digits", "[1.]"},
+    {"exponent without digits", "[1e]"},
+    {"sign alone", "[-]"},
+    {"nan", "[nan]"}
+};
+
+// Every parser and classifier must reject every malformed document, the stream parser also byte by byte so that the
+// sequences, escapes and literals are split between the chunks. A valid document with non-ascii text and a surrogate
+// pair must be accepted by all of them
+bool checkMalformed(){
+    auto streamParses = [](const std::string& document, std::size_t chunk){
+        FeedView view;
+        ProductViewBuilder builder(view, "amd64", ViewFields::Items);
+        JsonStreamParser parser(builder);
+        for(std::size_t offset = 0; offset < document.size(); offset += chunk){
+            if(!parser.feed(document.data() + offset, std::min(chunk, document.size() - offset))){
+                return false;
+            }
+        }
+        return parser.finish();
+    };
+
+    auto indexParses = [](const std::string& document, const char* implementation){
+        JsonStructuralParser::useImplementation(implementation);
+        FeedView view;
+        ProductViewBuilder builder(view, "amd64", ViewFields::Items);
+        JsonStructuralParser parser(builder);
+        return parser.parse(document.data(), document.size());
+    };
+
+    std::vector<const char*> implementations;
+    for(const char* name : {"avx2", "sse4.2", "scalar"}){
+        if(JsonStructuralParser::useImplementation(name)){
+            implementations.push_back(name);
+        }
+    }
+
+    bool rejected = true;
+    auto expectParses = [&](const char* name, const std::string& document, bool valid){
+        bool agree = streamParses(document, document.size() + 1) == valid && streamParses(document, 1) == valid;
+        for(const char* implementation : implementations){
+            agree = agree && indexParses(document, implementation) == valid;
+        }
+        if(!agree){
+            std::cerr << "A parser " << (valid ? "rejects" : "accepts") << " the " << name << std::endl;
+            rejected = false;
+        }
+    };
+
+    expectParses("valid non-ascii document", "{\"a\": \"caf\xC3\xA9 \xF0\x9F\x98\x80 \\u00e9 \\ud83d\\ude00\", \"b\": [true, false, null, -1.5e3]}", true);
+    for(const MalformedDocument& malformed : malformedDocuments){
+        expectParses(malformed.name, malformed.document, false);
+    }
+    JsonStructuralParser::useImplementation("auto");
+
+    std::cerr << std::size(malformedDocuments) << " malformed documents, parsers " << (rejected ? "reject them" : "disagree") << std::endl;
+
+    return rejected;
+}
+
+Json::Value runScale(unsigned scale, unsigned iterations, std::size_t queryCount, const std::string& snapshotPath){
+    std::cerr << "Generating the synthetic feed at scale " << scale << "..." << std::endl;
+    SyntheticFeed feed = generateSyntheticFeed(scale);
+    std::vector<Query> queries = makeQueries(feed, queryCount);
+    const char* begin = feed.document.data();
+    const char* end = begin + feed.document.size();
+
+    Json::Value result(Json::objectValue);
+    result["scale"] = scale;
+    result["document_bytes"] = static_cast<Json::UInt64>(feed.document.size());
+    result["products"] = static_cast<Json::UInt64>(feed.productCount);
+    result["versions"] = static_cast<Json::UInt64>(feed.versionCount);
+
+    // Keeps the query results alive so that the lookups are not optimized away
+    std::string output;
+    std::size_t outputBytes = 0;
+    auto sink = [&output, &outputBytes](){
+        outputBytes += output.size();
+        output.clear();
+    };
+    output.reserve(64 * 1024);
+
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+
+    // Json::Value document scanned for every query
+    {
+    std::cerr << "  jsoncpp" << std::endl;
+    Json::Value& engine = result["engines"]["jsoncpp"];
+    Json::Value root;
+
+    engine["parse"] = withThroughput(measureStep(iterations, [&](){
+        reader->parse(begin, end, &root, nullptr);
+    }, [&](){
+        root = Json::Value();
+    }), feed.document.size());
+    FeedView view;
+    engine["view_build"] = measureStep(iterations, [&](){
+        ProductViewBuilder::fromJson(root, view);
+    }, [&](){
+        view = FeedView();
+    });
+
+    engine["listall"] = measureQuery(queries.size(), [&](std::size_t){ legacyListAll(root, output); sink(); });
+    engine["listcurr"] = measureQuery(queries.size(), [&](std::size_t){ legacyListCurrent(root, output); sink(); });
+    engine["sha"] = measureQuery(queries.size(), [&](std::size_t i){ legacySha(root, queries[i], output); sink(); });
+    }
+
+    // Streaming parser into the views and the indexed catalog
+    std::unique_ptr<Catalog> catalog;
+    {
+    std::cerr << "  stream" << std::endl;
+    Json::Value& engine = result["engines"]["stream"];
+    FeedView parsed;
+
+    engine["parse"] = withThroughput(measureStep(iterations, [&](){
+        ProductViewBuilder builder(parsed);
+        JsonStreamParser parser(builder);
+        if(parser.feed(begin, feed.document.size()) && parser.finish()){
+            builder.finish();
+        }
+    }, [&](){
+        parsed = FeedView();
+    }), feed.document.size());
+    FeedView view;
+    engine["catalog_build"] = measureStep(iterations, [&](){
+        catalog = std::make_unique<Catalog>(std::move(view));
+    }, [&](){
+        catalog.reset();
+        view = parsed;
+    });
+
+    engine["listall"] = measureQuery(queries.size(), [&](std::size_t){ catalogListAll(*catalog, output); sink(); });
+    engine["listcurr"] = measureQuery(queries.size(), [&](std::size_t){ catalogListCurrent(*catalog, output); sink(); });
+    engine["sha"] = measureQuery(queries.size(), [&](std::size_t i){ catalogSha(*catalog, queries[i], output); sink(); });
+    }
+
+    // Structural index built with simd instructions over the whole document, the first stage is also measured alone
+    // with every classifier supported by the cpu
+    {
+    std::cerr << "  simd" << std::endl;
+    Json::Value& engine = result["engines"]["simd"];
+    engine["implementation"] = JsonStructuralParser::implementation();
+    FeedView parsed;
+
+    engine["parse"] = withThroughput(measureStep(iterations, [&](){
+        ProductViewBuilder builder(parsed);
+        JsonStructuralParser parser(builder);
+        if(parser.parse(begin, feed.document.size())){
+            builder.finish();
+        }
+    }, [&](){
+        parsed = FeedView();
+    }), feed.document.size());
+
+    JsonStreamHandler ignored;
+    JsonStructuralParser indexer(ignored);
+    for(const char* name : {"avx2", "sse4.2", "scalar"}){
+        if(JsonStructuralParser::useImplementation(name)){
+            engine["index"][name] = withThroughput(measureStep(iterations, [&](){
+                indexer.index(begin, feed.document.size());
+            }), feed.document.size());
+        }
+    }
+    JsonStructuralParser::useImplementation("auto");
+    }
+
+    // Columnar catalog built from the same view, as the resident server does
+    std::unique_ptr<ColumnarCatalog> columnar;
+    {
+    std::cerr << "  columnar" << std::endl;
+    Json::Value& engine = result["engines"]["columnar"];
+
+    engine["catalog_build"] = measureStep(iterations, [&](){
+        columnar = std::make_unique<ColumnarCatalog>(catalog->feedView());
+    }, [&](){
+        columnar.reset();
+    });
+
+    engine["listall"] = measureQuery(queries.size(), [&](std::size_t){ columnarListAll(*columnar, output); sink(); });
+    engine["listcurr"] = measureQuery(queries.size(), [&](std::size_t){ columnarListCurrent(*columnar, output); sink(); });
+    engine["sha"] = measureQuery(queries.size(), [&](std::size_t i){ columnarSha(*columnar, queries[i], output); sink(); });
+    }
+
+    // Binary snapshot written once and mapped on every start of the application
+    {
+    std::cerr << "  snapshot" << std::endl;
+    Json::Value& engine = result["engines"]["snapshot"];
+    std::string error;
+
+    engine["write"] = measureStep(iterations, [&](){
+        if(!CatalogSnapshot::write(catalog->feedView(), snapshotPath, error)){
+            std::cerr << "Snapshot could not be written: " << error << std::endl;
+        }
+    });
+    engine["load"] = measureStep(iterations, [&](){
+        CatalogSnapshot snapshot;
+        FeedView view;
+        if(snapshot.open(snapshotPath)){
+            snapshot.toView(view);
+        }
+        Catalog loaded(std::move(view));
+    });
+    engine["snapshot_bytes"] = static_cast<Json::UInt64>(std::filesystem::file_size(snapshotPath));
+    }
+
+    // Embedded library, the catalog is refreshed from the document on disk and looked up through the snapshots
+    bool libraryAgrees = true;
+    {
+    std::cerr << "  library" << std::endl;
+    Json::Value& engine = result["engines"]["library"];
+
+    std::string documentPath = snapshotPath + ".json";
+    std::ofstream(documentPath, std::ios::binary) << feed.document;
+
+    UCIIOptions options;
+    options.source = documentPath;
+    options.cacheEnabled = false;
+    UCIIService service(options);
+
+    engine["refresh"] = measureStep(iterations, [&](){
+        if(!service.refresh()){
+            std::cerr << "The library could not load " << documentPath << std::endl;
+        }
+    });
+
+    auto librarySha = [&service](const Query& query, std::string& output){
+        UCIICatalog snapshot = service.catalog();
+        UCIICatalog::Image image = snapshot.image(query.byTitle ? query.title : query.codename, query.version);
+        if(image.status == UCIIStatus::Ok){
+            output += image.sha256;
+        }
+    };
+
+    engine["sha"] = measureQuery(queries.size(), [&](std::size_t i){ librarySha(queries[i], output); sink(); });
+
+    // Lookups of every hardware thread for a second while the catalog is refreshed and swapped under them
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> lookups{0};
+    std::uint64_t swaps = 0;
+    Clock::time_point start = Clock::now();
+
+    std::vector<std::thread> readers;
+    for(unsigned t = 0; t < threads; t++){
+        readers.emplace_back([&, t](){
+            std::string readerOutput;
+            std::uint64_t count = 0;
+            for(std::size_t i = t % queries.size(); !done; i = (i + 1) % queries.size()){
+                librarySha(queries[i], readerOutput);
+                readerOutput.clear();
+                count++;
+            }
+            lookups += count;
+        });
+    }
+    do{
+        swaps += service.refresh() ? 1 : 0;
+    }while(millisecondsSince(start) < 1000);
+    done = true;
+    for(std::thread& reader : readers){
+        reader.join();
+    }
+    double seconds = millisecondsSince(start) / 1000.0;
+
+    engine["threads"] = threads;
+    engine["swaps"] = static_cast<Json::UInt64>(swaps);
+    engine["lookups_per_s"] = static_cast<double>(lookups.load()) / seconds;
+
+    std::string libraryOutput, columnarOutput;
+    for(const Query& query : queries){
+        librarySha(query, libraryOutput);
+        columnarSha(*columnar, query, columnarOutput);
+    }
+    libraryAgrees = swaps > 0 && libraryOutput == columnarOutput;
+
+    std::error_code removeError;
+    std::filesystem::remove(documentPath, removeError);
+    }
+
+    // Resident size and full scan time of every representation of the whole document, all architectures and items
+    bool scansAgree = true;
+    {
+    std::cerr << "  footprint" << std::endl;
+    Json::Value& footprint = result["footprint"];
+
+    std::int64_t before = liveBytes.load();
+    Json::Value root;
+    reader->parse(begin, end, &root, nullptr);
+    footprint["jsoncpp_bytes"] = static_cast<Json::Int64>(liveBytes.load() - before);
+
+    before = liveBytes.load();
+    FeedView view;
+    ProductViewBuilder builder(view, "amd64", ViewFields::Items);
+    JsonStreamParser parser(builder);
+    if(parser.feed(begin, feed.document.size()) && parser.finish()){
+        builder.finish();
+    }
+    Catalog itemCatalog(std::move(view));
+    footprint["catalog_bytes"] = static_cast<Json::Int64>(liveBytes.load() - before);
+
+    before = liveBytes.load();
+    std::unique_ptr<ColumnarCatalog> itemColumnar = std::make_unique<ColumnarCatalog>(itemCatalog.feedView());
+    footprint["columnar_bytes"] = static_cast<Json::Int64>(liveBytes.load() - before);
+    footprint["columnar_reported_bytes"] = static_cast<Json::UInt64>(itemColumnar->memoryBytes());
+    footprint["items"] = static_cast<Json::UInt64>(itemColumnar->itemCount());
+
+    // Look for the sha256 of the last item, the scan has to visit everything anyway
+    std::uint32_t lastItem = itemColumnar->itemCount() - 1;
+    std::string sha256 = itemColumnar->itemSha256(lastItem);
+    const std::uint8_t* digest = itemColumnar->itemDigest(lastItem);
+
+    ScanResult jsoncppResult, catalogResult, columnarResult;
+    Json::Value& scan = result["scan"];
+    scan["jsoncpp"] = measureStep(iterations, [&](){ jsoncppResult = jsoncppScan(root, sha256); });
+    scan["catalog"] = measureStep(iterations, [&](){ catalogResult = catalogScan(itemCatalog, sha256); });
+    scan["columnar"] = measureStep(iterations, [&](){ columnarResult = columnarScan(*itemColumnar, digest); });
+    scan["matches"] = static_cast<Json::UInt64>(columnarResult.matches);
+    scansAgree = jsoncppResult == catalogResult && catalogResult == columnarResult && columnarResult.matches > 0;
+    }
+
+    // All engines must answer the same, a benchmark of a wrong answer is worthless
+    Json::Value reference;
+    reader->parse(begin, end, &reference, nullptr);
+    std::string legacyOutput, catalogOutput, columnarOutput;
+    for(const Query& query : queries){
+        legacySha(reference, query, legacyOutput);
+        catalogSha(*catalog, query, catalogOutput);
+        columnarSha(*columnar, query, columnarOutput);
+    }
+    legacyListAll(reference, legacyOutput);
+    catalogListAll(*catalog, catalogOutput);
+    columnarListAll(*columnar, columnarOutput);
+    legacyListCurrent(reference, legacyOutput);
+    catalogListCurrent(*catalog, catalogOutput);
+    columnarListCurrent(*columnar, columnarOutput);
+
+    bool parsersAgree = parsersAgreeOn(feed.document, reference);
+
+    result["parsers_agree"] = parsersAgree;
+    result["engines_agree"] = legacyOutput == catalogOutput && catalogOutput == columnarOutput && scansAgree && parsersAgree && libraryAgrees;
+    result["output_bytes"] = static_cast<Json::UInt64>(outputBytes);
+
+    return result;
+}
+
+}
+
+int main(int argc, char* argv[]){
+    po::options_description options("ucii_bench options");
+    options.add_options()
+        ("help,h", "Display the options")
+        ("scale", po::value<std::vector<unsigned>>()->multitoken()->default_value({1, 10, 100}, "1 10 100"),
+            "Multiples of the real product and version counts to generate")
+        ("iterations", po::value<unsigned>()->default_value(5), "Repetitions of every parse and build step")
+        ("queries", po::value<unsigned>()->default_value(1000), "Number of calls of every lookup")
+        ("output", po::value<std::string>()->default_value(""), "Write the results to the given file instead of stdout")
+        ("check", "Only check that every parser builds the same view as jsoncpp at the given scales and rejects the malformed documents, without timing");
+
+    po::variables_map args;
+    try{
+        po::store(po::parse_command_line(argc, argv, options), args);
+        po::notify(args);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if(args.count("help")){
+        std::cout << options << std::endl;
+        return 0;
+    }
+
+    if(args.count("check")){
+        bool agree = true;
+        for(unsigned scale : args["scale"].as<std::vector<unsigned>>()){
+            agree = checkParsers(std::max(1u, scale)) && agree;
+        }
+        agree = checkMalformed() && agree;
+        return agree ? 0 : 1;
+    }
+
+    unsigned iterations = std::max(1u, args["iterations"].as<unsigned>());
+    std::size_t queryCount = std::max(1u, args["queries"].as<unsigned>());
+    std::string snapshotPath = (std::filesystem::temp_directory_path() / ("ucii_bench_" + std::to_string(getpid()) + ".snapshot")).string();
+
+    Json::Value results(Json::objectValue);
+    results["benchmark"] = "ucii_bench";
+    results["iterations"] = iterations;
+    results["queries"] = static_cast<Json::UInt64>(queryCount);
+
+    bool agree = true;
+    for(unsigned scale : args["scale"].as<std::vector<unsigned>>()){
+        Json::Value result = runScale(std::max(1u, scale), iterations, queryCount, snapshotPath);
+        agree = agree && result["engines_agree"].asBool();
+        results["scales"].append(result);
+    }
+
+    std::error_code removeError;
+    std::filesystem::remove(snapshotPath, removeError);
+
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = "  ";
+    std::string json = Json::writeString(writerBuilder, results) + "\n";
+
+    const std::string& outputPath = args["output"].as<std::string>();
+    if(outputPath.empty()){
+        std::cout << json;
+    }
+    else{
+        std::ofstream file(outputPath);
+        if(!(file << json)){
+            std::cerr << "Results could not be written to " << outputPath << std::endl;
+            return 1;
+        }
+    }
+
+    if(!agree){
+        std::cerr << "The engines returned different answers" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
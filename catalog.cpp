@@ -0,0 +1,148 @@
+/**
+ * @file catalog.cpp
+ * @brief This source file contains the definitions of the indexed in-memory catalog class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "catalog.h"
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+
+#define LTS_keyword "LTS"
+
+Catalog::Catalog(FeedView view)
+    : view(std::move(view))
+{
+    std::vector<ProductView>& t_products = this->view.products;
+
+    // Group the products by architecture, a view of a single architecture keeps its order
+    std::stable_sort(t_products.begin(), t_products.end(), [](const ProductView& lhs, const ProductView& rhs){
+        return lhs.arch < rhs.arch;
+    });
+
+    for(std::uint32_t i = 0; i < t_products.size(); i++){
+        if(archPartitions.empty() || archPartitions.back().arch != t_products[i].arch){
+            archPartitions.push_back(ArchPartition{t_products[i].arch, i, i});
+        }
+        archPartitions.back().end = i + 1;
+    }
+
+    titleIndex.reserve(t_products.size());
+    codenameIndex.reserve(t_products.size());
+
+    for(std::uint32_t i = 0; i < t_products.size(); i++){
+        // emplace keeps the first product of a duplicated title or codename, as the linear search did
+        titleIndex.emplace(t_products[i].releaseTitle, i);
+        codenameIndex.emplace(t_products[i].releaseCodename, i);
+        totalVersions += t_products[i].versions.size();
+    }
+
+    prefixIndex.build(t_products);
+
+    // Order the releases by their version once, ties keep the product order (amd64 and the first stream first)
+    std::vector<std::uint32_t> releaseOrder(t_products.size());
+    std::vector<std::uint32_t> ranks(t_products.size());
+    for(std::uint32_t i = 0; i < t_products.size(); i++){
+        releaseOrder[i] = i;
+        ranks[i] = releaseRank(t_products[i].releaseVersion, t_products[i].releaseTitle);
+    }
+    std::stable_sort(releaseOrder.begin(), releaseOrder.end(), [&ranks](std::uint32_t lhs, std::uint32_t rhs){
+        return ranks[lhs] < ranks[rhs];
+    });
+
+    // Support dates are compared as 'YYYY-MM-DD' text
+    char today[16];
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    std::strftime(today, sizeof(today), "%Y-%m-%d", &utc);
+
+    std::uint32_t latestRank = 0;
+    std::uint32_t latestLTSRank = 0;
+    for(std::uint32_t position : releaseOrder){
+        const ProductView& product = t_products[position];
+
+        // The first product of the highest version wins
+        if(!latestReleaseProduct || ranks[position] > latestRank){
+            latestReleaseProduct = &product;
+            latestRank = ranks[position];
+        }
+        if(product.releaseTitle.find(LTS_keyword) != std::string::npos && (!latestLTSProduct || ranks[position] > latestLTSRank)){
+            latestLTSProduct = &product;
+            latestLTSRank = ranks[position];
+        }
+
+        if(product.supportEol.empty() ? product.supported : product.supportEol >= today){
+            supportedProducts.push_back(&product);
+        }
+    }
+}
+
+std::uint32_t Catalog::releaseRank(std::string_view releaseVersion, std::string_view releaseTitle){
+    std::string_view text = releaseVersion.empty() ? releaseTitle.substr(0, releaseTitle.find(' ')) : releaseVersion;
+
+    // 'major.minor', e.g. 18.04
+    std::uint32_t major = 0;
+    std::uint32_t minor = 0;
+    std::size_t i = 0;
+    for(; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++){
+        major = major * 10 + static_cast<std::uint32_t>(text[i] - '0');
+    }
+    if(i == 0 || i == text.size() || text[i] != '.'){
+        return 0;
+    }
+    for(i++; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++){
+        minor = minor * 10 + static_cast<std::uint32_t>(text[i] - '0');
+    }
+
+    return major * 100 + minor;
+}
+
+const ProductView* Catalog::find(const std::unordered_map<std::string_view, std::uint32_t>& index, std::string_view key) const{
+    auto it = index.find(key);
+    return it == index.end() ? nullptr : &view.products[it->second];
+}
+
+const ArchPartition* Catalog::partition(std::string_view arch) const{
+    for(const ArchPartition& t_partition : archPartitions){
+        if(t_partition.arch == arch){
+            return &t_partition;
+        }
+    }
+
+    return nullptr;
+}
+
+const ProductView* Catalog::findByTitle(std::string_view releaseTitle) const{
+    return find(titleIndex, releaseTitle);
+}
+
+const ProductView* Catalog::findByCodename(std::string_view releaseCodename) const{
+    return find(codenameIndex, releaseCodename);
+}
+
+const ProductView* Catalog::findRelease(std::string_view release) const{
+    // Title is prioritized as in the cli options
+    const ProductView* product = findByTitle(release);
+    return product ? product : findByCodename(release);
+}
+
+const VersionView* Catalog::findVersion(const ProductView& product, std::string_view version){
+    // Versions are sorted, search them by binary search
+    auto it = std::lower_bound(product.versions.begin(), product.versions.end(), version, [](const VersionView& lhs, std::string_view rhs){
+        return std::string_view(lhs.version) < rhs;
+    });
+
+    if(it == product.versions.end() || it->version != version){
+        return nullptr;
+    }
+
+    return &*it;
+}
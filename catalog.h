@@ -0,0 +1,150 @@
+/**
+ * @file catalog.h
+ * @brief This header file contains the declarations of the indexed in-memory catalog class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "productview.h"
+#include "releaseindex.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct ArchPartition
+ * @brief Range of the products of a single architecture in the catalog
+ */
+struct ArchPartition{
+    std::string_view arch;
+    std::uint32_t begin;
+    std::uint32_t end;
+};
+
+/**
+ * @class Catalog
+ * @brief This class owns the products of a single document and indexes them once, so that the operations query the
+ * catalog instead of scanning the products. Release titles and codenames are resolved by hash indexes and the versions
+ * of a product are searched by binary search, lookups do not allocate. Partial and case insensitive release names are
+ * resolved by the prefix index of the release names. The releases are also ordered by their release version (e.g.
+ * 18.04 < 18.10 < 20.04) once, so the latest LTS, the latest release and the supported releases do not depend on the
+ * member order of the feed.
+ */
+class Catalog
+{
+public:
+    /**
+     * @brief Catalog class constructor, takes the ownership of the view and builds the indexes
+     * @param view products of the document sorted by product id, versions of each product sorted by version
+    */
+    explicit Catalog(FeedView view);
+
+    // Indexes refer to the owned strings, the catalog can not be copied or moved
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /**
+     * @brief returns all products grouped by architecture, in product id order within an architecture.
+    */
+    const std::vector<ProductView>& products() const { return view.products; }
+
+    /**
+     * @brief returns the product ranges of every architecture of the catalog.
+    */
+    const std::vector<ArchPartition>& partitions() const { return archPartitions; }
+
+    /**
+     * @brief returns the product range of the given architecture, null if the catalog has no such product.
+    */
+    const ArchPartition* partition(std::string_view arch) const;
+
+    /**
+     * @brief returns the whole view of the document.
+    */
+    const FeedView& feedView() const { return view; }
+
+    /**
+     * @brief returns the first product (in product id order) with the given release title, null if there is none.
+    */
+    const ProductView* findByTitle(std::string_view releaseTitle) const;
+
+    /**
+     * @brief returns the first product (in product id order) with the given release codename, null if there is none.
+    */
+    const ProductView* findByCodename(std::string_view releaseCodename) const;
+
+    /**
+     * @brief returns the product with the given release title, or with the given release codename if no title matches.
+    */
+    const ProductView* findRelease(std::string_view release) const;
+
+    /**
+     * @brief returns the prefix index of the titles, codenames, release names and release versions of the products.
+    */
+    const ReleaseIndex& releaseIndex() const { return prefixIndex; }
+
+    /**
+     * @brief returns the LTS release with the highest release version, null if there is none.
+    */
+    const ProductView* latestLTS() const { return latestLTSProduct; }
+
+    /**
+     * @brief returns the release with the highest release version, null if the catalog is empty.
+    */
+    const ProductView* latestRelease() const { return latestReleaseProduct; }
+
+    /**
+     * @brief returns the supported releases in ascending release version order. A release is supported until its
+     * 'support_eol' date (utc, at the time the catalog is built), the 'supported' field of the feed is used if the
+     * release has no such date.
+    */
+    const std::vector<const ProductView*>& supportedReleases() const { return supportedProducts; }
+
+    /**
+     * @brief returns the newest version (serial) of the product, null if it has none.
+    */
+    static const VersionView* latestVersion(const ProductView& product) { return product.versions.empty() ? nullptr : &product.versions.back(); }
+
+    /**
+     * @brief returns the release version of the product as a number that orders the releases (e.g. 1804 for 18.04),
+     * taken from the title if the product has no release version, 0 if neither is a version.
+    */
+    static std::uint32_t releaseRank(std::string_view releaseVersion, std::string_view releaseTitle);
+
+    /**
+     * @brief returns the given version of the product, null if the product has no such version.
+    */
+    static const VersionView* findVersion(const ProductView& product, std::string_view version);
+
+    /**
+     * @brief returns the total number of versions of all products.
+    */
+    std::size_t versionCount() const { return totalVersions; }
+
+private:
+    FeedView view;
+
+    // Hash indexes from release title and codename to the position of the product
+    std::unordered_map<std::string_view, std::uint32_t> titleIndex;
+    std::unordered_map<std::string_view, std::uint32_t> codenameIndex;
+    ReleaseIndex prefixIndex;
+
+    // Products of each architecture are contiguous, a query on an architecture only visits its range
+    std::vector<ArchPartition> archPartitions;
+
+    std::size_t totalVersions{0};
+
+    // Views ordered by the release version, ties in product order
+    const ProductView* latestLTSProduct{nullptr};
+    const ProductView* latestReleaseProduct{nullptr};
+    std::vector<const ProductView*> supportedProducts;
+
+    const ProductView* find(const std::unordered_map<std::string_view, std::uint32_t>& index, std::string_view key) const;
+};
+
+#endif // CATALOG_H
@@ -0,0 +1,110 @@
+/**
+ * @file catalogdiff.cpp
+ * @brief This source file contains the definitions of the incremental difference of two catalogs
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "catalogdiff.h"
+
+const char* CatalogDiff::eventName(Event event){
+    switch(event){
+        case Event::ReleaseAdded: return "release_added";
+        case Event::ReleaseRemoved: return "release_removed";
+        case Event::VersionAdded: return "version_added";
+        case Event::VersionRemoved: return "version_removed";
+        case Event::Sha256Changed: return "sha256_changed";
+    }
+    return "";
+}
+
+std::size_t CatalogDiff::ProductKeyHash::operator()(const ProductKey& key) const{
+    std::hash<std::string_view> hash;
+    return hash(key.id) ^ (hash(key.stream) * 31);
+}
+
+void CatalogDiff::index(ProductIndex& entries, const Catalog& catalog){
+    const std::vector<ProductView>& t_products = catalog.products();
+    entries.clear();
+    entries.reserve(t_products.size());
+
+    for(std::uint32_t position = 0; position < t_products.size(); position++){
+        entries.emplace(ProductKey{t_products[position].stream, t_products[position].id}, position);
+    }
+}
+
+void CatalogDiff::reset(std::shared_ptr<const Catalog> catalog){
+    baseline = std::move(catalog);
+    index(products, *baseline);
+}
+
+std::size_t CatalogDiff::update(std::shared_ptr<const Catalog> catalog, const Consumer& consumer){
+    // The index of the new catalog refers to its strings, it becomes the index of the baseline
+    ProductIndex next;
+    index(next, *catalog);
+
+    const std::vector<ProductView>& previousProducts = baseline->products();
+    const std::vector<ProductView>& nextProducts = catalog->products();
+    std::vector<bool> matched(previousProducts.size(), false);
+    std::size_t changes = 0;
+
+    for(const ProductView& product : nextProducts){
+        auto previousEntry = products.find(ProductKey{product.stream, product.id});
+
+        // New release with all of its versions
+        if(previousEntry == products.end()){
+            consumer(Event::ReleaseAdded, product, nullptr, nullptr);
+            for(const VersionView& t_version : product.versions){
+                consumer(Event::VersionAdded, product, &t_version, nullptr);
+            }
+            changes += 1 + product.versions.size();
+            continue;
+        }
+
+        const ProductView& previousProduct = previousProducts[previousEntry->second];
+        matched[previousEntry->second] = true;
+
+        // Nothing to visit if the versions and their sha256 did not change
+        if(previousProduct.fingerprint == product.fingerprint){
+            continue;
+        }
+
+        // Both version lists are sorted, merge them
+        const std::vector<VersionView>& previousVersions = previousProduct.versions;
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while(i < previousVersions.size() || j < product.versions.size()){
+            if(j == product.versions.size() || (i < previousVersions.size() && previousVersions[i].version < product.versions[j].version)){
+                consumer(Event::VersionRemoved, product, nullptr, &previousVersions[i]);
+                i++;
+                changes++;
+            }
+            else if(i == previousVersions.size() || product.versions[j].version < previousVersions[i].version){
+                consumer(Event::VersionAdded, product, &product.versions[j], nullptr);
+                j++;
+                changes++;
+            }
+            else{
+                if(product.versions[j].sha256 != previousVersions[i].sha256){
+                    consumer(Event::Sha256Changed, product, &product.versions[j], &previousVersions[i]);
+                    changes++;
+                }
+                i++;
+                j++;
+            }
+        }
+    }
+
+    // Releases that are not in the new catalog anymore
+    for(std::uint32_t position = 0; position < previousProducts.size(); position++){
+        if(!matched[position]){
+            consumer(Event::ReleaseRemoved, previousProducts[position], nullptr, nullptr);
+            changes++;
+        }
+    }
+
+    baseline = std::move(catalog);
+    products.swap(next);
+
+    return changes;
+}
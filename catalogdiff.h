@@ -0,0 +1,91 @@
+/**
+ * @file catalogdiff.h
+ * @brief This header file contains the declarations of the incremental difference of two catalogs
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef CATALOGDIFF_H
+#define CATALOGDIFF_H
+
+#include "catalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @class CatalogDiff
+ * @brief This class keeps a baseline catalog and reports what changed in the next one: added and removed releases,
+ * added and removed versions and versions whose sha256 changed. Products are keyed by their stream and product id and
+ * versions by their name, the keys are views into the catalog they index, which is retained. Every product carries
+ * the fingerprint of its versions and their sha256 computed when its view is built, so the products that did not change
+ * are skipped by a single comparison without hashing them again, and only the versions of the changed products are
+ * visited, by a merge of their sorted versions.
+ */
+class CatalogDiff
+{
+public:
+    enum class Event{
+        ReleaseAdded,
+        ReleaseRemoved,
+        VersionAdded,
+        VersionRemoved,
+        Sha256Changed
+    };
+
+    /**
+     * @brief receives a change, version is null for the release events, previous is the version of the baseline for
+     * the removed versions and the changed sha256.
+    */
+    using Consumer = std::function<void(Event event, const ProductView& product, const VersionView* version, const VersionView* previous)>;
+
+    /**
+     * @brief returns the name of the event, e.g. 'version_added'.
+    */
+    static const char* eventName(Event event);
+
+    /**
+     * @brief returns true once a baseline is set.
+    */
+    bool hasBaseline() const { return baseline != nullptr; }
+
+    /**
+     * @brief sets the baseline without reporting anything.
+    */
+    void reset(std::shared_ptr<const Catalog> catalog);
+
+    /**
+     * @brief reports the changes from the baseline to the given catalog in catalog order, the removed releases last,
+     * and makes it the baseline. A new release is reported together with all of its versions.
+     * @return number of reported changes.
+    */
+    std::size_t update(std::shared_ptr<const Catalog> catalog, const Consumer& consumer);
+
+private:
+    // Stream and product id, views into the strings of a retained catalog
+    struct ProductKey{
+        std::string_view stream;
+        std::string_view id;
+
+        bool operator==(const ProductKey& other) const { return stream == other.stream && id == other.id; }
+    };
+
+    struct ProductKeyHash{
+        std::size_t operator()(const ProductKey& key) const;
+    };
+
+    using ProductIndex = std::unordered_map<ProductKey, std::uint32_t, ProductKeyHash>;
+
+    std::shared_ptr<const Catalog> baseline;
+    // Positions of the products of the baseline
+    ProductIndex products;
+
+    static void index(ProductIndex& entries, const Catalog& catalog);
+};
+
+#endif // CATALOGDIFF_H
@@ -0,0 +1,758 @@
+/**
+ * @file cataloghistory.cpp
+ * @brief This source file contains the definitions of the append-only history of the catalogs
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "cataloghistory.h"
+#include "catalogsnapshot.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#define history_magic "UCIIHIST"
+
+// A checkpoint is written after this many deltas, or earlier once the deltas since the last checkpoint outgrow it
+#define checkpoint_interval 32
+
+struct CatalogHistory::FileHeader{
+    char magic[8];
+    std::uint32_t formatVersion;
+    std::uint32_t headerSize;
+};
+
+struct CatalogHistory::RecordHeader{
+    std::uint8_t kind;
+    std::uint8_t reserved[3];
+    std::uint32_t length;
+    std::int64_t at;
+    std::uint64_t updatedHash;
+    std::uint32_t changes;
+    std::uint32_t reserved2;
+    // Covers the other fields of the header and the payload
+    std::uint64_t checksum;
+};
+
+namespace
+{
+
+// 64 bit FNV-1a hash of the given bytes
+std::uint64_t fnv1a(const char* data, std::size_t length, std::uint64_t hash = 14695981039346656037ull){
+    for(std::size_t i = 0; i < length; i++){
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Exclusive lock of a lock file, held while a record is scanned and appended so that concurrent runs append one after
+// the other instead of truncating each other's records. Released when the object is destroyed.
+class HistoryLock
+{
+public:
+    explicit HistoryLock(const std::string& path){
+#ifdef _WIN32
+        handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        OVERLAPPED overlapped{};
+        locked = handle != INVALID_HANDLE_VALUE && LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped);
+#else
+        descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if(descriptor >= 0){
+            int result;
+            do{
+                result = ::flock(descriptor, LOCK_EX);
+            } while(result != 0 && errno == EINTR);
+            locked = result == 0;
+        }
+#endif
+    }
+
+    ~HistoryLock(){
+#ifdef _WIN32
+        if(handle != INVALID_HANDLE_VALUE){
+            CloseHandle(handle);
+        }
+#else
+        if(descriptor >= 0){
+            ::close(descriptor);
+        }
+#endif
+    }
+
+    HistoryLock(const HistoryLock&) = delete;
+    HistoryLock& operator=(const HistoryLock&) = delete;
+
+    bool ok() const { return locked; }
+
+private:
+#ifdef _WIN32
+    HANDLE handle{INVALID_HANDLE_VALUE};
+#else
+    int descriptor{-1};
+#endif
+    bool locked{false};
+};
+
+// Operations of a delta, every product is identified by its id
+enum class Operation : std::uint8_t{
+    // Adds a product or changes its fields, the versions are kept
+    SetProduct = 1,
+    RemoveProduct = 2,
+    // Adds a version or changes its item
+    SetVersion = 3,
+    RemoveVersion = 4
+};
+
+class PayloadWriter
+{
+public:
+    explicit PayloadWriter(std::string& out) : out(out) {}
+
+    void number(std::uint64_t value){
+        while(value >= 0x80){
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void text(std::string_view value){
+        number(value.size());
+        out.append(value.data(), value.size());
+    }
+
+    // A digest is stored as 32 raw bytes, an invalid one is dropped as by the snapshot
+    void digest(const std::string& hex){
+        std::uint8_t bytes[32];
+        if(Sha256::fromHex(hex, bytes)){
+            out.push_back(1);
+            out.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+        else{
+            out.push_back(0);
+        }
+    }
+
+    void product(const ProductView& product){
+        text(product.id);
+        text(product.arch);
+        text(product.releaseTitle);
+        text(product.releaseCodename);
+        text(product.release);
+        text(product.releaseVersion);
+        text(product.supportEol);
+        number(product.supported ? 1 : 0);
+    }
+
+    void version(const VersionView& version){
+        text(version.version);
+        digest(version.sha256);
+        text(version.path);
+        number(version.size);
+    }
+
+private:
+    std::string& out;
+};
+
+class PayloadReader
+{
+public:
+    explicit PayloadReader(const std::string& in) : in(in) {}
+
+    // False once a read ran past the end of the payload
+    bool ok() const { return valid; }
+    bool atEnd() const { return position == in.size(); }
+
+    std::uint64_t number(){
+        std::uint64_t value = 0;
+        for(unsigned shift = 0; valid && shift < 64; shift += 7){
+            if(position >= in.size()){
+                valid = false;
+                break;
+            }
+            unsigned char byte = static_cast<unsigned char>(in[position++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if(!(byte & 0x80)){
+                return value;
+            }
+        }
+        valid = false;
+        return 0;
+    }
+
+    std::string text(){
+        std::uint64_t length = number();
+        if(!valid || length > in.size() - position){
+            valid = false;
+            return "";
+        }
+        std::string value = in.substr(position, static_cast<std::size_t>(length));
+        position += static_cast<std::size_t>(length);
+        return value;
+    }
+
+    std::string digest(){
+        if(position >= in.size()){
+            valid = false;
+            return "";
+        }
+        if(in[position++] == 0){
+            return "";
+        }
+        if(in.size() - position < 32){
+            valid = false;
+            return "";
+        }
+        std::string hex = Sha256::toHex(reinterpret_cast<const std::uint8_t*>(in.data() + position));
+        position += 32;
+        return hex;
+    }
+
+    ProductView product(){
+        ProductView product;
+        product.id = text();
+        product.arch = text();
+        product.releaseTitle = text();
+        product.releaseCodename = text();
+        product.release = text();
+        product.releaseVersion = text();
+        product.supportEol = text();
+        product.supported = number() != 0;
+        return product;
+    }
+
+    VersionView version(){
+        VersionView version;
+        version.version = text();
+        version.sha256 = digest();
+        version.path = text();
+        version.size = number();
+        return version;
+    }
+
+private:
+    const std::string& in;
+    std::size_t position{0};
+    bool valid{true};
+};
+
+// Digest as it reads back from the history
+std::string normalizedDigest(const std::string& hex){
+    std::uint8_t bytes[32];
+    return Sha256::fromHex(hex, bytes) ? Sha256::toHex(bytes) : "";
+}
+
+bool sameProduct(const ProductView& lhs, const ProductView& rhs){
+    return lhs.arch == rhs.arch && lhs.releaseTitle == rhs.releaseTitle && lhs.releaseCodename == rhs.releaseCodename &&
+           lhs.release == rhs.release && lhs.releaseVersion == rhs.releaseVersion && lhs.supportEol == rhs.supportEol &&
+           lhs.supported == rhs.supported;
+}
+
+bool sameVersion(const VersionView& recorded, const VersionView& current){
+    return recorded.sha256 == normalizedDigest(current.sha256) && recorded.path == current.path && recorded.size == current.size;
+}
+
+// Days since the unix epoch of the given civil date
+long long daysFromCivil(int year, int month, int day){
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return static_cast<long long>(era) * 146097 + dayOfEra - 719468;
+}
+
+}
+
+CatalogHistory::CatalogHistory(std::string path)
+    : path(std::move(path))
+{
+}
+
+std::uint64_t CatalogHistory::hashUpdated(const std::string& updated){
+    return fnv1a(updated.data(), updated.size());
+}
+
+const char* CatalogHistory::kindName(Kind kind){
+    switch(kind){
+        case Kind::Checkpoint: return "checkpoint";
+        case Kind::Delta: return "delta";
+    }
+    return "";
+}
+
+bool CatalogHistory::fail(const std::string& message){
+    error = message;
+    return false;
+}
+
+bool CatalogHistory::scan(){
+    entries.clear();
+    intactSize = 0;
+    error.clear();
+
+    std::error_code errorCode;
+    if(!std::filesystem::exists(path, errorCode)){
+        return true;
+    }
+
+    std::uint64_t fileSize = std::filesystem::file_size(path, errorCode);
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if(errorCode || !file){
+        return fail("Could not read " + path);
+    }
+
+    // A file shorter than its header was torn while it was created, it is written again by the next append
+    FileHeader fileHeader{};
+    if(fileSize < sizeof(FileHeader) || !file.read(reinterpret_cast<char*>(&fileHeader), sizeof(FileHeader))){
+        return true;
+    }
+    if(std::memcmp(fileHeader.magic, history_magic, sizeof(fileHeader.magic)) != 0){
+        return fail(path + " is not a ucii history");
+    }
+    if(fileHeader.formatVersion != formatVersion || fileHeader.headerSize != sizeof(FileHeader)){
+        return fail("History format version " + std::to_string(fileHeader.formatVersion) + " is not supported");
+    }
+
+    // Only the record headers are read, the payloads are skipped
+    std::uint64_t offset = sizeof(FileHeader);
+    RecordHeader header{};
+    while(offset + sizeof(RecordHeader) <= fileSize){
+        file.seekg(static_cast<std::streamoff>(offset));
+        if(!file.read(reinterpret_cast<char*>(&header), sizeof(RecordHeader))){
+            break;
+        }
+        if((header.kind != static_cast<std::uint8_t>(Kind::Checkpoint) && header.kind != static_cast<std::uint8_t>(Kind::Delta)) ||
+           offset + sizeof(RecordHeader) + header.length > fileSize){
+            break;
+        }
+
+        entries.push_back(Record{static_cast<Kind>(header.kind), static_cast<std::time_t>(header.at), header.changes,
+                                 offset + sizeof(RecordHeader), header.length, header.updatedHash});
+        offset += sizeof(RecordHeader) + header.length;
+    }
+    intactSize = offset;
+
+    // A torn append may have its length but not its bytes, only the last record can be torn
+    std::string payload;
+    if(!entries.empty() && !readPayload(entries.back(), payload)){
+        intactSize = entries.back().offset - sizeof(RecordHeader);
+        entries.pop_back();
+        error.clear();
+    }
+
+    return true;
+}
+
+bool CatalogHistory::readPayload(const Record& entry, std::string& payload){
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+
+    RecordHeader header{};
+    payload.assign(entry.length, '\0');
+    file.seekg(static_cast<std::streamoff>(entry.offset - sizeof(RecordHeader)));
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(RecordHeader)) || !file.read(&payload[0], static_cast<std::streamsize>(payload.size()))){
+        return fail("Could not read the history record of " + formatDate(entry.at));
+    }
+
+    std::uint64_t checksum = header.checksum;
+    header.checksum = 0;
+    if(checksum != fnv1a(payload.data(), payload.size(), fnv1a(reinterpret_cast<const char*>(&header), sizeof(RecordHeader)))){
+        return fail("History record of " + formatDate(entry.at) + " is corrupt");
+    }
+
+    return true;
+}
+
+bool CatalogHistory::rebuild(std::size_t last, FeedView& view){
+    view = FeedView();
+
+    std::size_t first = last;
+    while(first > 0 && entries[first].kind != Kind::Checkpoint){
+        first--;
+    }
+    if(entries[first].kind != Kind::Checkpoint){
+        return fail("History has no checkpoint before " + formatDate(entries[last].at));
+    }
+
+    // Products and versions are kept sorted, as in the view of a feed
+    auto findProduct = [&view](const std::string& id){
+        return std::lower_bound(view.products.begin(), view.products.end(), id, [](const ProductView& product, const std::string& rhs){ return product.id < rhs; });
+    };
+    auto findVersion = [](ProductView& product, const std::string& version){
+        return std::lower_bound(product.versions.begin(), product.versions.end(), version, [](const VersionView& lhs, const std::string& rhs){ return lhs.version < rhs; });
+    };
+
+    std::string payload;
+    for(std::size_t index = first; index <= last; index++){
+        if(!readPayload(entries[index], payload)){
+            return false;
+        }
+
+        PayloadReader reader(payload);
+        view.updated = reader.text();
+        std::uint64_t count = reader.number();
+
+        if(index == first){
+            view.products.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, payload.size())));
+            for(std::uint64_t i = 0; i < count && reader.ok(); i++){
+                ProductView product = reader.product();
+                std::uint64_t versionCount = reader.number();
+                for(std::uint64_t j = 0; j < versionCount && reader.ok(); j++){
+                    product.versions.push_back(reader.version());
+                }
+                view.products.push_back(std::move(product));
+            }
+        }
+
+        for(std::uint64_t i = 0; index != first && i < count && reader.ok(); i++){
+            Operation operation = static_cast<Operation>(reader.number());
+
+            if(operation == Operation::SetProduct){
+                ProductView product = reader.product();
+                auto position = findProduct(product.id);
+                if(position != view.products.end() && position->id == product.id){
+                    product.versions = std::move(position->versions);
+                    *position = std::move(product);
+                }
+                else{
+                    view.products.insert(position, std::move(product));
+                }
+            }
+            else if(operation == Operation::RemoveProduct){
+                std::string id = reader.text();
+                auto position = findProduct(id);
+                if(position != view.products.end() && position->id == id){
+                    view.products.erase(position);
+                }
+            }
+            else if(operation == Operation::SetVersion || operation == Operation::RemoveVersion){
+                std::string id = reader.text();
+                auto product = findProduct(id);
+                if(product == view.products.end() || product->id != id){
+                    return fail("History record of " + formatDate(entries[index].at) + " refers to an unknown product " + id);
+                }
+
+                if(operation == Operation::SetVersion){
+                    VersionView version = reader.version();
+                    auto position = findVersion(*product, version.version);
+                    if(position != product->versions.end() && position->version == version.version){
+                        *position = std::move(version);
+                    }
+                    else{
+                        product->versions.insert(position, std::move(version));
+                    }
+                }
+                else{
+                    std::string version = reader.text();
+                    auto position = findVersion(*product, version);
+                    if(position != product->versions.end() && position->version == version){
+                        product->versions.erase(position);
+                    }
+                }
+            }
+            else{
+                return fail("History record of " + formatDate(entries[index].at) + " is corrupt");
+            }
+        }
+
+        if(!reader.ok() || !reader.atEnd()){
+            return fail("History record of " + formatDate(entries[index].at) + " is corrupt");
+        }
+    }
+
+    // The versions are fingerprinted once they are complete
+    for(ProductView& product : view.products){
+        product.fingerprint = versionsFingerprint(product.versions);
+    }
+
+    return true;
+}
+
+bool CatalogHistory::record(const FeedView& view, std::time_t recordedAt){
+    appendedRecord = false;
+
+    // The tail is scanned again under the lock, another run may have appended since the last scan
+    std::error_code errorCode;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), errorCode);
+    HistoryLock lock(path + ".lock");
+    if(!lock.ok()){
+        return fail("Could not lock " + path);
+    }
+
+    if(!scan()){
+        return false;
+    }
+
+    std::time_t at = CatalogSnapshot::parseFeedTimestamp(view.updated);
+    if(at == 0){
+        at = recordedAt;
+    }
+    std::uint64_t updatedHash = hashUpdated(view.updated);
+
+    // The same feed is recorded once, an older one (e.g. of an outdated mirror) is not recorded at all
+    if(!entries.empty() && ((!view.updated.empty() && updatedHash == entries.back().updatedHash) || at < entries.back().at)){
+        return true;
+    }
+
+    std::vector<const ProductView*> current;
+    current.reserve(view.products.size());
+    for(const ProductView& product : view.products){
+        current.push_back(&product);
+    }
+    std::sort(current.begin(), current.end(), [](const ProductView* lhs, const ProductView* rhs){ return lhs->id < rhs->id; });
+
+    std::string checkpoint;
+    auto writeCheckpoint = [&checkpoint, &current, &view](){
+        PayloadWriter writer(checkpoint);
+        writer.text(view.updated);
+        writer.number(current.size());
+        for(const ProductView* product : current){
+            writer.product(*product);
+            writer.number(product->versions.size());
+            for(const VersionView& version : product->versions){
+                writer.version(version);
+            }
+        }
+    };
+
+    if(entries.empty()){
+        std::uint32_t changes = 0;
+        for(const ProductView* product : current){
+            changes += 1 + static_cast<std::uint32_t>(product->versions.size());
+        }
+        writeCheckpoint();
+        return append(Kind::Checkpoint, at, changes, updatedHash, checkpoint);
+    }
+
+    FeedView previous;
+    if(!rebuild(entries.size() - 1, previous)){
+        return false;
+    }
+
+    // Walk the sorted products and versions of both catalogs together
+    std::string operations;
+    PayloadWriter writer(operations);
+    std::uint32_t changes = 0;
+
+    auto setVersions = [&](const ProductView& product, const VersionView* first, const VersionView* last){
+        for(const VersionView* version = first; version != last; version++){
+            writer.number(static_cast<std::uint8_t>(Operation::SetVersion));
+            writer.text(product.id);
+            writer.version(*version);
+            changes++;
+        }
+    };
+
+    std::size_t before = 0;
+    std::size_t after = 0;
+    while(before < previous.products.size() || after < current.size()){
+        const ProductView* old = before < previous.products.size() ? &previous.products[before] : nullptr;
+        const ProductView* now = after < current.size() ? current[after] : nullptr;
+
+        if(now && (!old || now->id < old->id)){
+            writer.number(static_cast<std::uint8_t>(Operation::SetProduct));
+            writer.product(*now);
+            changes++;
+            setVersions(*now, now->versions.data(), now->versions.data() + now->versions.size());
+            after++;
+            continue;
+        }
+        if(old && (!now || old->id < now->id)){
+            writer.number(static_cast<std::uint8_t>(Operation::RemoveProduct));
+            writer.text(old->id);
+            changes++;
+            before++;
+            continue;
+        }
+
+        if(!sameProduct(*old, *now)){
+            writer.number(static_cast<std::uint8_t>(Operation::SetProduct));
+            writer.product(*now);
+            changes++;
+        }
+
+        std::size_t oldVersion = 0;
+        std::size_t newVersion = 0;
+        while(oldVersion < old->versions.size() || newVersion < now->versions.size()){
+            const VersionView* lhs = oldVersion < old->versions.size() ? &old->versions[oldVersion] : nullptr;
+            const VersionView* rhs = newVersion < now->versions.size() ? &now->versions[newVersion] : nullptr;
+
+            if(rhs && (!lhs || rhs->version < lhs->version)){
+                setVersions(*now, rhs, rhs + 1);
+                newVersion++;
+            }
+            else if(lhs && (!rhs || lhs->version < rhs->version)){
+                writer.number(static_cast<std::uint8_t>(Operation::RemoveVersion));
+                writer.text(now->id);
+                writer.text(lhs->version);
+                changes++;
+                oldVersion++;
+            }
+            else{
+                if(!sameVersion(*lhs, *rhs)){
+                    setVersions(*now, rhs, rhs + 1);
+                }
+                oldVersion++;
+                newVersion++;
+            }
+        }
+
+        before++;
+        after++;
+    }
+
+    if(changes == 0){
+        return true;
+    }
+
+    std::string delta;
+    PayloadWriter deltaWriter(delta);
+    deltaWriter.text(view.updated);
+    deltaWriter.number(changes);
+    delta.append(operations);
+
+    // Replaying the deltas since the last checkpoint must not cost more than reading a checkpoint
+    std::size_t lastCheckpoint = entries.size() - 1;
+    std::uint64_t deltaBytes = delta.size();
+    while(entries[lastCheckpoint].kind != Kind::Checkpoint && lastCheckpoint > 0){
+        deltaBytes += entries[lastCheckpoint].length;
+        lastCheckpoint--;
+    }
+
+    if(entries.size() - lastCheckpoint >= checkpoint_interval || deltaBytes > entries[lastCheckpoint].length){
+        writeCheckpoint();
+        return append(Kind::Checkpoint, at, changes, updatedHash, checkpoint);
+    }
+
+    return append(Kind::Delta, at, changes, updatedHash, delta);
+}
+
+bool CatalogHistory::append(Kind kind, std::time_t at, std::uint32_t changes, std::uint64_t updatedHash, const std::string& payload){
+    if(payload.size() > UINT32_MAX){
+        return fail("History record is too large");
+    }
+
+    RecordHeader header{};
+    header.kind = static_cast<std::uint8_t>(kind);
+    header.length = static_cast<std::uint32_t>(payload.size());
+    header.at = static_cast<std::int64_t>(at);
+    header.updatedHash = updatedHash;
+    header.changes = changes;
+    header.checksum = fnv1a(payload.data(), payload.size(), fnv1a(reinterpret_cast<const char*>(&header), sizeof(RecordHeader)));
+
+    std::string content;
+    if(intactSize == 0){
+        FileHeader fileHeader{};
+        std::memcpy(fileHeader.magic, history_magic, sizeof(fileHeader.magic));
+        fileHeader.formatVersion = formatVersion;
+        fileHeader.headerSize = sizeof(FileHeader);
+        content.append(reinterpret_cast<const char*>(&fileHeader), sizeof(FileHeader));
+    }
+    content.append(reinterpret_cast<const char*>(&header), sizeof(RecordHeader));
+    content.append(payload);
+
+    // Drop a torn record left by an interrupted append, the caller holds the lock
+    std::error_code errorCode;
+    if(std::filesystem::exists(path, errorCode) && std::filesystem::file_size(path, errorCode) != intactSize){
+        std::filesystem::resize_file(path, intactSize, errorCode);
+        if(errorCode){
+            return fail("Could not truncate " + path);
+        }
+    }
+
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::app);
+        if(!file || !file.write(content.data(), static_cast<std::streamsize>(content.size())) || !file.flush()){
+            return fail("Could not write " + path);
+        }
+    }
+
+    std::uint64_t offset = intactSize + content.size() - payload.size();
+    entries.push_back(Record{kind, at, changes, offset, header.length, updatedHash});
+    intactSize += content.size();
+    appendedRecord = true;
+
+    return true;
+}
+
+bool CatalogHistory::load(std::time_t at, FeedView& view){
+    if(!scan()){
+        return false;
+    }
+    if(entries.empty()){
+        return fail("No catalog is recorded in " + path);
+    }
+
+    // Records are appended in the order of their time
+    auto last = std::upper_bound(entries.begin(), entries.end(), at, [](std::time_t lhs, const Record& rhs){ return lhs < rhs.at; });
+    if(last == entries.begin()){
+        return fail("The history starts at " + formatDate(entries.front().at));
+    }
+
+    return rebuild(static_cast<std::size_t>(last - entries.begin()) - 1, view);
+}
+
+bool CatalogHistory::parseDate(const std::string& text, std::time_t& at){
+    int year = 0, month = 0, day = 0, consumed = 0;
+    if(std::sscanf(text.c_str(), "%4d-%2d-%2d%n", &year, &month, &day, &consumed) != 3){
+        // The form of the 'updated' field of the feed
+        at = CatalogSnapshot::parseFeedTimestamp(text);
+        return at != 0;
+    }
+
+    // A date without a time is the end of that day
+    int hour = 23, minute = 59, second = 59;
+    std::string rest = text.substr(static_cast<std::size_t>(consumed));
+    if(!rest.empty()){
+        int timeConsumed = 0;
+        second = 0;
+        if(std::sscanf(rest.c_str(), "%*1[T ]%2d:%2d%n", &hour, &minute, &timeConsumed) != 2){
+            return false;
+        }
+        rest.erase(0, static_cast<std::size_t>(timeConsumed));
+        if(rest.size() >= 3 && rest[0] == ':'){
+            if(std::sscanf(rest.c_str(), ":%2d%n", &second, &timeConsumed) != 1){
+                return false;
+            }
+            rest.erase(0, static_cast<std::size_t>(timeConsumed));
+        }
+        if(rest != "" && rest != "Z"){
+            return false;
+        }
+    }
+
+    if(month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60 || hour < 0 || minute < 0 || second < 0){
+        return false;
+    }
+
+    at = static_cast<std::time_t>(daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second);
+    return true;
+}
+
+std::string CatalogHistory::formatDate(std::time_t at){
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &at);
+#else
+    gmtime_r(&at, &utc);
+#endif
+
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return text;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file cataloghistory.h
+ * @brief This header file contains the declarations of the append-only history of the catalogs
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef CATALOGHISTORY_H
+#define CATALOGHISTORY_H
+
+#include "productview.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * @class CatalogHistory
+ * @brief This class keeps every catalog that was current at some time in an append-only file, so that the sha256 of a
+ * version can still be looked up after the version dropped off the feed. A recorded catalog is stored as a delta against
+ * the previous one (the products and versions added, changed or removed), so a record costs what changed. Every few
+ * records a checkpoint holds the whole catalog instead, the catalog of any time is rebuilt from the last checkpoint
+ * before it and the deltas that follow it, never by replaying the whole history.
+ *
+ * File layout (host byte order): | file header | record header | payload | record header | payload | ...
+ * A payload is a sequence of varint lengths and numbers, strings and raw sha256 digests. A record is written by a single
+ * append, a record torn by a crash is detected by its length and checksum and dropped by the next append. Like the
+ * snapshot, the history keeps the disk1.img items of amd64 only.
+ */
+class CatalogHistory
+{
+public:
+    // Incremented on every incompatible change of the layout
+    static constexpr std::uint32_t formatVersion = 1;
+
+    enum class Kind : std::uint8_t{
+        Checkpoint = 1,
+        Delta = 2
+    };
+
+    struct Record{
+        Kind kind;
+        // Time the catalog became current, the 'updated' time of the feed (the time it was recorded if unknown)
+        std::time_t at;
+        // Products and versions added, changed or removed since the previous record, all of them for the first one
+        std::uint32_t changes;
+        // Offset and length of the payload in the file
+        std::uint64_t offset;
+        std::uint32_t length;
+        // Hash of the 'updated' field of the feed
+        std::uint64_t updatedHash;
+    };
+
+    /**
+     * @brief CatalogHistory class constructor, the file is read by the first operation.
+     * @param path file of the history, created by the first record
+    */
+    explicit CatalogHistory(std::string path);
+
+    /**
+     * @brief appends the given catalog unless it is the last recorded one. The catalog is compared with the last recorded
+     * one only if the 'updated' field of the feed changed, and it is not recorded if it is older than the last one. The
+     * history is scanned and appended under an exclusive lock of the file <path>.lock, concurrent runs wait for it.
+     * @param view products and versions of the catalog, as built for ViewFields::Versions
+     * @param recordedAt time of the record if the feed has no 'updated' field
+     * @return false if the history could not be read or written, errorMessage() describes the problem.
+    */
+    bool record(const FeedView& view, std::time_t recordedAt);
+
+    /**
+     * @brief rebuilds the catalog that was current at the given time.
+     * @return false if nothing was recorded until then or the history is corrupt, errorMessage() describes the problem.
+    */
+    bool load(std::time_t at, FeedView& view);
+
+    /**
+     * @brief reads the record headers of the file, called by the other operations.
+     * @return false if the file exists but is not a history of this format version.
+    */
+    bool scan();
+
+    /**
+     * @brief returns the records in the order they were appended, as read by the last operation.
+    */
+    const std::vector<Record>& records() const { return entries; }
+
+    // True if the last record() call appended a record
+    bool appended() const { return appendedRecord; }
+
+    // Size of the intact records and hash of the 'updated' field of the last one, as read by the last operation. A
+    // caller that remembers them can tell that a catalog is already recorded from the size of the file alone.
+    std::uint64_t size() const { return intactSize; }
+    std::uint64_t lastUpdatedHash() const { return entries.empty() ? 0 : entries.back().updatedHash; }
+
+    const std::string& errorMessage() const { return error; }
+
+    static const char* kindName(Kind kind);
+
+    /**
+     * @brief returns the hash of the 'updated' field of a feed as kept in the record headers.
+    */
+    static std::uint64_t hashUpdated(const std::string& updated);
+
+    /**
+     * @brief parses a date given as YYYY-MM-DD (the end of that day), YYYY-MM-DDTHH:MM[:SS][Z] in utc or in the form
+     * of the 'updated' field of the feed into unix time.
+    */
+    static bool parseDate(const std::string& text, std::time_t& at);
+
+    /**
+     * @brief formats the given unix time as YYYY-MM-DDTHH:MM:SSZ.
+    */
+    static std::string formatDate(std::time_t at);
+
+private:
+    std::string path;
+    std::vector<Record> entries;
+    // End of the last intact record, a torn record after it is overwritten by the next append
+    std::uint64_t intactSize{0};
+    bool appendedRecord{false};
+    std::string error;
+
+    struct FileHeader;
+    struct RecordHeader;
+
+    bool readPayload(const Record& entry, std::string& payload);
+    bool rebuild(std::size_t last, FeedView& view);
+    bool append(Kind kind, std::time_t at, std::uint32_t changes, std::uint64_t updatedHash, const std::string& payload);
+    bool fail(const std::string& message);
+};
+
+#endif // CATALOGHISTORY_H
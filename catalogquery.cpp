@@ -0,0 +1,463 @@
+/**
+ * @file catalogquery.cpp
+ * @brief This source file contains the definitions of the filter and projection query over the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "catalogquery.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iterator>
+
+namespace {
+
+std::string_view trim(std::string_view text){
+    while(!text.empty() && (text.front() == ' ' || text.front() == '\t')){
+        text.remove_prefix(1);
+    }
+    while(!text.empty() && (text.back() == ' ' || text.back() == '\t')){
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Splits the text by the separator, empty parts are dropped
+std::vector<std::string_view> split(std::string_view text, char separator){
+    std::vector<std::string_view> parts;
+
+    while(!text.empty()){
+        std::size_t position = text.find(separator);
+        std::string_view part = trim(text.substr(0, position));
+        if(!part.empty()){
+            parts.push_back(part);
+        }
+        if(position == std::string_view::npos){
+            break;
+        }
+        text.remove_prefix(position + 1);
+    }
+
+    return parts;
+}
+
+// Compares two dotted numeric versions (20.04 < 22.10), the parts that are not numbers are compared as strings
+int compareDotted(std::string_view lhs, std::string_view rhs){
+    while(!lhs.empty() || !rhs.empty()){
+        std::string_view lhsPart = lhs.substr(0, lhs.find('.'));
+        std::string_view rhsPart = rhs.substr(0, rhs.find('.'));
+
+        unsigned long lhsNumber = 0, rhsNumber = 0;
+        auto lhsResult = std::from_chars(lhsPart.data(), lhsPart.data() + lhsPart.size(), lhsNumber);
+        auto rhsResult = std::from_chars(rhsPart.data(), rhsPart.data() + rhsPart.size(), rhsNumber);
+        bool numeric = lhsResult.ec == std::errc() && lhsResult.ptr == lhsPart.data() + lhsPart.size()
+                    && rhsResult.ec == std::errc() && rhsResult.ptr == rhsPart.data() + rhsPart.size();
+
+        if(numeric && lhsNumber != rhsNumber){
+            return lhsNumber < rhsNumber ? -1 : 1;
+        }
+        if(!numeric && lhsPart != rhsPart){
+            return lhsPart < rhsPart ? -1 : 1;
+        }
+
+        lhs.remove_prefix(std::min(lhs.size(), lhsPart.size() + 1));
+        rhs.remove_prefix(std::min(rhs.size(), rhsPart.size() + 1));
+    }
+
+    return 0;
+}
+
+}
+
+const std::vector<std::string>& CatalogQuery::availableColumns(){
+    static const std::vector<std::string> names = {
+        "stream", "arch", "release", "codename", "release_codename", "title", "version", "item", "ftype", "path", "sha256", "size"
+    };
+    return names;
+}
+
+bool CatalogQuery::fail(const std::string& message){
+    error = message;
+    return false;
+}
+
+bool CatalogQuery::fieldOf(std::string_view name, Field& field){
+    static const std::pair<const char*, Field> fields[] = {
+        {"stream", Field::Stream},
+        {"arch", Field::Arch},
+        {"release", Field::Release},
+        {"codename", Field::Codename},
+        {"release_codename", Field::ReleaseCodename},
+        {"title", Field::Title},
+        {"release_title", Field::Title},
+        {"version", Field::Version},
+        {"item", Field::Item},
+        {"ftype", Field::Ftype},
+        {"path", Field::Path},
+        {"sha256", Field::Sha256},
+        {"size", Field::Size}
+    };
+
+    for(const auto& t_field : fields){
+        if(name == t_field.first){
+            field = t_field.second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+CatalogQuery::Level CatalogQuery::levelOf(Field field){
+    switch(field){
+        case Field::Version:
+            return Level::Version;
+        case Field::Item:
+        case Field::Ftype:
+        case Field::Path:
+        case Field::Sha256:
+        case Field::Size:
+            return Level::Item;
+        default:
+            return Level::Product;
+    }
+}
+
+bool CatalogQuery::compile(const std::string& where, const std::string& select){
+    productConditions.clear();
+    versionConditions.clear();
+    itemConditions.clear();
+    archs.clear();
+    columns.clear();
+    columnNames.clear();
+    rowLevel = Level::Product;
+    error.clear();
+
+    for(std::string_view term : split(where, ',')){
+        // The longest operator is matched first: 'a<=b' is not 'a<' and '=b'
+        std::size_t position = term.find_first_of("=!<>");
+        if(position == std::string_view::npos || position == 0){
+            return fail("Invalid condition '" + std::string(term) + "', expected <field><operator><value>");
+        }
+
+        Condition condition;
+        std::string_view name = trim(term.substr(0, position));
+        std::string_view rest = term.substr(position);
+
+        if(!fieldOf(name, condition.field)){
+            return fail("Unknown field '" + std::string(name) + "'");
+        }
+
+        static const std::pair<const char*, Operator> operators[] = {
+            {"!=", Operator::NotEqual}, {"<=", Operator::LessEqual}, {">=", Operator::GreaterEqual},
+            {"=", Operator::Equal}, {"<", Operator::Less}, {">", Operator::Greater}
+        };
+        bool known = false;
+        for(const auto& t_operator : operators){
+            std::string_view symbol(t_operator.first);
+            if(rest.compare(0, symbol.size(), symbol) == 0){
+                condition.op = t_operator.second;
+                rest.remove_prefix(symbol.size());
+                known = true;
+                break;
+            }
+        }
+        std::string_view value = trim(rest);
+        if(!known || value.empty()){
+            return fail("Invalid condition '" + std::string(term) + "'");
+        }
+
+        bool equality = condition.op == Operator::Equal || condition.op == Operator::NotEqual;
+        if(equality){
+            for(std::string_view alternative : split(value, '|')){
+                condition.values.emplace_back(alternative);
+            }
+        }
+        else{
+            condition.values.emplace_back(value);
+        }
+
+        if(condition.field == Field::Size){
+            if(!equality || condition.values.size() == 1){
+                auto result = std::from_chars(value.data(), value.data() + value.size(), condition.number);
+                if(result.ec != std::errc() || result.ptr != value.data() + value.size()){
+                    return fail("Size must be a number of bytes in '" + std::string(term) + "'");
+                }
+            }
+        }
+        else if(!equality && (condition.field == Field::Stream || condition.field == Field::Arch || condition.field == Field::Codename
+                           || condition.field == Field::ReleaseCodename || condition.field == Field::Item
+                           || condition.field == Field::Ftype || condition.field == Field::Path || condition.field == Field::Sha256)){
+            return fail("Field '" + std::string(name) + "' can only be compared by '=' or '!='");
+        }
+
+        // Plain architecture names select the partitions to visit, several of them intersect. A repeated name would
+        // visit its partition twice, the names are kept sorted and unique
+        if(condition.field == Field::Arch && condition.op == Operator::Equal
+        && std::none_of(condition.values.begin(), condition.values.end(), [](const std::string& t_value){ return t_value.find_first_of("*?") != std::string::npos; })){
+            std::vector<std::string> names = condition.values;
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+
+            if(archs.empty()){
+                archs = std::move(names);
+            }
+            else{
+                std::vector<std::string> common;
+                std::set_intersection(archs.begin(), archs.end(), names.begin(), names.end(), std::back_inserter(common));
+                // Nothing can match, keep an impossible architecture instead of visiting all
+                archs = common.empty() ? std::vector<std::string>{""} : common;
+            }
+        }
+
+        Level level = levelOf(condition.field);
+        rowLevel = std::max(rowLevel, level);
+        switch(level){
+            case Level::Product: productConditions.push_back(std::move(condition)); break;
+            case Level::Version: versionConditions.push_back(std::move(condition)); break;
+            case Level::Item: itemConditions.push_back(std::move(condition)); break;
+        }
+    }
+
+    // The split parts refer to the text, keep it alive during the loop
+    const std::string projection = select.empty() ? default_columns : select;
+    for(std::string_view name : split(projection, ',')){
+        Field field;
+        if(!fieldOf(name, field)){
+            return fail("Unknown column '" + std::string(name) + "'");
+        }
+        columns.push_back(field);
+        columnNames.emplace_back(name);
+        rowLevel = std::max(rowLevel, levelOf(field));
+    }
+
+    if(columns.empty()){
+        return fail("No column is selected");
+    }
+
+    return true;
+}
+
+bool CatalogQuery::glob(std::string_view pattern, std::string_view text, bool ignoreCase){
+    auto same = [ignoreCase](char lhs, char rhs){
+        return ignoreCase ? std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs)) : lhs == rhs;
+    };
+
+    // Iterative matching with a single backtracking point for the last '*'
+    std::size_t p = 0, t = 0;
+    std::size_t starPattern = std::string_view::npos, starText = 0;
+
+    while(t < text.size()){
+        if(p < pattern.size() && (pattern[p] == '?' || (pattern[p] != '*' && same(pattern[p], text[t])))){
+            p++;
+            t++;
+        }
+        else if(p < pattern.size() && pattern[p] == '*'){
+            starPattern = p++;
+            starText = t;
+        }
+        else if(starPattern != std::string_view::npos){
+            p = starPattern + 1;
+            t = ++starText;
+        }
+        else{
+            return false;
+        }
+    }
+
+    while(p < pattern.size() && pattern[p] == '*'){
+        p++;
+    }
+
+    return p == pattern.size();
+}
+
+bool CatalogQuery::compareNumbers(Operator op, std::uint64_t lhs, std::uint64_t rhs){
+    switch(op){
+        case Operator::Equal: return lhs == rhs;
+        case Operator::NotEqual: return lhs != rhs;
+        case Operator::Less: return lhs < rhs;
+        case Operator::LessEqual: return lhs <= rhs;
+        case Operator::Greater: return lhs > rhs;
+        case Operator::GreaterEqual: return lhs >= rhs;
+    }
+    return false;
+}
+
+bool CatalogQuery::compare(const Condition& condition, std::string_view value){
+    bool ignoreCase = condition.field == Field::Codename || condition.field == Field::ReleaseCodename;
+
+    switch(condition.op){
+        case Operator::Equal:
+        case Operator::NotEqual:
+            {
+            bool any = std::any_of(condition.values.begin(), condition.values.end(), [&](const std::string& pattern){
+                return glob(pattern, value, ignoreCase);
+            });
+            return condition.op == Operator::Equal ? any : !any;
+            }
+        default:
+            {
+            // Map the sign of the order to 0, 1 or 2 and compare it with the 'equal' value
+            int order = value.compare(condition.values.front());
+            return compareNumbers(condition.op, static_cast<std::uint64_t>((order > 0) - (order < 0) + 1), 1);
+            }
+    }
+}
+
+bool CatalogQuery::compareReleases(const Condition& condition, std::string_view value){
+    if(condition.op == Operator::Equal || condition.op == Operator::NotEqual){
+        return compare(condition, value);
+    }
+
+    // compareDotted returns -1, 0 or 1
+    int order = compareDotted(value, condition.values.front());
+    return compareNumbers(condition.op, static_cast<std::uint64_t>(order + 1), 1);
+}
+
+bool CatalogQuery::matches(const Condition& condition, const ProductView& product) const{
+    switch(condition.field){
+        case Field::Stream:
+            return compare(condition, product.stream);
+        case Field::Arch:
+            return compare(condition, product.arch);
+        case Field::Release:
+            return compareReleases(condition, product.releaseVersion);
+        case Field::Codename:
+            // Either the short or the long name of the release
+            return condition.op == Operator::NotEqual
+                ? compare(condition, product.release) && compare(condition, product.releaseCodename)
+                : compare(condition, product.release) || compare(condition, product.releaseCodename);
+        case Field::ReleaseCodename:
+            return compare(condition, product.releaseCodename);
+        case Field::Title:
+            return compare(condition, product.releaseTitle);
+        default:
+            return true;
+    }
+}
+
+bool CatalogQuery::matches(const Condition& condition, const VersionView& version) const{
+    return compare(condition, version.version);
+}
+
+bool CatalogQuery::matches(const Condition& condition, const ItemView& item) const{
+    switch(condition.field){
+        case Field::Item:
+            return compare(condition, item.name);
+        case Field::Ftype:
+            return compare(condition, item.ftype);
+        case Field::Path:
+            return compare(condition, item.path);
+        case Field::Sha256:
+            return compare(condition, item.sha256);
+        case Field::Size:
+            if(condition.values.size() > 1){
+                // Alternatives of sizes are compared as text
+                return compare(condition, std::to_string(item.size));
+            }
+            return compareNumbers(condition.op, item.size, condition.number);
+        default:
+            return true;
+    }
+}
+
+std::string_view CatalogQuery::columnValue(Field field, const ProductView& product, const VersionView* version, const ItemView* item, std::string& scratch) const{
+    switch(field){
+        case Field::Stream: return product.stream;
+        case Field::Arch: return product.arch;
+        case Field::Release: return product.releaseVersion;
+        case Field::Codename: return product.release;
+        case Field::ReleaseCodename: return product.releaseCodename;
+        case Field::Title: return product.releaseTitle;
+        case Field::Version: return version ? std::string_view(version->version) : std::string_view();
+        case Field::Item: return item ? std::string_view(item->name) : std::string_view();
+        case Field::Ftype: return item ? std::string_view(item->ftype) : std::string_view();
+        case Field::Path: return item ? std::string_view(item->path) : std::string_view();
+        case Field::Sha256: return item ? std::string_view(item->sha256) : std::string_view();
+        case Field::Size:
+            if(!item){
+                return std::string_view();
+            }
+            scratch = std::to_string(item->size);
+            return scratch;
+    }
+    return std::string_view();
+}
+
+std::size_t CatalogQuery::run(const Catalog& catalog, const std::function<void(const std::vector<std::string_view>&)>& emit) const{
+    std::size_t rows = 0;
+    visited = 0;
+
+    // Values of the selected columns of the current row, sizes are formatted into the scratch strings
+    std::vector<std::string_view> values(columns.size());
+    std::vector<std::string> scratch(columns.size());
+
+    auto emitRow = [&](const ProductView& product, const VersionView* version, const ItemView* item){
+        for(std::size_t i = 0; i < columns.size(); i++){
+            values[i] = columnValue(columns[i], product, version, item, scratch[i]);
+        }
+        emit(values);
+        rows++;
+    };
+
+    auto visitProduct = [&](const ProductView& product){
+        visited++;
+
+        for(const Condition& condition : productConditions){
+            if(!matches(condition, product)){
+                return;
+            }
+        }
+
+        if(rowLevel == Level::Product){
+            emitRow(product, nullptr, nullptr);
+            return;
+        }
+
+        for(const VersionView& version : product.versions){
+            bool versionMatches = std::all_of(versionConditions.begin(), versionConditions.end(), [&](const Condition& condition){
+                return matches(condition, version);
+            });
+            if(!versionMatches){
+                continue;
+            }
+
+            if(rowLevel == Level::Version){
+                emitRow(product, &version, nullptr);
+                continue;
+            }
+
+            for(const ItemView& item : version.items){
+                bool itemMatches = std::all_of(itemConditions.begin(), itemConditions.end(), [&](const Condition& condition){
+                    return matches(condition, item);
+                });
+                if(itemMatches){
+                    emitRow(product, &version, &item);
+                }
+            }
+        }
+    };
+
+    const std::vector<ProductView>& products = catalog.products();
+
+    if(archs.empty()){
+        for(const ProductView& product : products){
+            visitProduct(product);
+        }
+        return rows;
+    }
+
+    // Visit the partitions of the requested architectures only
+    for(const std::string& arch : archs){
+        if(const ArchPartition* t_partition = catalog.partition(arch)){
+            for(std::uint32_t i = t_partition->begin; i < t_partition->end; i++){
+                visitProduct(products[i]);
+            }
+        }
+    }
+
+    return rows;
+}
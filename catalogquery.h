@@ -0,0 +1,153 @@
+/**
+ * @file catalogquery.h
+ * @brief This header file contains the declarations of the filter and projection query over the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef CATALOGQUERY_H
+#define CATALOGQUERY_H
+
+#include "catalog.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Columns selected when the query has no projection
+#define default_columns "title,arch,version,item,sha256"
+
+/**
+ * @class CatalogQuery
+ * @brief This class compiles a filter ('arch=arm64,release>=20.04,item=*.img') and a projection ('version,sha256,size')
+ * once and evaluates them over a catalog. The conditions of the filter are all required and grouped by the level they
+ * test (product, version, item), so that a product is rejected before its versions are visited. Conditions on the
+ * architecture only visit the matching partitions of the catalog.
+ *
+ * Fields of the filter:
+ *  stream    name of the stream the product is aggregated from, e.g. daily, empty for a single json file
+ *  arch      architecture of the product, e.g. amd64
+ *  release   version of the release, e.g. 20.04, compared numerically
+ *  codename  release name (focal) or release codename (Focal Fossa) of the product, case insensitive
+ *  title     release title, e.g. '20.04 LTS'
+ *  version   version (serial) of the image, e.g. 20241004, compared as a string
+ *  item      name of the item, e.g. disk1.img
+ *  ftype     file type of the item, e.g. squashfs
+ *  path      path of the item relative to the root of the mirror
+ *  sha256    sha256 of the item
+ *  size      size of the item in bytes, compared numerically
+ * The operators are =, !=, <, <=, > and >=. '=' and '!=' accept '*' and '?' wildcards and alternatives separated by '|'.
+ * The same names select the columns, 'codename' selects the release name and 'release_codename' the release codename.
+ *
+ * The row of the result is the deepest level referenced by the filter or the projection: one row per item if any item
+ * field is used, per version if a version field is used, per product otherwise.
+ */
+class CatalogQuery
+{
+public:
+    /**
+     * @brief returns the names of the columns that can be selected.
+    */
+    static const std::vector<std::string>& availableColumns();
+
+    /**
+     * @brief compiles the given filter and projection.
+     * @param where comma separated conditions, empty to match everything
+     * @param select comma separated columns, empty for the default columns
+     * @return false if the query is invalid, errorMessage() describes the problem.
+    */
+    bool compile(const std::string& where, const std::string& select);
+
+    /**
+     * @brief evaluates the query over the catalog and passes the values of the selected columns of every matching row.
+     * The values are only valid during the call.
+     * @return number of matching rows.
+    */
+    std::size_t run(const Catalog& catalog, const std::function<void(const std::vector<std::string_view>&)>& emit) const;
+
+    /**
+     * @brief returns the names of the selected columns.
+    */
+    const std::vector<std::string>& selectedColumns() const { return columnNames; }
+
+    /**
+     * @brief returns the number of products visited by the last run, the products outside of the matching
+     * architectures are never visited.
+    */
+    std::size_t productsVisited() const { return visited; }
+
+    const std::string& errorMessage() const { return error; }
+
+private:
+    enum class Field{
+        Arch,
+        Release,
+        Codename,
+        Title,
+        Version,
+        Item,
+        Ftype,
+        Path,
+        Sha256,
+        Size,
+        ReleaseCodename,
+        Stream
+    };
+
+    enum class Operator{
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    // Level of the catalog a field belongs to
+    enum class Level{
+        Product,
+        Version,
+        Item
+    };
+
+    struct Condition{
+        Field field;
+        Operator op;
+        // Alternatives of '=' and '!=', a single value for the other operators
+        std::vector<std::string> values;
+        // Numeric value of the size
+        std::uint64_t number{0};
+    };
+
+    std::vector<Condition> productConditions;
+    std::vector<Condition> versionConditions;
+    std::vector<Condition> itemConditions;
+
+    // Architectures to visit, all of them if empty
+    std::vector<std::string> archs;
+
+    std::vector<Field> columns;
+    std::vector<std::string> columnNames;
+    Level rowLevel{Level::Product};
+
+    mutable std::size_t visited{0};
+    std::string error;
+
+    bool fail(const std::string& message);
+    static bool fieldOf(std::string_view name, Field& field);
+    static Level levelOf(Field field);
+
+    bool matches(const Condition& condition, const ProductView& product) const;
+    bool matches(const Condition& condition, const VersionView& version) const;
+    bool matches(const Condition& condition, const ItemView& item) const;
+    static bool compare(const Condition& condition, std::string_view value);
+    static bool compareNumbers(Operator op, std::uint64_t lhs, std::uint64_t rhs);
+    static bool compareReleases(const Condition& condition, std::string_view value);
+    static bool glob(std::string_view pattern, std::string_view text, bool ignoreCase);
+
+    std::string_view columnValue(Field field, const ProductView& product, const VersionView* version, const ItemView* item, std::string& scratch) const;
+};
+
+#endif // CATALOGQUERY_H
@@ -0,0 +1,377 @@
+/**
+ * @file catalogsnapshot.cpp
+ * @brief This source file contains the definitions of the memory mappable binary catalog snapshot class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "catalogsnapshot.h"
+#include "sha256.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#define snapshot_magic "UCIISNAP"
+
+struct CatalogSnapshot::Header{
+    char magic[8];
+    std::uint32_t formatVersion;
+    std::uint32_t headerSize;
+    std::uint64_t fileSize;
+    std::int64_t sourceTimestamp;
+    std::int64_t builtAt;
+    std::uint32_t productCount;
+    std::uint32_t versionCount;
+    std::uint64_t productsOffset;
+    std::uint64_t versionsOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+    std::uint64_t payloadChecksum;
+    std::uint64_t headerChecksum;
+};
+
+struct CatalogSnapshot::StringRef{
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+struct CatalogSnapshot::Product{
+    StringRef id;
+    StringRef arch;
+    StringRef releaseTitle;
+    StringRef releaseCodename;
+    StringRef release;
+    StringRef releaseVersion;
+    StringRef supportEol;
+    std::uint32_t firstVersion;
+    std::uint32_t versionCount;
+    // 1 if the product is supported
+    std::uint32_t flags;
+    std::uint32_t reserved;
+};
+
+struct CatalogSnapshot::Version{
+    StringRef version;
+    StringRef path;
+    std::uint64_t size;
+    std::uint8_t sha256[32];
+    // 1 if sha256 is present
+    std::uint32_t flags;
+    std::uint32_t reserved;
+};
+
+// 64 bit FNV-1a hash of the given bytes
+static std::uint64_t fnv1a(const char* data, std::size_t length, std::uint64_t hash = 14695981039346656037ull){
+    for(std::size_t i = 0; i < length; i++){
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Rounds the given offset up to the next multiple of 8
+static std::uint64_t align8(std::uint64_t offset){
+    return (offset + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+std::uint64_t CatalogSnapshot::headerChecksumOf(Header header){
+    // Checksum field itself is not covered
+    header.headerChecksum = 0;
+    return fnv1a(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool CatalogSnapshot::write(const FeedView& view, const std::string& path, std::string& error){
+    // Intern the strings, every distinct string is stored once
+    std::string strings;
+    std::unordered_map<std::string, StringRef> internedStrings;
+
+    auto intern = [&strings, &internedStrings](const std::string& text){
+        auto it = internedStrings.find(text);
+        if(it != internedStrings.end()){
+            return it->second;
+        }
+
+        StringRef reference{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size())};
+        strings.append(text);
+        strings.push_back('\0');
+        internedStrings.emplace(text, reference);
+
+        return reference;
+    };
+
+    std::vector<Product> productRecords;
+    std::vector<Version> versionRecords;
+
+    // View is already sorted by product id and by version
+    for(const ProductView& product : view.products){
+        Product record{};
+        record.id = intern(product.id);
+        record.arch = intern(product.arch);
+        record.releaseTitle = intern(product.releaseTitle);
+        record.releaseCodename = intern(product.releaseCodename);
+        record.release = intern(product.release);
+        record.releaseVersion = intern(product.releaseVersion);
+        record.supportEol = intern(product.supportEol);
+        record.flags = product.supported ? 1 : 0;
+        record.firstVersion = static_cast<std::uint32_t>(versionRecords.size());
+        record.versionCount = static_cast<std::uint32_t>(product.versions.size());
+
+        for(const VersionView& version : product.versions){
+            Version versionRecord{};
+            versionRecord.version = intern(version.version);
+            versionRecord.path = intern(version.path);
+            versionRecord.size = version.size;
+            versionRecord.flags = Sha256::fromHex(version.sha256, versionRecord.sha256) ? 1 : 0;
+            versionRecords.push_back(versionRecord);
+        }
+
+        productRecords.push_back(record);
+    }
+
+    if(strings.size() > UINT32_MAX){
+        error = "String table of the snapshot is too large";
+        return false;
+    }
+
+    // Place the sections
+    Header header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.formatVersion = formatVersion;
+    header.headerSize = sizeof(Header);
+    header.sourceTimestamp = parseFeedTimestamp(view.updated);
+    header.builtAt = std::time(nullptr);
+    header.productCount = static_cast<std::uint32_t>(productRecords.size());
+    header.versionCount = static_cast<std::uint32_t>(versionRecords.size());
+    header.productsOffset = align8(sizeof(Header));
+    header.versionsOffset = align8(header.productsOffset + productRecords.size() * sizeof(Product));
+    header.stringsOffset = align8(header.versionsOffset + versionRecords.size() * sizeof(Version));
+    header.stringsSize = strings.size();
+    header.fileSize = header.stringsOffset + header.stringsSize;
+
+    std::string content(header.fileSize, '\0');
+    if(!productRecords.empty()){
+        std::memcpy(&content[header.productsOffset], productRecords.data(), productRecords.size() * sizeof(Product));
+    }
+    if(!versionRecords.empty()){
+        std::memcpy(&content[header.versionsOffset], versionRecords.data(), versionRecords.size() * sizeof(Version));
+    }
+    std::memcpy(&content[header.stringsOffset], strings.data(), strings.size());
+
+    header.payloadChecksum = fnv1a(content.data() + sizeof(Header), content.size() - sizeof(Header));
+    header.headerChecksum = headerChecksumOf(header);
+    std::memcpy(&content[0], &header, sizeof(Header));
+
+    // Write next to the final location and move in place, so that readers never map a partial file
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream output(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!output){
+            error = "Could not create " + temporaryPath;
+            return false;
+        }
+
+        output.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if(!output){
+            error = "Could not write " + temporaryPath;
+            return false;
+        }
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename(temporaryPath, path, renameError);
+    if(renameError){
+        std::filesystem::remove(temporaryPath, renameError);
+        error = "Could not move the snapshot to " + path;
+        return false;
+    }
+
+    return true;
+}
+
+bool CatalogSnapshot::fail(const std::string& message){
+    error = message;
+    file.close();
+    return false;
+}
+
+bool CatalogSnapshot::open(const std::string& path){
+    error.clear();
+
+    if(!file.open(path)){
+        return fail(file.errorMessage());
+    }
+
+    // Validate the header
+    if(file.size() < sizeof(Header)){
+        return fail("Snapshot is truncated");
+    }
+
+    const Header* t_header = header();
+
+    if(std::memcmp(t_header->magic, snapshot_magic, sizeof(t_header->magic)) != 0){
+        return fail("File is not a ucii snapshot");
+    }
+    if(t_header->formatVersion != formatVersion || t_header->headerSize != sizeof(Header)){
+        return fail("Snapshot format version " + std::to_string(t_header->formatVersion) + " is not supported");
+    }
+    if(t_header->headerChecksum != headerChecksumOf(*t_header)){
+        return fail("Snapshot header checksum mismatch");
+    }
+    if(t_header->fileSize != file.size()){
+        return fail("Snapshot is truncated");
+    }
+    if(t_header->payloadChecksum != fnv1a(file.data() + sizeof(Header), file.size() - sizeof(Header))){
+        return fail("Snapshot checksum mismatch");
+    }
+
+    // Validate the bounds of the sections, accessors do not check them again
+    const std::uint64_t fileSize = file.size();
+    if(t_header->productsOffset % 8 || t_header->versionsOffset % 8 ||
+       t_header->productsOffset + static_cast<std::uint64_t>(t_header->productCount) * sizeof(Product) > fileSize ||
+       t_header->versionsOffset + static_cast<std::uint64_t>(t_header->versionCount) * sizeof(Version) > fileSize ||
+       t_header->stringsOffset + t_header->stringsSize > fileSize){
+        return fail("Snapshot sections are out of bounds");
+    }
+
+    auto validString = [t_header](const StringRef& reference){
+        return static_cast<std::uint64_t>(reference.offset) + reference.length < t_header->stringsSize;
+    };
+
+    for(std::uint32_t i = 0; i < t_header->productCount; i++){
+        const Product& product = products()[i];
+
+        if(!validString(product.id) || !validString(product.arch) || !validString(product.releaseTitle) ||
+           !validString(product.releaseCodename) || !validString(product.release) || !validString(product.releaseVersion) ||
+           !validString(product.supportEol) ||
+           static_cast<std::uint64_t>(product.firstVersion) + product.versionCount > t_header->versionCount){
+            return fail("Snapshot product records are corrupt");
+        }
+    }
+
+    for(std::uint32_t i = 0; i < t_header->versionCount; i++){
+        if(!validString(versions()[i].version) || !validString(versions()[i].path)){
+            return fail("Snapshot version records are corrupt");
+        }
+    }
+
+    return true;
+}
+
+const CatalogSnapshot::Header* CatalogSnapshot::header() const{
+    return reinterpret_cast<const Header*>(file.data());
+}
+
+const CatalogSnapshot::Product* CatalogSnapshot::products() const{
+    return reinterpret_cast<const Product*>(file.data() + header()->productsOffset);
+}
+
+const CatalogSnapshot::Version* CatalogSnapshot::versions() const{
+    return reinterpret_cast<const Version*>(file.data() + header()->versionsOffset);
+}
+
+std::string_view CatalogSnapshot::string(const StringRef& reference) const{
+    return std::string_view(file.data() + header()->stringsOffset + reference.offset, reference.length);
+}
+
+std::time_t CatalogSnapshot::sourceTimestamp() const{
+    return file.isOpen() ? static_cast<std::time_t>(header()->sourceTimestamp) : 0;
+}
+
+std::time_t CatalogSnapshot::builtAt() const{
+    return file.isOpen() ? static_cast<std::time_t>(header()->builtAt) : 0;
+}
+
+std::uint32_t CatalogSnapshot::productCount() const{
+    return file.isOpen() ? header()->productCount : 0;
+}
+
+std::uint32_t CatalogSnapshot::versionCount() const{
+    return file.isOpen() ? header()->versionCount : 0;
+}
+
+void CatalogSnapshot::toView(FeedView& view, ViewFields fields) const{
+    view = FeedView();
+
+    if(!file.isOpen()){
+        return;
+    }
+
+    view.products.reserve(header()->productCount);
+
+    for(std::uint32_t i = 0; i < header()->productCount; i++){
+        const Product& product = products()[i];
+
+        ProductView productView;
+        productView.id = std::string(string(product.id));
+        productView.arch = std::string(string(product.arch));
+        productView.releaseTitle = std::string(string(product.releaseTitle));
+        productView.releaseCodename = std::string(string(product.releaseCodename));
+        productView.release = std::string(string(product.release));
+        productView.releaseVersion = std::string(string(product.releaseVersion));
+        productView.supportEol = std::string(string(product.supportEol));
+        productView.supported = product.flags & 1;
+
+        if(fields == ViewFields::Versions){
+            productView.versions.reserve(product.versionCount);
+
+            for(std::uint32_t j = 0; j < product.versionCount; j++){
+                const Version& version = versions()[product.firstVersion + j];
+                productView.versions.push_back(VersionView{std::string(string(version.version)), version.flags & 1 ? Sha256::toHex(version.sha256) : "",
+                                                           std::string(string(version.path)), version.size, {}});
+            }
+        }
+
+        productView.fingerprint = versionsFingerprint(productView.versions);
+        view.products.push_back(std::move(productView));
+    }
+}
+
+std::time_t CatalogSnapshot::parseFeedTimestamp(const std::string& updated){
+    static const char* monthNames[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+    // Skip the optional day of the week
+    std::size_t position = updated.find(',');
+    position = (position == std::string::npos) ? 0 : position + 1;
+
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    char monthName[4] = {0};
+    char zoneSign = '+';
+    int zone = 0;
+
+    int parsed = std::sscanf(updated.c_str() + position, " %d %3s %d %d:%d:%d %c%4d", &day, monthName, &year, &hour, &minute, &second, &zoneSign, &zone);
+    if(parsed < 6){
+        return 0;
+    }
+
+    int month = -1;
+    for(int i = 0; i < 12; i++){
+        if(std::strcmp(monthName, monthNames[i]) == 0){
+            month = i + 1;
+        }
+    }
+    if(month < 0){
+        return 0;
+    }
+
+    // Days since the unix epoch of the civil date
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    long long days = static_cast<long long>(era) * 146097 + dayOfEra - 719468;
+
+    long long seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+
+    // Convert the local time of the zone into utc
+    if(parsed == 8){
+        long long offset = (zone / 100) * 3600 + (zone % 100) * 60;
+        seconds += (zoneSign == '-') ? offset : -offset;
+    }
+
+    return static_cast<std::time_t>(seconds);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file catalogsnapshot.h
+ * @brief This header file contains the declarations of the memory mappable binary catalog snapshot class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include "mappedfile.h"
+#include "productview.h"
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+/**
+ * @class CatalogSnapshot
+ * @brief This class writes a product view into a versioned binary file and reads it back through a read-only memory
+ * mapping, so that the operations can be answered without any json parsing.
+ *
+ * File layout (host byte order, every section is 8 byte aligned):
+ * | header | products (sorted by product id) | versions (sorted per product) | interned string table |
+ * Strings are referenced by (offset, length) pairs into the string table and sha256 digests are stored as 32 raw bytes.
+ * The header carries a checksum of itself and a checksum of the rest of the file, the feed 'updated' time and the
+ * build time of the snapshot.
+ */
+class CatalogSnapshot
+{
+public:
+    // Incremented on every incompatible change of the layout
+    static constexpr std::uint32_t formatVersion = 3;
+
+    /**
+     * @brief writes the given view into the given path. The file is written next to its final location and renamed.
+     * @param view products and versions to be written
+     * @param path destination of the snapshot
+     * @param error description of the problem if writing fails
+    */
+    static bool write(const FeedView& view, const std::string& path, std::string& error);
+
+    /**
+     * @brief maps the snapshot at the given path and validates its header, checksums and bounds.
+     * @return false if the file is missing, corrupt or of another format version, errorMessage() describes the problem.
+    */
+    bool open(const std::string& path);
+
+    /**
+     * @brief fills the given view from the snapshot.
+     * @param fields fields to be copied, versions are skipped for ViewFields::Titles
+    */
+    void toView(FeedView& view, ViewFields fields = ViewFields::Versions) const;
+
+    /**
+     * @brief converts the 'updated' field of the feed (e.g. 'Thu, 17 Oct 2024 10:00:00 +0000') into unix time.
+     * @return 0 if the text can not be parsed.
+    */
+    static std::time_t parseFeedTimestamp(const std::string& updated);
+
+    std::time_t sourceTimestamp() const;
+    std::time_t builtAt() const;
+    std::uint32_t productCount() const;
+    std::uint32_t versionCount() const;
+    const std::string& errorMessage() const { return error; }
+
+private:
+    MappedFile file;
+    std::string error;
+
+    struct Header;
+    struct StringRef;
+    struct Product;
+    struct Version;
+
+    const Header* header() const;
+    const Product* products() const;
+    const Version* versions() const;
+    std::string_view string(const StringRef& reference) const;
+    bool fail(const std::string& message);
+    static std::uint64_t headerChecksumOf(Header header);
+};
+
+#endif // CATALOGSNAPSHOT_H
@@ -0,0 +1,327 @@
+/**
+ * @file columnarcatalog.cpp
+ * @brief This source file contains the definitions of the compact columnar catalog kept by the resident server
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "columnarcatalog.h"
+#include "catalog.h"
+#include "catalogsnapshot.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <unordered_set>
+
+#define LTS_keyword "LTS"
+
+namespace {
+
+// Interns strings into a growing pool, the set refers to the pool by offset so the pool may reallocate
+class StringInterner
+{
+public:
+    struct Reference{
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    explicit StringInterner(std::string& pool)
+        : pool(pool), references(1024, Hash{&pool}, Equal{&pool})
+    {
+
+    }
+
+    Reference intern(std::string_view text){
+        // Append the candidate and take it back if the string is already in the pool
+        Reference candidate{static_cast<std::uint32_t>(pool.size()), static_cast<std::uint32_t>(text.size())};
+        pool.append(text.data(), text.size());
+
+        auto inserted = references.insert(candidate);
+        if(!inserted.second){
+            pool.resize(candidate.offset);
+        }
+        else if(pool.size() > UINT32_MAX){
+            throw std::length_error("String pool of the catalog is too large");
+        }
+
+        return *inserted.first;
+    }
+
+private:
+    struct Hash{
+        const std::string* pool;
+        std::size_t operator()(const Reference& reference) const{
+            return std::hash<std::string_view>()(std::string_view(pool->data() + reference.offset, reference.length));
+        }
+    };
+
+    struct Equal{
+        const std::string* pool;
+        bool operator()(const Reference& lhs, const Reference& rhs) const{
+            return std::string_view(pool->data() + lhs.offset, lhs.length) == std::string_view(pool->data() + rhs.offset, rhs.length);
+        }
+    };
+
+    std::string& pool;
+    std::unordered_set<Reference, Hash, Equal> references;
+};
+
+// Places the columns one after another in a single block, every column aligned for its type
+class BlockLayout
+{
+public:
+    template<typename T>
+    std::size_t add(std::size_t count){
+        size = (size + alignof(T) - 1) / alignof(T) * alignof(T);
+        std::size_t offset = size;
+        size += count * sizeof(T);
+        return offset;
+    }
+
+    std::size_t size{0};
+};
+
+}
+
+ColumnarCatalog::ColumnarCatalog(const FeedView& view){
+    // Group the products by architecture as Catalog does, a view of a single architecture keeps its order
+    std::vector<std::uint32_t> order(view.products.size());
+    for(std::uint32_t i = 0; i < order.size(); i++){
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&view](std::uint32_t lhs, std::uint32_t rhs){
+        return view.products[lhs].arch < view.products[rhs].arch;
+    });
+
+    std::size_t versionTotal = 0;
+    std::size_t itemTotal = 0;
+    for(const ProductView& product : view.products){
+        versionTotal += product.versions.size();
+        for(const VersionView& t_version : product.versions){
+            itemTotal += t_version.items.size();
+        }
+    }
+
+    if(versionTotal >= npos || itemTotal >= npos){
+        throw std::length_error("Catalog is too large");
+    }
+
+    products = static_cast<std::uint32_t>(view.products.size());
+    versions = static_cast<std::uint32_t>(versionTotal);
+    items = static_cast<std::uint32_t>(itemTotal);
+    updatedAt = CatalogSnapshot::parseFeedTimestamp(view.updated);
+
+    // Lay the columns out in a single block
+    BlockLayout layout;
+    std::size_t productIdsOffset = layout.add<StringRef>(products);
+    std::size_t productStreamsOffset = layout.add<StringRef>(products);
+    std::size_t productArchsOffset = layout.add<StringRef>(products);
+    std::size_t productTitlesOffset = layout.add<StringRef>(products);
+    std::size_t productCodenamesOffset = layout.add<StringRef>(products);
+    std::size_t productReleasesOffset = layout.add<StringRef>(products);
+    std::size_t productReleaseVersionsOffset = layout.add<StringRef>(products);
+    std::size_t productVersionsOffset = layout.add<std::uint32_t>(products + 1);
+    std::size_t titleOrderOffset = layout.add<std::uint32_t>(products);
+    std::size_t codenameOrderOffset = layout.add<std::uint32_t>(products);
+    std::size_t versionNamesOffset = layout.add<StringRef>(versions);
+    std::size_t versionDigestsOffset = layout.add<Digest>(versions);
+    std::size_t versionPathsOffset = layout.add<PathRef>(versions);
+    std::size_t versionSizesOffset = layout.add<std::uint64_t>(versions);
+    std::size_t versionHasDigestOffset = layout.add<std::uint8_t>(versions);
+    std::size_t versionItemsOffset = layout.add<std::uint32_t>(versions + 1);
+    std::size_t itemNamesOffset = layout.add<StringRef>(items);
+    std::size_t itemFtypesOffset = layout.add<StringRef>(items);
+    std::size_t itemDigestsOffset = layout.add<Digest>(items);
+    std::size_t itemPathsOffset = layout.add<PathRef>(items);
+    std::size_t itemSizesOffset = layout.add<std::uint64_t>(items);
+    std::size_t itemHasDigestOffset = layout.add<std::uint8_t>(items);
+
+    // The block is allocated by new[] and aligned for every fundamental type
+    blockSize = layout.size;
+    block.reset(new unsigned char[blockSize]());
+    unsigned char* base = block.get();
+
+    productIds = reinterpret_cast<StringRef*>(base + productIdsOffset);
+    productStreams = reinterpret_cast<StringRef*>(base + productStreamsOffset);
+    productArchs = reinterpret_cast<StringRef*>(base + productArchsOffset);
+    productTitles = reinterpret_cast<StringRef*>(base + productTitlesOffset);
+    productCodenames = reinterpret_cast<StringRef*>(base + productCodenamesOffset);
+    productReleases = reinterpret_cast<StringRef*>(base + productReleasesOffset);
+    productReleaseVersions = reinterpret_cast<StringRef*>(base + productReleaseVersionsOffset);
+    productVersions = reinterpret_cast<std::uint32_t*>(base + productVersionsOffset);
+    titleOrder = reinterpret_cast<std::uint32_t*>(base + titleOrderOffset);
+    codenameOrder = reinterpret_cast<std::uint32_t*>(base + codenameOrderOffset);
+    versionNames = reinterpret_cast<StringRef*>(base + versionNamesOffset);
+    versionDigests = reinterpret_cast<Digest*>(base + versionDigestsOffset);
+    versionPaths = reinterpret_cast<PathRef*>(base + versionPathsOffset);
+    versionSizes = reinterpret_cast<std::uint64_t*>(base + versionSizesOffset);
+    versionHasDigest = reinterpret_cast<std::uint8_t*>(base + versionHasDigestOffset);
+    versionItems = reinterpret_cast<std::uint32_t*>(base + versionItemsOffset);
+    itemNames = reinterpret_cast<StringRef*>(base + itemNamesOffset);
+    itemFtypes = reinterpret_cast<StringRef*>(base + itemFtypesOffset);
+    itemDigests = reinterpret_cast<Digest*>(base + itemDigestsOffset);
+    itemPaths = reinterpret_cast<PathRef*>(base + itemPathsOffset);
+    itemSizes = reinterpret_cast<std::uint64_t*>(base + itemSizesOffset);
+    itemHasDigest = reinterpret_cast<std::uint8_t*>(base + itemHasDigestOffset);
+
+    // Fill the columns, every distinct string is stored once
+    StringInterner interner(strings);
+    auto intern = [&interner](std::string_view text){
+        StringInterner::Reference reference = interner.intern(text);
+        return StringRef{reference.offset, reference.length};
+    };
+    auto internPath = [&intern](std::string_view text){
+        std::size_t separator = text.rfind('/');
+        if(separator == std::string_view::npos){
+            return PathRef{StringRef{0, 0}, intern(text)};
+        }
+        return PathRef{intern(text.substr(0, separator + 1)), intern(text.substr(separator + 1))};
+    };
+
+    std::uint32_t versionPosition = 0;
+    std::uint32_t itemPosition = 0;
+
+    for(std::uint32_t position = 0; position < products; position++){
+        const ProductView& product = view.products[order[position]];
+
+        productIds[position] = intern(product.id);
+        productStreams[position] = intern(product.stream);
+        productArchs[position] = intern(product.arch);
+        productTitles[position] = intern(product.releaseTitle);
+        productCodenames[position] = intern(product.releaseCodename);
+        productReleases[position] = intern(product.release);
+        productReleaseVersions[position] = intern(product.releaseVersion);
+        productVersions[position] = versionPosition;
+
+        for(const VersionView& t_version : product.versions){
+            versionNames[versionPosition] = intern(t_version.version);
+            versionHasDigest[versionPosition] = Sha256::fromHex(t_version.sha256, versionDigests[versionPosition].bytes) ? 1 : 0;
+            versionPaths[versionPosition] = internPath(t_version.path);
+            versionSizes[versionPosition] = t_version.size;
+            versionItems[versionPosition] = itemPosition;
+
+            for(const ItemView& item : t_version.items){
+                itemNames[itemPosition] = intern(item.name);
+                itemFtypes[itemPosition] = intern(item.ftype);
+                itemHasDigest[itemPosition] = Sha256::fromHex(item.sha256, itemDigests[itemPosition].bytes) ? 1 : 0;
+                itemPaths[itemPosition] = internPath(item.path);
+                itemSizes[itemPosition] = item.size;
+                itemPosition++;
+            }
+
+            versionPosition++;
+        }
+    }
+    productVersions[products] = versionPosition;
+    versionItems[versions] = itemPosition;
+
+    // Sort the positions by title and codename, the stable sort keeps the first product of a duplicate in front
+    for(std::uint32_t position = 0; position < products; position++){
+        titleOrder[position] = position;
+        codenameOrder[position] = position;
+    }
+    std::stable_sort(titleOrder, titleOrder + products, [this](std::uint32_t lhs, std::uint32_t rhs){
+        return string(productTitles[lhs]) < string(productTitles[rhs]);
+    });
+    std::stable_sort(codenameOrder, codenameOrder + products, [this](std::uint32_t lhs, std::uint32_t rhs){
+        return string(productCodenames[lhs]) < string(productCodenames[rhs]);
+    });
+
+    // The LTS release with the highest release version, the first product of that version wins
+    std::uint32_t latestLTSRank = 0;
+    for(std::uint32_t position = 0; position < products; position++){
+        std::uint32_t rank = Catalog::releaseRank(releaseVersion(position), releaseTitle(position));
+        if(releaseTitle(position).find(LTS_keyword) != std::string_view::npos && (latestLTSProduct == npos || rank > latestLTSRank)){
+            latestLTSProduct = position;
+            latestLTSRank = rank;
+        }
+    }
+
+    // Give the spare capacity of the pool back
+    strings.shrink_to_fit();
+}
+
+std::size_t ColumnarCatalog::memoryBytes() const{
+    return sizeof(*this) + strings.capacity() + blockSize;
+}
+
+const std::uint8_t* ColumnarCatalog::versionDigest(std::uint32_t version) const{
+    return versionHasDigest[version] ? versionDigests[version].bytes : nullptr;
+}
+
+std::string ColumnarCatalog::versionSha256(std::uint32_t version) const{
+    const std::uint8_t* digest = versionDigest(version);
+    return digest ? Sha256::toHex(digest) : std::string();
+}
+
+std::string_view ColumnarCatalog::versionPath(std::uint32_t version, std::string& scratch) const{
+    return path(versionPaths[version], scratch);
+}
+
+const std::uint8_t* ColumnarCatalog::itemDigest(std::uint32_t item) const{
+    return itemHasDigest[item] ? itemDigests[item].bytes : nullptr;
+}
+
+std::string ColumnarCatalog::itemSha256(std::uint32_t item) const{
+    const std::uint8_t* digest = itemDigest(item);
+    return digest ? Sha256::toHex(digest) : std::string();
+}
+
+std::string_view ColumnarCatalog::itemPath(std::uint32_t item, std::string& scratch) const{
+    return path(itemPaths[item], scratch);
+}
+
+std::string_view ColumnarCatalog::path(const PathRef& reference, std::string& scratch) const{
+    if(reference.directory.length == 0){
+        return string(reference.file);
+    }
+
+    scratch.assign(string(reference.directory));
+    scratch.append(string(reference.file));
+    return scratch;
+}
+
+std::uint32_t ColumnarCatalog::find(const std::uint32_t* order, const StringRef* column, std::string_view key) const{
+    const std::uint32_t* it = std::lower_bound(order, order + products, key, [this, column](std::uint32_t position, std::string_view rhs){
+        return string(column[position]) < rhs;
+    });
+
+    if(it == order + products || string(column[*it]) != key){
+        return npos;
+    }
+
+    return *it;
+}
+
+std::uint32_t ColumnarCatalog::findByTitle(std::string_view releaseTitle) const{
+    return find(titleOrder, productTitles, releaseTitle);
+}
+
+std::uint32_t ColumnarCatalog::findByCodename(std::string_view releaseCodename) const{
+    return find(codenameOrder, productCodenames, releaseCodename);
+}
+
+std::uint32_t ColumnarCatalog::findRelease(std::string_view release) const{
+    // Title is prioritized as in the cli options
+    std::uint32_t product = findByTitle(release);
+    return product != npos ? product : findByCodename(release);
+}
+
+std::uint32_t ColumnarCatalog::findVersion(std::uint32_t product, std::string_view version) const{
+    // Versions are sorted, search them by binary search
+    const StringRef* begin = versionNames + versionsBegin(product);
+    const StringRef* end = versionNames + versionsEnd(product);
+    const StringRef* it = std::lower_bound(begin, end, version, [this](const StringRef& lhs, std::string_view rhs){
+        return string(lhs) < rhs;
+    });
+
+    if(it == end || string(*it) != version){
+        return npos;
+    }
+
+    return static_cast<std::uint32_t>(it - versionNames);
+}
@@ -0,0 +1,182 @@
+/**
+ * @file columnarcatalog.h
+ * @brief This header file contains the declarations of the compact columnar catalog kept by the resident server
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef COLUMNARCATALOG_H
+#define COLUMNARCATALOG_H
+
+#include "productview.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ColumnarCatalog
+ * @brief This class keeps the products, versions and items of a view as columns (structure of arrays) instead of a
+ * tree of objects, for the processes that hold a catalog for a long time. Every distinct string is stored once in a
+ * single string pool and referenced by (offset, length) pairs, paths are split into a directory and a file name so
+ * that the shared parts are stored once, sha256 digests are kept as 32 raw bytes, sizes and the feed time as integers.
+ * All columns live in a single block, the whole catalog is released by two deallocations.
+ *
+ * Products, versions and items are addressed by their position. The versions of product p are
+ * [versionsBegin(p), versionsEnd(p)) and the items of version v are [itemsBegin(v), itemsEnd(v)), so a scan of a column
+ * is a walk over a contiguous array. Release titles and codenames are resolved by binary search over sorted position
+ * columns, lookups do not allocate.
+ */
+class ColumnarCatalog
+{
+public:
+    // Position returned by the lookups when nothing is found
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+    /**
+     * @brief ColumnarCatalog class constructor, copies the view into the columns
+     * @param view products of the document sorted by product id, versions of each product sorted by version
+    */
+    explicit ColumnarCatalog(const FeedView& view);
+
+    ColumnarCatalog(const ColumnarCatalog&) = delete;
+    ColumnarCatalog& operator=(const ColumnarCatalog&) = delete;
+
+    std::uint32_t productCount() const { return products; }
+    std::uint32_t versionCount() const { return versions; }
+    std::uint32_t itemCount() const { return items; }
+
+    /**
+     * @brief returns the 'updated' time of the feed as unix time, 0 if it could not be parsed.
+    */
+    std::time_t updated() const { return updatedAt; }
+
+    /**
+     * @brief returns the number of bytes owned by the catalog.
+    */
+    std::size_t memoryBytes() const;
+
+    // Products, grouped by architecture and in product id order within an architecture
+    std::string_view productId(std::uint32_t product) const { return string(productIds[product]); }
+    std::string_view stream(std::uint32_t product) const { return string(productStreams[product]); }
+    std::string_view arch(std::uint32_t product) const { return string(productArchs[product]); }
+    std::string_view releaseTitle(std::uint32_t product) const { return string(productTitles[product]); }
+    std::string_view releaseCodename(std::uint32_t product) const { return string(productCodenames[product]); }
+    std::string_view release(std::uint32_t product) const { return string(productReleases[product]); }
+    std::string_view releaseVersion(std::uint32_t product) const { return string(productReleaseVersions[product]); }
+    std::uint32_t versionsBegin(std::uint32_t product) const { return productVersions[product]; }
+    std::uint32_t versionsEnd(std::uint32_t product) const { return productVersions[product + 1]; }
+
+    // Versions and their disk1.img item
+    std::string_view version(std::uint32_t version) const { return string(versionNames[version]); }
+    // 32 raw bytes of the sha256, null if the version has none
+    const std::uint8_t* versionDigest(std::uint32_t version) const;
+    std::string versionSha256(std::uint32_t version) const;
+    // The path is assembled in the scratch string when it is stored in two parts
+    std::string_view versionPath(std::uint32_t version, std::string& scratch) const;
+    std::uint64_t versionSize(std::uint32_t version) const { return versionSizes[version]; }
+    std::uint32_t itemsBegin(std::uint32_t version) const { return versionItems[version]; }
+    std::uint32_t itemsEnd(std::uint32_t version) const { return versionItems[version + 1]; }
+
+    // Items, only present if the view was built with ViewFields::Items
+    std::string_view itemName(std::uint32_t item) const { return string(itemNames[item]); }
+    std::string_view itemFtype(std::uint32_t item) const { return string(itemFtypes[item]); }
+    const std::uint8_t* itemDigest(std::uint32_t item) const;
+    std::string itemSha256(std::uint32_t item) const;
+    std::string_view itemPath(std::uint32_t item, std::string& scratch) const;
+    std::uint64_t itemSize(std::uint32_t item) const { return itemSizes[item]; }
+
+    /**
+     * @brief returns the first product (in product id order) with the given release title, npos if there is none.
+    */
+    std::uint32_t findByTitle(std::string_view releaseTitle) const;
+
+    /**
+     * @brief returns the first product (in product id order) with the given release codename, npos if there is none.
+    */
+    std::uint32_t findByCodename(std::string_view releaseCodename) const;
+
+    /**
+     * @brief returns the product with the given release title, or with the given release codename if no title matches.
+    */
+    std::uint32_t findRelease(std::string_view release) const;
+
+    /**
+     * @brief returns the LTS release with the highest release version, npos if there is none.
+    */
+    std::uint32_t latestLTS() const { return latestLTSProduct; }
+
+    /**
+     * @brief returns the given version of the product, npos if the product has no such version.
+    */
+    std::uint32_t findVersion(std::uint32_t product, std::string_view version) const;
+
+private:
+    struct StringRef{
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    // Path split after its last '/', the directory keeps the separator
+    struct PathRef{
+        StringRef directory;
+        StringRef file;
+    };
+
+    struct Digest{
+        std::uint8_t bytes[32];
+    };
+
+    std::uint32_t products{0};
+    std::uint32_t versions{0};
+    std::uint32_t items{0};
+    std::time_t updatedAt{0};
+    // Found once by the release versions
+    std::uint32_t latestLTSProduct{npos};
+
+    // Interned strings
+    std::string strings;
+
+    // Single block holding every column below
+    std::unique_ptr<unsigned char[]> block;
+    std::size_t blockSize{0};
+
+    // Product columns, productVersions has one more entry than the products
+    StringRef* productIds{nullptr};
+    StringRef* productStreams{nullptr};
+    StringRef* productArchs{nullptr};
+    StringRef* productTitles{nullptr};
+    StringRef* productCodenames{nullptr};
+    StringRef* productReleases{nullptr};
+    StringRef* productReleaseVersions{nullptr};
+    std::uint32_t* productVersions{nullptr};
+    // Positions of the products sorted by title and codename, ties in product order
+    std::uint32_t* titleOrder{nullptr};
+    std::uint32_t* codenameOrder{nullptr};
+
+    // Version columns, versionItems has one more entry than the versions
+    StringRef* versionNames{nullptr};
+    Digest* versionDigests{nullptr};
+    PathRef* versionPaths{nullptr};
+    std::uint64_t* versionSizes{nullptr};
+    std::uint8_t* versionHasDigest{nullptr};
+    std::uint32_t* versionItems{nullptr};
+
+    // Item columns
+    StringRef* itemNames{nullptr};
+    StringRef* itemFtypes{nullptr};
+    Digest* itemDigests{nullptr};
+    PathRef* itemPaths{nullptr};
+    std::uint64_t* itemSizes{nullptr};
+    std::uint8_t* itemHasDigest{nullptr};
+
+    std::string_view string(StringRef reference) const { return std::string_view(strings.data() + reference.offset, reference.length); }
+    std::string_view path(const PathRef& reference, std::string& scratch) const;
+    std::uint32_t find(const std::uint32_t* order, const StringRef* column, std::string_view key) const;
+};
+
+#endif // COLUMNARCATALOG_H
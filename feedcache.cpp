@@ -0,0 +1,264 @@
+/**
+ * @file feedcache.cpp
+ * @brief This source file contains the definitions of the on-disk feed cache class and its methods
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "feedcache.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+FeedCache::FeedCache(std::string cacheDirectory, long maxAgeSeconds, std::string name)
+    : cacheDirectory(cacheDirectory.empty() ? defaultDirectory() : cacheDirectory),
+      maxAgeSeconds(maxAgeSeconds),
+      name(name)
+{
+    loadMeta();
+}
+
+std::string FeedCache::defaultDirectory(){
+    // Prefer the xdg cache directory if it is defined
+    if(const char* xdgCache = std::getenv("XDG_CACHE_HOME")){
+        if(*xdgCache){
+            return (std::filesystem::path(xdgCache) / "ucii").string();
+        }
+    }
+
+    // Windows keeps the per user caches under the local app data directory
+    if(const char* localAppData = std::getenv("LOCALAPPDATA")){
+        if(*localAppData){
+            return (std::filesystem::path(localAppData) / "ucii").string();
+        }
+    }
+
+    if(const char* home = std::getenv("HOME")){
+        if(*home){
+            return (std::filesystem::path(home) / ".cache" / "ucii").string();
+        }
+    }
+
+    // Fall back to the temporary directory of the system
+    std::error_code error;
+    return (std::filesystem::temp_directory_path(error) / "ucii").string();
+}
+
+std::string FeedCache::bodyPath() const{
+    return (std::filesystem::path(cacheDirectory) / (name + ".json")).string();
+}
+
+std::string FeedCache::metaPath() const{
+    return (std::filesystem::path(cacheDirectory) / (name + ".meta")).string();
+}
+
+std::string FeedCache::historyPath() const{
+    return (std::filesystem::path(cacheDirectory) / (name + ".history")).string();
+}
+
+bool FeedCache::hasBody() const{
+    std::error_code error;
+    return std::filesystem::is_regular_file(bodyPath(), error);
+}
+
+bool FeedCache::isFresh() const{
+    // A body without a fetch time can not be trusted without revalidation
+    if(!hasBody() || cachedFetchedAt == 0){
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+
+    return now >= cachedFetchedAt && (now - cachedFetchedAt) < maxAgeSeconds;
+}
+
+bool FeedCache::mapBody(MappedFile& file) const{
+    return file.open(bodyPath());
+}
+
+bool FeedCache::beginStore(){
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+
+    // Write the body next to its final location, it is moved in place by commitStore
+    pendingBody.close();
+    pendingBody.clear();
+    pendingBody.open(bodyPath() + ".tmp", std::ios::out | std::ios::binary | std::ios::trunc);
+
+    return pendingBody.is_open();
+}
+
+bool FeedCache::appendBody(const char* data, std::size_t length){
+    if(!pendingBody.is_open()){
+        return false;
+    }
+
+    pendingBody.write(data, static_cast<std::streamsize>(length));
+
+    return static_cast<bool>(pendingBody);
+}
+
+bool FeedCache::commitStore(const std::string& etag, const std::string& lastModified){
+    if(!pendingBody.is_open()){
+        return false;
+    }
+
+    pendingBody.close();
+
+    std::string temporaryPath = bodyPath() + ".tmp";
+    std::error_code error;
+
+    if(!pendingBody){
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, bodyPath(), error);
+
+    if(error){
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    cachedEtag = etag;
+    cachedLastModified = lastModified;
+    cachedFetchedAt = std::time(nullptr);
+    cachedIndexUpdated.clear();
+
+    return saveMeta();
+}
+
+void FeedCache::abortStore(){
+    if(pendingBody.is_open()){
+        pendingBody.close();
+
+        std::error_code error;
+        std::filesystem::remove(bodyPath() + ".tmp", error);
+    }
+}
+
+bool FeedCache::store(const std::string& body, const std::string& etag, const std::string& lastModified){
+    if(!beginStore()){
+        return false;
+    }
+
+    if(!appendBody(body.data(), body.size())){
+        abortStore();
+        return false;
+    }
+
+    return commitStore(etag, lastModified);
+}
+
+bool FeedCache::touch(){
+    cachedFetchedAt = std::time(nullptr);
+    return saveMeta();
+}
+
+void FeedCache::discard(){
+    std::error_code error;
+    std::filesystem::remove(bodyPath(), error);
+    std::filesystem::remove(metaPath(), error);
+
+    // The estimate of the time to the first byte does not depend on the body, it is kept
+    cachedEtag.clear();
+    cachedLastModified.clear();
+    cachedFetchedAt = 0;
+    cachedIndexUpdated.clear();
+}
+
+bool FeedCache::setIndexUpdated(const std::string& stamp){
+    cachedIndexUpdated = stamp;
+    return saveMeta();
+}
+
+void FeedCache::setFirstByte(double smoothed, double deviation){
+    cachedFirstByte = smoothed;
+    cachedFirstByteDeviation = deviation;
+}
+
+bool FeedCache::setHistoryTail(std::uint64_t size, std::uint64_t updatedHash){
+    cachedHistorySize = size;
+    cachedHistoryUpdatedHash = updatedHash;
+    return saveMeta();
+}
+
+void FeedCache::loadMeta(){
+    std::ifstream file(metaPath());
+
+    if(!file){
+        return;
+    }
+
+    // Metadata is stored as 'key: value' lines
+    std::string line;
+    while(std::getline(file, line)){
+        std::size_t separator = line.find(": ");
+
+        if(separator == std::string::npos){
+            continue;
+        }
+
+        std::string key = line.substr(0, separator);
+        std::string value = line.substr(separator + 2);
+
+        if(key == "etag"){
+            cachedEtag = value;
+        }
+        else if(key == "last_modified"){
+            cachedLastModified = value;
+        }
+        else if(key == "fetched"){
+            cachedFetchedAt = static_cast<std::time_t>(std::strtoll(value.c_str(), nullptr, 10));
+        }
+        else if(key == "index_updated"){
+            cachedIndexUpdated = value;
+        }
+        else if(key == "first_byte"){
+            std::istringstream times(value);
+            times >> cachedFirstByte >> cachedFirstByteDeviation;
+            if(!times){
+                cachedFirstByte = 0;
+                cachedFirstByteDeviation = 0;
+            }
+        }
+        else if(key == "history_tail"){
+            std::istringstream tail(value);
+            tail >> cachedHistorySize >> cachedHistoryUpdatedHash;
+            if(!tail){
+                cachedHistorySize = 0;
+                cachedHistoryUpdatedHash = 0;
+            }
+        }
+    }
+}
+
+bool FeedCache::saveMeta() const{
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+
+    std::string temporaryPath = metaPath() + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::out | std::ios::trunc);
+
+        if(!file){
+            return false;
+        }
+
+        file << "etag: " << cachedEtag << "\n";
+        file << "last_modified: " << cachedLastModified << "\n";
+        file << "fetched: " << static_cast<long long>(cachedFetchedAt) << "\n";
+        file << "index_updated: " << cachedIndexUpdated << "\n";
+        if(cachedFirstByte > 0){
+            file << "first_byte: " << cachedFirstByte << " " << cachedFirstByteDeviation << "\n";
+        }
+        if(cachedHistorySize > 0){
+            file << "history_tail: " << cachedHistorySize << " " << cachedHistoryUpdatedHash << "\n";
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, metaPath(), error);
+
+    return !error;
+}
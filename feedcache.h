@@ -0,0 +1,167 @@
+/**
+ * @file feedcache.h
+ * @brief This header file contains the declarations of the on-disk feed cache class and its methods
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef FEEDCACHE_H
+#define FEEDCACHE_H
+
+#include "mappedfile.h"
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+/**
+ * @class FeedCache
+ * @brief This class stores the last downloaded feed body together with its http validators (ETag, Last-Modified)
+ * in a cache directory, so that later invocations can either skip the network within the max-age or revalidate
+ * the body by a conditional request.
+ */
+class FeedCache
+{
+public:
+    /**
+     * @brief FeedCache class constructor
+     * @param cacheDirectory directory to keep the cached body and its metadata. If empty, the default directory is used.
+     * @param maxAgeSeconds cached body is used without any network access while it is younger than this value.
+     * @param name base name of the cached files, allows several feeds to share the same cache directory.
+    */
+    FeedCache(std::string cacheDirectory = "", long maxAgeSeconds = 300, std::string name = "download");
+
+    /**
+     * @brief returns the default cache directory of the platform ($XDG_CACHE_HOME/ucii, ~/.cache/ucii or %LOCALAPPDATA%/ucii)
+    */
+    static std::string defaultDirectory();
+
+    /**
+     * @brief returns true if a cached body exists on the disk.
+    */
+    bool hasBody() const;
+
+    /**
+     * @brief returns true if a cached body exists and it is younger than the configured max-age.
+    */
+    bool isFresh() const;
+
+    /**
+     * @brief maps the cached body into the memory, it is parsed in place as a local file is.
+    */
+    bool mapBody(MappedFile& file) const;
+
+    /**
+     * @brief starts replacing the cached body by a body that arrives in chunks. The body is written into a temporary
+     * file by appendBody() and replaces the cached body only after commitStore().
+    */
+    bool beginStore();
+
+    /**
+     * @brief appends the next chunk of the body started by beginStore().
+    */
+    bool appendBody(const char* data, std::size_t length);
+
+    /**
+     * @brief moves the body written by appendBody() in place and stores its validators.
+    */
+    bool commitStore(const std::string& etag, const std::string& lastModified);
+
+    /**
+     * @brief drops the body written by appendBody().
+    */
+    void abortStore();
+
+    /**
+     * @brief replaces the cached body and its validators. Files are written to a temporary file first and renamed,
+     * so that a concurrent reader never observes a partially written body.
+     * @param body response body to be stored
+     * @param etag ETag header of the response, may be empty
+     * @param lastModified Last-Modified header of the response, may be empty
+    */
+    bool store(const std::string& body, const std::string& etag, const std::string& lastModified);
+
+    /**
+     * @brief marks the cached body as revalidated now (called after a 304 Not Modified response).
+    */
+    bool touch();
+
+    /**
+     * @brief removes the cached body and its metadata, e.g. after the cached body turned out to be corrupt. The next
+     * request is then unconditional.
+    */
+    void discard();
+
+    /**
+     * @brief stores the 'updated' stamp of the simplestreams index entry the cached body belongs to. The stamp is
+     * cleared whenever a new body is stored.
+    */
+    bool setIndexUpdated(const std::string& stamp);
+
+    /**
+     * @brief keeps the estimate of the time to the first byte of the feed requests (smoothed time and deviation in
+     * seconds), so that the hedge delay of the next invocation starts from it. It is written with the next metadata.
+    */
+    void setFirstByte(double smoothed, double deviation);
+
+    /**
+     * @brief stores the size of the history and the hash of the 'updated' field of its last record as seen by the last
+     * record, so that the next invocation skips the history while neither changed.
+    */
+    bool setHistoryTail(std::uint64_t size, std::uint64_t updatedHash);
+
+    // Accessors of the cached validators
+    const std::string& etag() const { return cachedEtag; }
+    const std::string& lastModified() const { return cachedLastModified; }
+    std::time_t fetchedAt() const { return cachedFetchedAt; }
+    const std::string& indexUpdated() const { return cachedIndexUpdated; }
+    double firstByteSmoothed() const { return cachedFirstByte; }
+    double firstByteDeviation() const { return cachedFirstByteDeviation; }
+    std::uint64_t historySize() const { return cachedHistorySize; }
+    std::uint64_t historyUpdatedHash() const { return cachedHistoryUpdatedHash; }
+
+    // Accessors of the cache configuration
+    const std::string& directory() const { return cacheDirectory; }
+    long maxAge() const { return maxAgeSeconds; }
+    std::string bodyPath() const;
+    std::string metaPath() const;
+    // History of the catalogs of the feed, kept next to its cached body
+    std::string historyPath() const;
+
+private:
+    // Directory of the cached files
+    std::string cacheDirectory;
+    // Maximum age of the cached body in seconds to be used without revalidation
+    long maxAgeSeconds;
+    // Base name of the cached files
+    std::string name;
+
+    // Validators and fetch time of the cached body
+    std::string cachedEtag;
+    std::string cachedLastModified;
+    std::time_t cachedFetchedAt{0};
+    // 'updated' stamp of the index entry of the cached body, empty if unknown
+    std::string cachedIndexUpdated;
+    // Time to the first byte of the feed requests, 0 if unknown
+    double cachedFirstByte{0};
+    double cachedFirstByteDeviation{0};
+    // Tail of the history as seen by the last record, 0 if unknown
+    std::uint64_t cachedHistorySize{0};
+    std::uint64_t cachedHistoryUpdatedHash{0};
+
+    // Temporary file of a body being stored
+    std::ofstream pendingBody;
+
+    /**
+     * @brief reads the metadata file of the cached body.
+    */
+    void loadMeta();
+
+    /**
+     * @brief writes the metadata file of the cached body.
+    */
+    bool saveMeta() const;
+};
+
+#endif // FEEDCACHE_H
@@ -0,0 +1,173 @@
+/**
+ * @file filehasher.cpp
+ * @brief This source file contains the definitions of the double buffered file hasher class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "filehasher.h"
+#include "sha256.h"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+// Alignment of the read buffers, a multiple of the page size
+#define buffer_alignment 4096
+
+namespace
+{
+
+struct AlignedFree
+{
+    void operator()(std::uint8_t* pointer) const{
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+};
+
+using AlignedBuffer = std::unique_ptr<std::uint8_t[], AlignedFree>;
+
+AlignedBuffer allocateAligned(std::size_t size){
+#ifdef _WIN32
+    return AlignedBuffer(static_cast<std::uint8_t*>(_aligned_malloc(size, buffer_alignment)));
+#else
+    void* pointer = nullptr;
+    if(posix_memalign(&pointer, buffer_alignment, size) != 0){
+        return AlignedBuffer();
+    }
+    return AlignedBuffer(static_cast<std::uint8_t*>(pointer));
+#endif
+}
+
+// Read buffer handed over between the reader and the hasher
+struct Slot
+{
+    AlignedBuffer data;
+    std::size_t length{0};
+    // True while the slot holds data that is not hashed yet
+    bool full{false};
+};
+
+}
+
+FileHasher::FileHasher(std::size_t bufferSize)
+    : bufferSize((bufferSize + buffer_alignment - 1) / buffer_alignment * buffer_alignment)
+{
+    if(this->bufferSize == 0){
+        this->bufferSize = buffer_alignment;
+    }
+}
+
+bool FileHasher::hash(const std::string& path, std::uint8_t digest[32]){
+    bytes = 0;
+    seconds = 0;
+    error.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if(!file){
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    // Reads go straight into the aligned buffers, stdio buffering would only add a copy
+    std::setvbuf(file, nullptr, _IONBF, 0);
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    Slot slots[2];
+    for(Slot& slot : slots){
+        slot.data = allocateAligned(bufferSize);
+        if(!slot.data){
+            std::fclose(file);
+            error = "could not allocate the read buffers";
+            return false;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    // Set by the reader after the last slot is filled
+    bool finished = false;
+    bool readFailed = false;
+    // Set by the hasher to stop the reader early
+    bool cancelled = false;
+
+    std::thread reader([&]{
+        for(std::size_t index = 0; ; index ^= 1){
+            Slot& slot = slots[index];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]{ return !slot.full || cancelled; });
+                if(cancelled){
+                    return;
+                }
+            }
+
+            std::size_t length = std::fread(slot.data.get(), 1, bufferSize, file);
+            bool failed = std::ferror(file) != 0;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.length = length;
+            slot.full = length > 0;
+            if(length < bufferSize || failed){
+                finished = true;
+                readFailed = failed;
+            }
+            condition.notify_all();
+            if(finished){
+                return;
+            }
+        }
+    });
+
+    Sha256 hasher;
+    for(std::size_t index = 0; ; index ^= 1){
+        Slot& slot = slots[index];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]{ return slot.full || finished; });
+            if(!slot.full || readFailed){
+                cancelled = true;
+                condition.notify_all();
+                break;
+            }
+        }
+
+        // The slot belongs to the hasher until it is marked empty
+        hasher.update(slot.data.get(), slot.length);
+        bytes += slot.length;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.full = false;
+        condition.notify_all();
+    }
+
+    reader.join();
+    std::fclose(file);
+
+    if(readFailed){
+        error = path + ": read error";
+        return false;
+    }
+
+    hasher.finish(digest);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return true;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file filehasher.h
+ * @brief This header file contains the declarations of the double buffered file hasher class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef FILEHASHER_H
+#define FILEHASHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class FileHasher
+ * @brief This class computes the sha256 digest of a file. A reader thread fills two large aligned buffers in turn
+ * while the calling thread hashes the other one, so that reading and hashing overlap and a large image is verified
+ * at the speed of the slower of the two.
+ */
+class FileHasher
+{
+public:
+    /**
+     * @brief FileHasher class constructor
+     * @param bufferSize size of each of the two read buffers
+    */
+    explicit FileHasher(std::size_t bufferSize = 8 * 1024 * 1024);
+
+    /**
+     * @brief hashes the whole file.
+     * @param path file to be hashed
+     * @param digest 32 byte sha256 digest of the file
+     * @return false if the file can not be read, errorMessage() describes the problem.
+    */
+    bool hash(const std::string& path, std::uint8_t digest[32]);
+
+    // Statistics of the last hash() call
+    std::uint64_t bytesHashed() const { return bytes; }
+    double elapsedSeconds() const { return seconds; }
+    const std::string& errorMessage() const { return error; }
+
+private:
+    std::size_t bufferSize;
+    std::uint64_t bytes{0};
+    double seconds{0};
+    std::string error;
+};
+
+#endif // FILEHASHER_H
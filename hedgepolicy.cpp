@@ -0,0 +1,86 @@
+/**
+ * @file hedgepolicy.cpp
+ * @brief This source file contains the definitions of the timing policy of the hedged and retried feed requests
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "hedgepolicy.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Hedge delay before the first byte of any request is observed, and its limits once it adapts
+#define initial_hedge_delay_ms 1000.0
+#define min_hedge_delay_ms 50.0
+#define max_hedge_delay_ms 4000.0
+
+// Limit of the wait before the first retry, doubled by every further failure up to the cap
+#define backoff_base_ms 250.0
+#define backoff_cap_ms 8000.0
+
+HedgePolicy::HedgePolicy(long fixedDelay, unsigned retries)
+    : HedgePolicy(fixedDelay, retries, std::random_device{}(), Clock::now)
+{
+}
+
+HedgePolicy::HedgePolicy(long fixedDelay, unsigned retries, std::uint32_t seed, Now now)
+    : fixedDelay(fixedDelay < 0 ? 0 : fixedDelay),
+      retryCount(retries),
+      random(seed),
+      clock(now ? std::move(now) : Now(Clock::now))
+{
+}
+
+HedgePolicy::Clock::time_point HedgePolicy::now() const{
+    return clock();
+}
+
+std::chrono::milliseconds HedgePolicy::hedgeDelay() const{
+    if(fixedDelay > 0){
+        return std::chrono::milliseconds(fixedDelay);
+    }
+
+    double delay = initial_hedge_delay_ms;
+    if(smoothed > 0){
+        delay = std::clamp(1000.0 * (smoothed + 4 * deviation), min_hedge_delay_ms, max_hedge_delay_ms);
+    }
+
+    return std::chrono::milliseconds(static_cast<long>(delay));
+}
+
+void HedgePolicy::recordFirstByte(double seconds){
+    if(seconds <= 0){
+        return;
+    }
+
+    // Gains of rfc 6298, the first sample sets the time and half of it as the deviation
+    if(smoothed == 0){
+        smoothed = seconds;
+        deviation = seconds / 2;
+        return;
+    }
+
+    deviation = 0.75 * deviation + 0.25 * std::fabs(smoothed - seconds);
+    smoothed = 0.875 * smoothed + 0.125 * seconds;
+}
+
+std::chrono::milliseconds HedgePolicy::backoff(unsigned failures){
+    // The first retry waits up to the base
+    unsigned doublings = failures > 0 ? failures - 1 : 0;
+    double limit = backoff_cap_ms;
+    if(doublings < 16){
+        limit = std::min(backoff_cap_ms, backoff_base_ms * static_cast<double>(1u << doublings));
+    }
+
+    std::uniform_real_distribution<double> jitter(0, limit);
+
+    return std::chrono::milliseconds(static_cast<long>(jitter(random)));
+}
+
+void HedgePolicy::restore(double t_smoothed, double t_deviation){
+    if(t_smoothed > 0 && t_deviation >= 0){
+        smoothed = t_smoothed;
+        deviation = t_deviation;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file hedgepolicy.h
+ * @brief This header file contains the declarations of the timing policy of the hedged and retried feed requests
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef HEDGEPOLICY_H
+#define HEDGEPOLICY_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+/**
+ * @class HedgePolicy
+ * @brief This class decides when a feed request that has not produced its first byte yet is hedged by a second
+ * request and how long a failed request waits before it is retried. The hedge delay adapts to the observed times to
+ * the first byte the way the tcp retransmission timeout adapts to the round trips: a smoothed time and its smoothed
+ * deviation are kept and the delay is the time plus four deviations, so that only the slowest few requests are hedged.
+ * Retries wait a random time up to an exponentially growing limit (full jitter), so that the clients failing at the
+ * same time do not retry at the same time. Given a seed and a clock the policy is deterministic, so that its decisions
+ * can be tested.
+ */
+class HedgePolicy
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    // Source of the current time, the steady clock unless a test replaces it
+    using Now = std::function<Clock::time_point()>;
+
+    /**
+     * @brief HedgePolicy class constructor, the jitter is seeded randomly
+     * @param fixedDelay hedge delay in milliseconds, 0 to adapt it to the observed times to the first byte
+     * @param retries number of requests allowed in addition to one per source
+    */
+    explicit HedgePolicy(long fixedDelay = 0, unsigned retries = 2);
+
+    /**
+     * @brief HedgePolicy class constructor of a deterministic policy
+     * @param seed seed of the jitter, the same seed draws the same backoffs
+     * @param now clock the hedge and retry times are based on
+    */
+    HedgePolicy(long fixedDelay, unsigned retries, std::uint32_t seed, Now now);
+
+    /**
+     * @brief returns the current time of the clock of the policy.
+    */
+    Clock::time_point now() const;
+
+    /**
+     * @brief returns when a request started at the given time is hedged if it has not produced its first byte yet.
+    */
+    Clock::time_point hedgeAt(Clock::time_point started) const { return started + hedgeDelay(); }
+
+    /**
+     * @brief returns when the retry that follows the given number of consecutive failures is started, from now on.
+    */
+    Clock::time_point retryAt(unsigned failures) { return now() + backoff(failures); }
+
+    /**
+     * @brief returns how long a request may wait for its first byte before a hedged request is started.
+    */
+    std::chrono::milliseconds hedgeDelay() const;
+
+    /**
+     * @brief adds an observed time to the first byte to the estimate.
+    */
+    void recordFirstByte(double seconds);
+
+    /**
+     * @brief returns the jittered wait before the retry that follows the given number of consecutive failures.
+    */
+    std::chrono::milliseconds backoff(unsigned failures);
+
+    /**
+     * @brief restores an estimate kept by a previous process, e.g. from the feed cache. A zero time is ignored.
+    */
+    void restore(double smoothed, double deviation);
+
+    unsigned retries() const { return retryCount; }
+    bool adaptive() const { return fixedDelay == 0; }
+
+    // Current estimate of the time to the first byte in seconds, 0 if nothing is observed yet
+    double smoothedFirstByte() const { return smoothed; }
+    double firstByteDeviation() const { return deviation; }
+
+private:
+    long fixedDelay;
+    unsigned retryCount;
+
+    double smoothed{0};
+    double deviation{0};
+
+    std::mt19937 random;
+    Now clock;
+};
+
+#endif // HEDGEPOLICY_H
@@ -0,0 +1,345 @@
+/**
+ * @file jsonstreamparser.cpp
+ * @brief This source file contains the definitions of the incremental (push) json parser class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "jsonstreamparser.h"
+
+#include <cctype>
+
+// Deepest nesting accepted by the parser
+#define max_nesting_depth 512
+
+JsonStreamParser::JsonStreamParser(JsonStreamHandler& handler)
+    : handler(handler)
+{
+
+}
+
+bool JsonStreamParser::fail(const std::string& message){
+    return fail(message, offset);
+}
+
+bool JsonStreamParser::fail(const std::string& message, std::size_t position){
+    // Keep the first error only
+    if(error.empty()){
+        error = message + " at offset " + std::to_string(position);
+        errorPosition = position;
+    }
+    return false;
+}
+
+void JsonStreamParser::afterValue(){
+    expect = containers.empty() ? Expect::Done : Expect::CommaOrEnd;
+}
+
+bool JsonStreamParser::literalType(std::string_view literal, JsonScalarType& type){
+    if(literal == "true" || literal == "false"){
+        type = JsonScalarType::Boolean;
+        return true;
+    }
+    if(literal == "null"){
+        type = JsonScalarType::Null;
+        return true;
+    }
+
+    // Validate the number grammar: -?int(.frac)?([eE][+-]?exp)?
+    type = JsonScalarType::Number;
+    std::size_t i = 0;
+    const std::size_t n = literal.size();
+
+    if(i < n && literal[i] == '-') i++;
+    if(i >= n || !std::isdigit(static_cast<unsigned char>(literal[i]))) return false;
+    if(literal[i] == '0') i++;
+    else while(i < n && std::isdigit(static_cast<unsigned char>(literal[i]))) i++;
+    if(i < n && literal[i] == '.'){
+        i++;
+        if(i >= n || !std::isdigit(static_cast<unsigned char>(literal[i]))) return false;
+        while(i < n && std::isdigit(static_cast<unsigned char>(literal[i]))) i++;
+    }
+    if(i < n && (literal[i] == 'e' || literal[i] == 'E')){
+        i++;
+        if(i < n && (literal[i] == '+' || literal[i] == '-')) i++;
+        if(i >= n || !std::isdigit(static_cast<unsigned char>(literal[i]))) return false;
+        while(i < n && std::isdigit(static_cast<unsigned char>(literal[i]))) i++;
+    }
+
+    return i == n;
+}
+
+bool JsonStreamParser::finishLiteral(){
+    lexer = Lexer::Structure;
+
+    JsonScalarType type;
+    if(!literalType(token, type)){
+        // A literal starting with a digit (after the sign) is reported as a number
+        std::size_t first = (!token.empty() && token[0] == '-') ? 1 : 0;
+        bool numeric = first < token.size() && std::isdigit(static_cast<unsigned char>(token[first]));
+        return fail((numeric ? "Invalid number '" : "Invalid literal '") + token + "'");
+    }
+
+    handler.value(token, type);
+    afterValue();
+
+    return true;
+}
+
+bool JsonStreamParser::structural(char c){
+    // Skip the whitespaces between the tokens
+    if(c == ' ' || c == '\n' || c == '\r' || c == '\t'){
+        return true;
+    }
+
+    switch(expect){
+        case Expect::Value:
+        case Expect::ValueOrEnd:
+            if(c == '{' || c == '['){
+                if(containers.size() >= max_nesting_depth){
+                    return fail("Nesting is too deep");
+                }
+                containers.push_back(c == '{');
+                if(c == '{'){
+                    handler.startObject();
+                    expect = Expect::KeyOrEnd;
+                }
+                else{
+                    handler.startArray();
+                    expect = Expect::ValueOrEnd;
+                }
+            }
+            else if(c == ']' && expect == Expect::ValueOrEnd){
+                containers.pop_back();
+                handler.endArray();
+                afterValue();
+            }
+            else if(c == '"'){
+                token.clear();
+                tokenPending = false;
+                tokenIsKey = false;
+                lexer = Lexer::String;
+            }
+            else if(c == '-' || std::isdigit(static_cast<unsigned char>(c)) || c == 't' || c == 'f' || c == 'n'){
+                token.assign(1, c);
+                lexer = Lexer::Literal;
+            }
+            else{
+                return fail(std::string("Unexpected character '") + c + "'");
+            }
+            return true;
+        case Expect::Key:
+        case Expect::KeyOrEnd:
+            if(c == '"'){
+                token.clear();
+                tokenPending = false;
+                tokenIsKey = true;
+                lexer = Lexer::String;
+            }
+            else if(c == '}' && expect == Expect::KeyOrEnd){
+                containers.pop_back();
+                handler.endObject();
+                afterValue();
+            }
+            else{
+                return fail("Expected an object member name");
+            }
+            return true;
+        case Expect::Colon:
+            if(c != ':'){
+                return fail("Expected ':'");
+            }
+            expect = Expect::Value;
+            return true;
+        case Expect::CommaOrEnd:
+            if(c == ','){
+                expect = containers.back() ? Expect::Key : Expect::Value;
+            }
+            else if(c == '}' && containers.back()){
+                containers.pop_back();
+                handler.endObject();
+                afterValue();
+            }
+            else if(c == ']' && !containers.back()){
+                containers.pop_back();
+                handler.endArray();
+                afterValue();
+            }
+            else{
+                return fail("Expected ',' or the end of the container");
+            }
+            return true;
+        case Expect::Done:
+            return fail("Unexpected data after the end of the document");
+    }
+
+    return true;
+}
+
+bool JsonStreamParser::feed(const char* data, std::size_t length){
+    // Refuse to continue after an error
+    if(!error.empty()){
+        return false;
+    }
+
+    // The whole chunk is validated first, as the structural parser validates a block before it indexes the block
+    std::size_t invalid = utf8.validate(reinterpret_cast<const unsigned char*>(data), length);
+    if(invalid != Utf8Validator::npos){
+        return fail("Invalid utf-8 sequence", offset + invalid);
+    }
+
+    const char* end = data + length;
+    const char* cursor = data;
+
+    while(cursor < end){
+        switch(lexer){
+            case Lexer::Structure:
+                if(!structural(*cursor)){
+                    return false;
+                }
+                cursor++;
+                offset++;
+                break;
+            case Lexer::String:
+                {
+                // Find the plain run of the string
+                const char* run = cursor;
+                while(cursor < end && *cursor != '"' && *cursor != '\\' && static_cast<unsigned char>(*cursor) >= 0x20){
+                    cursor++;
+                }
+                std::string_view text(run, static_cast<std::size_t>(cursor - run));
+                // A high surrogate escape must be followed by its low surrogate escape
+                if(escapes.waiting() && (!text.empty() || (cursor < end && *cursor != '\\'))){
+                    return fail("Lone surrogate in unicode escape");
+                }
+                offset += text.size();
+
+                // The whole string is in this chunk without escapes, pass it without copying
+                bool inPlace = !tokenPending && cursor < end && *cursor == '"';
+                if(!inPlace){
+                    token.append(text);
+                    tokenPending = true;
+                }
+
+                if(cursor == end){
+                    break;
+                }
+
+                if(*cursor == '\\'){
+                    lexer = Lexer::Escape;
+                }
+                else if(*cursor == '"'){
+                    lexer = Lexer::Structure;
+                    if(!inPlace){
+                        text = token;
+                    }
+                    tokenPending = false;
+                    escapes.reset();
+                    if(tokenIsKey){
+                        handler.key(text);
+                        expect = Expect::Colon;
+                    }
+                    else{
+                        handler.value(text, JsonScalarType::String);
+                        afterValue();
+                    }
+                }
+                else{
+                    return fail("Control character in string");
+                }
+                cursor++;
+                offset++;
+                break;
+                }
+            case Lexer::Escape:
+                if(escapes.waiting() && *cursor != 'u'){
+                    return fail("Lone surrogate in unicode escape");
+                }
+                switch(*cursor){
+                    case '"': token.push_back('"'); break;
+                    case '\\': token.push_back('\\'); break;
+                    case '/': token.push_back('/'); break;
+                    case 'b': token.push_back('\b'); break;
+                    case 'f': token.push_back('\f'); break;
+                    case 'n': token.push_back('\n'); break;
+                    case 'r': token.push_back('\r'); break;
+                    case 't': token.push_back('\t'); break;
+                    case 'u':
+                        unicodeDigits = 0;
+                        unicodeValue = 0;
+                        break;
+                    default:
+                        return fail("Invalid escape sequence");
+                }
+                lexer = (*cursor == 'u') ? Lexer::Unicode : Lexer::String;
+                cursor++;
+                offset++;
+                break;
+            case Lexer::Unicode:
+                {
+                char c = *cursor;
+                std::uint32_t digit;
+                if(c >= '0' && c <= '9') digit = static_cast<std::uint32_t>(c - '0');
+                else if(c >= 'a' && c <= 'f') digit = static_cast<std::uint32_t>(c - 'a' + 10);
+                else if(c >= 'A' && c <= 'F') digit = static_cast<std::uint32_t>(c - 'A' + 10);
+                else return fail("Invalid unicode escape");
+
+                unicodeValue = (unicodeValue << 4) | digit;
+                cursor++;
+                offset++;
+
+                if(++unicodeDigits < 4){
+                    break;
+                }
+
+                lexer = Lexer::String;
+
+                // Combine the surrogate pairs into a single code point
+                if(!escapes.append(token, unicodeValue)){
+                    return fail("Lone surrogate in unicode escape");
+                }
+                break;
+                }
+            case Lexer::Literal:
+                {
+                char c = *cursor;
+                if(std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '+' || c == '-'){
+                    token.push_back(c);
+                    cursor++;
+                    offset++;
+                }
+                else if(!finishLiteral()){
+                    return false;
+                }
+                break;
+                }
+        }
+    }
+
+    return true;
+}
+
+bool JsonStreamParser::finish(){
+    if(!error.empty()){
+        return false;
+    }
+
+    // A top level literal is terminated by the end of the document
+    if(lexer == Lexer::Literal && !finishLiteral()){
+        return false;
+    }
+
+    if(!utf8.complete()){
+        return fail("Truncated utf-8 sequence");
+    }
+
+    if(lexer != Lexer::Structure){
+        return fail("Unterminated string");
+    }
+
+    if(expect != Expect::Done){
+        return fail("Unexpected end of the document");
+    }
+
+    return true;
+}
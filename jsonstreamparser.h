@@ -0,0 +1,159 @@
+/**
+ * @file jsonstreamparser.h
+ * @brief This header file contains the declarations of the incremental (push) json parser class and its event handler
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef JSONSTREAMPARSER_H
+#define JSONSTREAMPARSER_H
+
+#include "utf8validation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @enum Types of the scalar json values reported to the handler
+*/
+enum class JsonScalarType{
+    String,
+    Number,
+    Boolean,
+    Null
+};
+
+/**
+ * @class JsonStreamHandler
+ * @brief This class represents the receiver of the events produced by JsonStreamParser. Default implementations ignore
+ * the events, so that a handler only overrides the events it is interested in.
+ */
+class JsonStreamHandler
+{
+public:
+    virtual ~JsonStreamHandler() = default;
+
+    virtual void startObject() {}
+    virtual void endObject() {}
+    virtual void startArray() {}
+    virtual void endArray() {}
+
+    /**
+     * @brief called for every member name of an object. The referenced text is only valid during the call, it points
+     * into the fed data whenever the name has no escapes and is not split between two chunks.
+    */
+    virtual void key(std::string_view name) { (void)name; }
+
+    /**
+     * @brief called for every scalar value. Strings are unescaped, other types are passed as their literal text.
+     * The referenced text is only valid during the call, it points into the fed data whenever possible.
+    */
+    virtual void value(std::string_view text, JsonScalarType type) { (void)text; (void)type; }
+};
+
+/**
+ * @class JsonStreamParser
+ * @brief This class represents a SAX style json parser that accepts the document in arbitrary sized chunks, e.g. directly
+ * from a curl write callback, and reports the structure to a JsonStreamHandler without building a document tree.
+ * Memory usage is bounded by the nesting depth and the longest single token of the document.
+ */
+class JsonStreamParser
+{
+public:
+    /**
+     * @brief JsonStreamParser class constructor
+     * @param handler receiver of the parsing events
+    */
+    explicit JsonStreamParser(JsonStreamHandler& handler);
+
+    /**
+     * @brief parses the next chunk of the document.
+     * @return false if the document is malformed, errorMessage() describes the problem.
+    */
+    bool feed(const char* data, std::size_t length);
+
+    /**
+     * @brief signals the end of the document.
+     * @return false if the document is malformed or incomplete.
+    */
+    bool finish();
+
+    /**
+     * @brief returns the description of the last parsing error.
+    */
+    const std::string& errorMessage() const { return error; }
+
+    /**
+     * @brief returns the offset in the document of the last parsing error.
+    */
+    std::size_t errorOffset() const { return errorPosition; }
+
+    /**
+     * @brief returns the number of bytes consumed so far.
+    */
+    std::size_t consumed() const { return offset; }
+
+    /**
+     * @brief classifies a literal (number, true, false or null) and validates the number grammar.
+     * @return false if the text is not a valid literal.
+    */
+    static bool literalType(std::string_view literal, JsonScalarType& type);
+
+private:
+    // Lexical state of the parser between two chunks
+    enum class Lexer{
+        Structure,
+        String,
+        Escape,
+        Unicode,
+        Literal
+    };
+
+    // Next expected structural element
+    enum class Expect{
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Colon,
+        CommaOrEnd,
+        Done
+    };
+
+    JsonStreamHandler& handler;
+
+    Lexer lexer{Lexer::Structure};
+    Expect expect{Expect::Value};
+
+    // true for an open object, false for an open array
+    std::vector<bool> containers;
+
+    // Text of the token being parsed if it spans several chunks or has escapes, plain tokens inside a chunk are passed
+    // to the handler without a copy
+    std::string token;
+    // True once the string being parsed is collected into 'token'
+    bool tokenPending{false};
+    bool tokenIsKey{false};
+
+    // Hex digits of a \uXXXX escape and the surrogate pairs of the escapes of the string
+    unsigned unicodeDigits{0};
+    std::uint32_t unicodeValue{0};
+    UnicodeEscapes escapes;
+    // The chunks are validated as they arrive, a sequence may be split between two chunks
+    Utf8Validator utf8;
+
+    std::size_t offset{0};
+    std::string error;
+    std::size_t errorPosition{0};
+
+    bool fail(const std::string& message);
+    bool fail(const std::string& message, std::size_t position);
+    bool structural(char c);
+    bool finishLiteral();
+    void afterValue();
+};
+
+#endif // JSONSTREAMPARSER_H
@@ -0,0 +1,583 @@
+/**
+ * @file jsonstructuralparser.cpp
+ * @brief This source file contains the definitions of the two stage json parser driven by a vectorized structural index
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "jsonstructuralparser.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UCII_SIMD_AVAILABLE 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Deepest nesting accepted by the parser
+#define max_nesting_depth 512
+
+// Bytes indexed before the index is walked, a multiple of the 64 byte block
+#define window_bytes (64 * 1024)
+
+namespace {
+
+// Bit masks of a 64 byte block, bit i stands for the byte i of the block
+struct BlockMasks{
+    std::uint64_t quote;
+    std::uint64_t backslash;
+    // { } [ ] : ,
+    std::uint64_t op;
+    // space, tab, line feed, carriage return
+    std::uint64_t whitespace;
+    // bytes below 0x20
+    std::uint64_t control;
+    // bytes above 0x7F
+    std::uint64_t nonAscii;
+};
+
+using ClassifyFunction = void (*)(const unsigned char*, BlockMasks&);
+
+// Portable classifier
+void classifyScalar(const unsigned char* bytes, BlockMasks& masks){
+    masks = BlockMasks{};
+
+    for(unsigned i = 0; i < 64; i++){
+        std::uint64_t bit = std::uint64_t(1) << i;
+        unsigned char c = bytes[i];
+
+        switch(c){
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': masks.op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+            default: break;
+        }
+        if(c < 0x20){
+            masks.control |= bit;
+        }
+        if(c >= 0x80){
+            masks.nonAscii |= bit;
+        }
+    }
+}
+
+#ifdef UCII_SIMD_AVAILABLE
+
+// 16 bytes at a time, '[' and ']' differ from '{' and '}' by the 0x20 bit only
+__attribute__((target("sse4.2")))
+void classifySse42(const unsigned char* bytes, BlockMasks& masks){
+    masks = BlockMasks{};
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lineFeed = _mm_set1_epi8('\n');
+    const __m128i carriageReturn = _mm_set1_epi8('\r');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+    for(unsigned i = 0; i < 4; i++){
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * 16));
+        __m128i folded = _mm_or_si128(chunk, caseBit);
+        unsigned shift = i * 16;
+
+        masks.quote |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+
+        __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+        masks.op |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(op))) << shift;
+
+        __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeed), _mm_cmpeq_epi8(chunk, carriageReturn)));
+        masks.whitespace |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(whitespace))) << shift;
+
+        // Unsigned chunk <= 0x1F
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk);
+        masks.control |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(control))) << shift;
+
+        masks.nonAscii |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(chunk))) << shift;
+    }
+}
+
+// 32 bytes at a time
+__attribute__((target("avx2")))
+void classifyAvx2(const unsigned char* bytes, BlockMasks& masks){
+    masks = BlockMasks{};
+
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lineFeed = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    const __m256i lastControl = _mm256_set1_epi8(0x1F);
+
+    for(unsigned i = 0; i < 2; i++){
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i * 32));
+        __m256i folded = _mm256_or_si256(chunk, caseBit);
+        unsigned shift = i * 32;
+
+        masks.quote |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)))) << shift;
+        masks.backslash |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)))) << shift;
+
+        __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon), _mm256_cmpeq_epi8(chunk, comma)));
+        masks.op |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(op))) << shift;
+
+        __m256i whitespace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lineFeed), _mm256_cmpeq_epi8(chunk, carriageReturn)));
+        masks.whitespace |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(whitespace))) << shift;
+
+        __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, lastControl), chunk);
+        masks.control |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(control))) << shift;
+
+        masks.nonAscii |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(chunk))) << shift;
+    }
+}
+
+#endif
+
+struct Implementation{
+    const char* name;
+    ClassifyFunction classify;
+};
+
+// Best classifier supported by the cpu
+Implementation bestImplementation(){
+#ifdef UCII_SIMD_AVAILABLE
+    if(__builtin_cpu_supports("avx2")){
+        return Implementation{"avx2", classifyAvx2};
+    }
+    if(__builtin_cpu_supports("sse4.2")){
+        return Implementation{"sse4.2", classifySse42};
+    }
+#endif
+    return Implementation{"scalar", classifyScalar};
+}
+
+// Classifier in use, selected once at startup
+Implementation selectedImplementation = bestImplementation();
+
+// Characters escaped by an odd run of backslashes, the carry tells whether the previous block ended with such a run
+std::uint64_t escapedCharacters(std::uint64_t backslash, std::uint64_t& carry){
+    const std::uint64_t evenBits = 0x5555555555555555ULL;
+    const std::uint64_t oddBits = ~evenBits;
+
+    std::uint64_t startEdges = backslash & ~(backslash << 1);
+    std::uint64_t evenStartMask = evenBits ^ carry;
+    std::uint64_t evenStarts = startEdges & evenStartMask;
+    std::uint64_t oddStarts = startEdges & ~evenStartMask;
+
+    std::uint64_t evenCarries = backslash + evenStarts;
+    std::uint64_t oddCarries = backslash + oddStarts;
+    bool endsOdd = oddCarries < backslash;
+    oddCarries |= carry;
+    carry = endsOdd ? 1 : 0;
+
+    std::uint64_t evenCarryEnds = evenCarries & ~backslash;
+    std::uint64_t oddCarryEnds = oddCarries & ~backslash;
+
+    return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+}
+
+// Bit i is the xor of the bits 0..i, turns the quote positions into the string regions
+std::uint64_t prefixXor(std::uint64_t bits){
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+unsigned trailingZeros(std::uint64_t bits){
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+bool isWhitespace(char c){
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isOperator(char c){
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+}
+
+JsonStructuralParser::JsonStructuralParser(JsonStreamHandler& handler)
+    : handler(handler)
+{
+
+}
+
+const char* JsonStructuralParser::implementation(){
+    return selectedImplementation.name;
+}
+
+bool JsonStructuralParser::useImplementation(const std::string& name){
+    if(name == "auto"){
+        selectedImplementation = bestImplementation();
+        return true;
+    }
+    if(name == "scalar"){
+        selectedImplementation = Implementation{"scalar", classifyScalar};
+        return true;
+    }
+#ifdef UCII_SIMD_AVAILABLE
+    if(name == "sse4.2" && __builtin_cpu_supports("sse4.2")){
+        selectedImplementation = Implementation{"sse4.2", classifySse42};
+        return true;
+    }
+    if(name == "avx2" && __builtin_cpu_supports("avx2")){
+        selectedImplementation = Implementation{"avx2", classifyAvx2};
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool JsonStructuralParser::fail(const std::string& message, std::size_t position){
+    // Keep the first error only
+    if(error.empty()){
+        error = message + " at offset " + std::to_string(position);
+        errorPosition = position;
+    }
+    return false;
+}
+
+void JsonStructuralParser::reset(const char* data, std::size_t length){
+    document = data;
+    documentLength = length;
+    block = BlockState{};
+    expect = Expect::Value;
+    containers.clear();
+    inString = false;
+    error.clear();
+    errorPosition = 0;
+
+    // Every byte of a window may be structural
+    if(structurals.size() < window_bytes){
+        structurals.resize(window_bytes);
+    }
+}
+
+bool JsonStructuralParser::indexWindow(std::size_t begin, std::size_t end){
+    const ClassifyFunction classify = selectedImplementation.classify;
+    std::uint32_t* output = structurals.data();
+    std::size_t count = 0;
+
+    alignas(64) unsigned char padded[64];
+    BlockMasks masks;
+
+    for(std::size_t offset = begin; offset < end; offset += 64){
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(document) + offset;
+        std::size_t length = std::min<std::size_t>(64, end - offset);
+
+        // The last block is padded by whitespaces, they are never structural
+        if(length < 64){
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, bytes, length);
+            bytes = padded;
+        }
+
+        classify(bytes, masks);
+
+        if(masks.nonAscii || !block.utf8.complete()){
+            std::size_t invalid = block.utf8.validate(bytes, length);
+            if(invalid != Utf8Validator::npos){
+                return fail("Invalid utf-8 sequence", offset + invalid);
+            }
+        }
+
+        // Quotes that are not escaped open or close a string, the region covers the opening quote but not the closing one
+        std::uint64_t quotes = masks.quote & ~escapedCharacters(masks.backslash, block.escaped);
+        std::uint64_t strings = prefixXor(quotes) ^ block.inString;
+        block.inString = static_cast<std::uint64_t>(static_cast<std::int64_t>(strings) >> 63);
+
+        if(masks.control & strings){
+            return fail("Control character in string", offset + trailingZeros(masks.control & strings));
+        }
+
+        // Literals start at a character that is neither an operator, a whitespace nor a part of a string
+        std::uint64_t scalars = ~(masks.op | masks.whitespace | quotes | strings);
+        std::uint64_t scalarStarts = scalars & ~((scalars << 1) | block.scalar);
+        block.scalar = scalars >> 63;
+
+        std::uint64_t structural = (masks.op & ~strings) | quotes | scalarStarts;
+
+        std::uint32_t base = static_cast<std::uint32_t>(offset - begin);
+        while(structural){
+            output[count++] = base + trailingZeros(structural);
+            structural &= structural - 1;
+        }
+    }
+
+    structuralCount = count;
+    return true;
+}
+
+void JsonStructuralParser::afterValue(){
+    expect = containers.empty() ? Expect::Done : Expect::CommaOrEnd;
+}
+
+bool JsonStructuralParser::unescape(std::string_view text, std::size_t position){
+    scratch.clear();
+    UnicodeEscapes escapes;
+
+    for(std::size_t i = 0; i < text.size(); i++){
+        // A high surrogate escape must be followed by its low surrogate escape
+        bool unicodeEscape = text[i] == '\\' && i + 1 < text.size() && text[i + 1] == 'u';
+        if(escapes.waiting() && !unicodeEscape){
+            return fail("Lone surrogate in unicode escape", position + i);
+        }
+
+        if(text[i] != '\\'){
+            scratch.push_back(text[i]);
+            continue;
+        }
+
+        if(++i >= text.size()){
+            return fail("Invalid escape sequence", position + i);
+        }
+
+        switch(text[i]){
+            case '"': scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/': scratch.push_back('/'); break;
+            case 'b': scratch.push_back('\b'); break;
+            case 'f': scratch.push_back('\f'); break;
+            case 'n': scratch.push_back('\n'); break;
+            case 'r': scratch.push_back('\r'); break;
+            case 't': scratch.push_back('\t'); break;
+            case 'u':
+                {
+                std::uint32_t value = 0;
+                for(unsigned digit = 0; digit < 4; digit++){
+                    if(++i >= text.size()){
+                        return fail("Invalid unicode escape", position + i);
+                    }
+                    char c = text[i];
+                    value <<= 4;
+                    if(c >= '0' && c <= '9') value |= static_cast<std::uint32_t>(c - '0');
+                    else if(c >= 'a' && c <= 'f') value |= static_cast<std::uint32_t>(c - 'a' + 10);
+                    else if(c >= 'A' && c <= 'F') value |= static_cast<std::uint32_t>(c - 'A' + 10);
+                    else return fail("Invalid unicode escape", position + i);
+                }
+
+                // Combine the surrogate pairs into a single code point, as JsonStreamParser does
+                if(!escapes.append(scratch, value)){
+                    return fail("Lone surrogate in unicode escape", position + i);
+                }
+                break;
+                }
+            default:
+                return fail("Invalid escape sequence", position + i);
+        }
+    }
+
+    if(escapes.waiting()){
+        return fail("Lone surrogate in unicode escape", position + text.size());
+    }
+
+    return true;
+}
+
+bool JsonStructuralParser::finishString(std::size_t closeQuote){
+    inString = false;
+
+    std::string_view text(document + openQuote + 1, closeQuote - openQuote - 1);
+
+    // Only the strings with escapes are copied
+    if(std::memchr(text.data(), '\\', text.size())){
+        if(!unescape(text, openQuote + 1)){
+            return false;
+        }
+        text = scratch;
+    }
+
+    if(stringIsKey){
+        handler.key(text);
+        expect = Expect::Colon;
+    }
+    else{
+        handler.value(text, JsonScalarType::String);
+        afterValue();
+    }
+
+    return true;
+}
+
+bool JsonStructuralParser::literal(std::size_t position){
+    // The literal ends at the next whitespace, operator or quote
+    std::size_t end = position;
+    while(end < documentLength && !isWhitespace(document[end]) && !isOperator(document[end]) && document[end] != '"'){
+        end++;
+    }
+
+    std::string_view text(document + position, end - position);
+    JsonScalarType type;
+    if(!JsonStreamParser::literalType(text, type)){
+        return fail("Invalid literal '" + std::string(text) + "'", position);
+    }
+
+    handler.value(text, type);
+    afterValue();
+
+    return true;
+}
+
+bool JsonStructuralParser::step(std::size_t position){
+    // Nothing inside a string is structural, the next position is its closing quote
+    if(inString){
+        return finishString(position);
+    }
+
+    char c = document[position];
+
+    switch(expect){
+        case Expect::Value:
+        case Expect::ValueOrEnd:
+            if(c == '{' || c == '['){
+                if(containers.size() >= max_nesting_depth){
+                    return fail("Nesting is too deep", position);
+                }
+                containers.push_back(c == '{');
+                if(c == '{'){
+                    handler.startObject();
+                    expect = Expect::KeyOrEnd;
+                }
+                else{
+                    handler.startArray();
+                    expect = Expect::ValueOrEnd;
+                }
+            }
+            else if(c == ']' && expect == Expect::ValueOrEnd){
+                containers.pop_back();
+                handler.endArray();
+                afterValue();
+            }
+            else if(c == '"'){
+                openQuote = position;
+                inString = true;
+                stringIsKey = false;
+            }
+            else if(isOperator(c)){
+                return fail(std::string("Unexpected character '") + c + "'", position);
+            }
+            else{
+                return literal(position);
+            }
+            return true;
+        case Expect::Key:
+        case Expect::KeyOrEnd:
+            if(c == '"'){
+                openQuote = position;
+                inString = true;
+                stringIsKey = true;
+            }
+            else if(c == '}' && expect == Expect::KeyOrEnd){
+                containers.pop_back();
+                handler.endObject();
+                afterValue();
+            }
+            else{
+                return fail("Expected an object member name", position);
+            }
+            return true;
+        case Expect::Colon:
+            if(c != ':'){
+                return fail("Expected ':'", position);
+            }
+            expect = Expect::Value;
+            return true;
+        case Expect::CommaOrEnd:
+            if(c == ','){
+                expect = containers.back() ? Expect::Key : Expect::Value;
+            }
+            else if(c == '}' && containers.back()){
+                containers.pop_back();
+                handler.endObject();
+                afterValue();
+            }
+            else if(c == ']' && !containers.back()){
+                containers.pop_back();
+                handler.endArray();
+                afterValue();
+            }
+            else{
+                return fail("Expected ',' or the end of the container", position);
+            }
+            return true;
+        case Expect::Done:
+            return fail("Unexpected data after the end of the document", position);
+    }
+
+    return true;
+}
+
+bool JsonStructuralParser::parse(const char* data, std::size_t length){
+    reset(data, length);
+
+    for(std::size_t begin = 0; begin < length; begin += window_bytes){
+        if(!indexWindow(begin, std::min<std::size_t>(length, begin + window_bytes))){
+            return false;
+        }
+
+        const std::uint32_t* positions = structurals.data();
+        for(std::size_t i = 0; i < structuralCount; i++){
+            if(!step(begin + positions[i])){
+                return false;
+            }
+        }
+    }
+
+    if(!block.utf8.complete()){
+        return fail("Truncated utf-8 sequence", length);
+    }
+    if(inString || block.inString){
+        return fail("Unterminated string", length);
+    }
+    if(expect != Expect::Done){
+        return fail("Unexpected end of the document", length);
+    }
+
+    return true;
+}
+
+std::size_t JsonStructuralParser::index(const char* data, std::size_t length){
+    reset(data, length);
+
+    std::size_t total = 0;
+    for(std::size_t begin = 0; begin < length; begin += window_bytes){
+        if(!indexWindow(begin, std::min<std::size_t>(length, begin + window_bytes))){
+            return 0;
+        }
+        total += structuralCount;
+    }
+
+    return block.inString ? 0 : total;
+}
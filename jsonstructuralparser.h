@@ -0,0 +1,132 @@
+/**
+ * @file jsonstructuralparser.h
+ * @brief This header file contains the declarations of the two stage json parser driven by a vectorized structural index
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef JSONSTRUCTURALPARSER_H
+#define JSONSTRUCTURALPARSER_H
+
+#include "jsonstreamparser.h"
+#include "utf8validation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class JsonStructuralParser
+ * @brief This class parses a complete json document in two stages and reports it to a JsonStreamHandler, the same events
+ * as JsonStreamParser. The first stage classifies 64 bytes at a time with vector compares (AVX2 or SSE4.2, selected once
+ * at runtime, a scalar loop otherwise) into bit masks of the quotes, backslashes, operators and whitespaces, resolves the
+ * escaped quotes and the string regions with bit arithmetic and collects the positions of the structural characters
+ * into an index. Blocks with non-ascii bytes are validated as utf-8. The second stage walks the index instead of the
+ * bytes: strings are passed as views into the document unless they have escapes, and the bytes inside the strings are
+ * never looked at one by one.
+ *
+ * The document is indexed and walked in windows, so the index stays small and in cache whatever the document size.
+ */
+class JsonStructuralParser
+{
+public:
+    /**
+     * @brief JsonStructuralParser class constructor
+     * @param handler receiver of the parsing events
+    */
+    explicit JsonStructuralParser(JsonStreamHandler& handler);
+
+    /**
+     * @brief parses the whole document.
+     * @return false if the document is malformed or not valid utf-8, errorMessage() describes the problem.
+    */
+    bool parse(const char* data, std::size_t length);
+
+    /**
+     * @brief runs the first stage only over the whole document, for the benchmarks.
+     * @return number of structural characters, 0 if the document is malformed.
+    */
+    std::size_t index(const char* data, std::size_t length);
+
+    /**
+     * @brief returns the description of the last parsing error.
+    */
+    const std::string& errorMessage() const { return error; }
+
+    /**
+     * @brief returns the offset in the document of the last parsing error.
+    */
+    std::size_t errorOffset() const { return errorPosition; }
+
+    /**
+     * @brief returns the name of the classifier in use ("avx2", "sse4.2" or "scalar").
+    */
+    static const char* implementation();
+
+    /**
+     * @brief selects the classifier by name, "auto" selects the best one supported by the cpu. Must not be called while
+     * parsing.
+     * @return false if the cpu does not support the classifier, the selection is not changed then.
+    */
+    static bool useImplementation(const std::string& name);
+
+private:
+    // Expected structural element, as in JsonStreamParser
+    enum class Expect{
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Colon,
+        CommaOrEnd,
+        Done
+    };
+
+    // State of the first stage carried from one 64 byte block to the next
+    struct BlockState{
+        // All ones if the previous block ended inside a string
+        std::uint64_t inString{0};
+        // 1 if the previous block ended with an odd run of backslashes
+        std::uint64_t escaped{0};
+        // 1 if the previous block ended with a scalar character
+        std::uint64_t scalar{0};
+        // Blocks with non-ascii bytes, and the blocks that continue a sequence, are validated by the shared validator
+        Utf8Validator utf8;
+    };
+
+    JsonStreamHandler& handler;
+
+    const char* document{nullptr};
+    std::size_t documentLength{0};
+
+    BlockState block;
+    // Positions of the structural characters of the current window, relative to the start of the window
+    std::vector<std::uint32_t> structurals;
+    std::size_t structuralCount{0};
+
+    Expect expect{Expect::Value};
+    // true for an open object, false for an open array
+    std::vector<bool> containers;
+    // Position of the opening quote of a string whose closing quote is not reached yet
+    std::size_t openQuote{0};
+    bool inString{false};
+    bool stringIsKey{false};
+
+    // Unescaped text of a string with escapes
+    std::string scratch;
+    std::string error;
+    std::size_t errorPosition{0};
+
+    void reset(const char* data, std::size_t length);
+    bool indexWindow(std::size_t begin, std::size_t end);
+    bool step(std::size_t position);
+    bool finishString(std::size_t closeQuote);
+    bool literal(std::size_t position);
+    bool unescape(std::string_view text, std::size_t position);
+    void afterValue();
+    bool fail(const std::string& message, std::size_t position);
+};
+
+#endif // JSONSTRUCTURALPARSER_H
@@ -58,6 +58,9 @@
  * sha256 value
  * 
  * Note2 : release_title and release_codename options can be used at the same time but release title will be used as first option to search.
+ * 
+ * Note3 : Releases are also found by the start of their title, codename, release name or release version, in any case (e.g. '18.04', 'bionic'), if only
+ * one release matches. Otherwise the matching releases are listed.
  */
 int main(int argc, const char* argv[]){
     try{
@@ -71,10 +74,46 @@ int main(int argc, const char* argv[]){
             ("help,h", "print usage message")
             ("listall,la", "return a list of all currently supported ubuntu releases")
             ("listcurr,lc", "return the current ubuntu lts version")
+            (latest_key, "return the newest version of the given ubuntu release (release_title or release_codename) or of the latest release with the sha256 of its disk1.img")
+            (supported_key, "return the supported ubuntu releases ordered by release version with their end of support date and newest version")
+            (history_key, "list the catalogs recorded in the history of the json file with their time, kind, number of changes and size in bytes")
+            (listversions_key, "return every version of all ubuntu releases with the sha256 of its disk1.img")
             (sha_key, "return the sha256 of the disk1.img item of a given ubuntu release")
             (release_title_key, boost::program_options::value<std::string>()->default_value(""), "Release title of the ubuntu version. (e.g. '14.10', '18.04', '24.04 LTS' etc.)")
             (release_codename_key, boost::program_options::value<std::string>()->default_value(""), "Release codename of the ubuntu version. (e.g. 'Focal Fossa', 'Impish Indri', 'Noble Numbat')")
-            (version_key, boost::program_options::value<std::string>()->default_value(""), "Release version of the ubuntu version");
+            (version_key, boost::program_options::value<std::string>()->default_value(""), "Release version of the ubuntu version")
+            (cache_dir_key, boost::program_options::value<std::string>()->default_value(""), "Directory to cache the downloaded json file. (default: $XDG_CACHE_HOME/ucii or ~/.cache/ucii)")
+            (max_age_key, boost::program_options::value<long>()->default_value(300), "Cached json file is used without any network access while it is younger than the given seconds, older one is revalidated")
+            (no_cache_key, "do not read or write the json file cache")
+            (build_snapshot_key, boost::program_options::value<std::string>(), "convert the json file into a binary snapshot file at the given path")
+            (batch_key, boost::program_options::value<std::string>(), "answer the sha256 queries read line by line from the given file or '-' for the standard input")
+            (serve_key, boost::program_options::value<std::string>(), "keep the catalog resident and answer the lookups over the given unix domain socket")
+            (refresh_key, boost::program_options::value<long>()->default_value(300), "Interval in seconds of the background catalog refresh of the server, 0 disables the refresh")
+            (watch_key, "poll the json file until interrupted and write the added and removed releases and versions and the changed sha256 as events")
+            (interval_key, boost::program_options::value<long>()->default_value(300), "Interval in seconds of the polls of 'watch'")
+            (connect_key, boost::program_options::value<std::string>(), "send the listall, listcurr or sha operation to the server listening on the given unix domain socket")
+            (verify_key, boost::program_options::value<std::string>(), "hash the given local disk1.img and compare it with the sha256 of the release and version given by release_title or release_codename and version")
+            (download_key, boost::program_options::value<std::string>(), "download the disk1.img of the release and version given by release_title or release_codename and version into the given file or directory and verify its sha256")
+            (complete_key, boost::program_options::value<std::string>(), "print the release titles, codenames, release names and release versions starting with the given text for shell completion, or the versions of the release given by release_title or release_codename")
+            (audit_key, boost::program_options::value<std::string>(), "check the local mirror at the given root directory against the items of the catalog (filtered by 'where' if given) and report the missing, corrupt and extra files")
+            (jobs_key, boost::program_options::value<unsigned>()->default_value(0), "Number of hashing threads of 'audit', 0 for one per core but at least 16 to keep the storage busy")
+            (connections_key, boost::program_options::value<unsigned>()->default_value(4), "Number of concurrent range requests of the download")
+            (chunk_size_key, boost::program_options::value<unsigned>()->default_value(8), "Size in MiB of each range request of the download")
+            (connect_timeout_key, boost::program_options::value<long>()->default_value(10), "Seconds allowed to establish a connection")
+            (low_speed_time_key, boost::program_options::value<long>()->default_value(30), "A transfer slower than 1 KiB/s for the given seconds is aborted")
+            (stats_key, "report the transfer timings, parse, catalog build, lookup and output durations and the peak memory usage to the standard error")
+            (stats_json_key, "same as 'stats' but report them as a single json line")
+            (where_key, boost::program_options::value<std::string>(), "list the items of all architectures matching the given conditions, e.g. 'arch=arm64,release>=20.04,item=*.img'. Fields: stream, arch, release, codename, title, version, item, ftype, path, sha256, size")
+            (select_key, boost::program_options::value<std::string>(), "Columns of the 'where' results, e.g. 'version,sha256,size' (default: title,arch,version,item,sha256, preceded by stream if several streams are given)")
+            (format_key, boost::program_options::value<std::string>()->default_value("text"), "Format of the results: 'text', 'jsonl' (a json object per line), 'csv' or 'nul' (tab separated fields, NUL terminated rows)")
+            (source_key, boost::program_options::value<std::string>()->default_value(default_source_url), "Url of the json file, e.g. a mirror or a local file:///path")
+            (mirrors_key, boost::program_options::value<std::string>(), "Comma separated urls of equivalent copies of the json file, requested in turn when the source fails or is slow to answer")
+            (hedge_key, boost::program_options::value<long>()->default_value(0), "Milliseconds to wait for the first byte of the json file before a hedged request is sent to the next mirror, 0 adapts it to the observed response times")
+            (retries_key, boost::program_options::value<unsigned>()->default_value(2), "Requests of the json file allowed in addition to one per source and mirror, retried after a jittered backoff")
+            (streams_key, boost::program_options::value<std::string>(), "Aggregate several simplestreams feeds into one catalog, fetched concurrently and tagged by stream, e.g. 'released,daily,minimal,minimal-daily' or name=url entries")
+            (as_of_key, boost::program_options::value<std::string>(), "Answer the operations from the catalog that was current at the given utc date (YYYY-MM-DD for the end of that day or YYYY-MM-DDTHH:MM:SSZ), rebuilt from the history recorded in the cache directory")
+            (snapshot_key, boost::program_options::value<std::string>()->default_value(""), "Answer the operations from the given binary snapshot instead of parsing the json file. Missing, corrupt or stale snapshot is rebuilt")
+            (parser_key, boost::program_options::value<std::string>()->default_value("stream"), "Json parser to be used. 'stream' parses the json file while it is being downloaded, 'simd' parses it after the download from a structural index built with simd instructions, 'jsoncpp' parses it after the download");
 
         boost::program_options::variables_map variableMap;
 
@@ -83,35 +122,92 @@ int main(int argc, const char* argv[]){
 
         // Instantiate the parser
         UCIIParser ucii;
+        ucii.configure(variableMap);
 
         // Check cli inputs
         if(variableMap.count("help")){
             // return available cli options
             std::cout << descriptions << std::endl;
         }
+        else if(variableMap.count(connect_key)){
+            // forward the operation to a running server
+            return ucii.requestOperation(UCIIParser::OperationType::ClientRequest, variableMap);
+        }
+        else if(variableMap.count(serve_key)){
+            // serve the lookups until interrupted
+            return ucii.requestOperation(UCIIParser::OperationType::Serve, variableMap);
+        }
+        else if(variableMap.count(watch_key)){
+            // write the changes of the catalog until interrupted
+            return ucii.requestOperation(UCIIParser::OperationType::Watch, variableMap);
+        }
+        else if(variableMap.count(verify_key)){
+            // verify a local image against the catalog
+            return ucii.requestOperation(UCIIParser::OperationType::Verify, variableMap);
+        }
+        else if(variableMap.count(complete_key)){
+            // complete a release name or a version
+            return ucii.requestOperation(UCIIParser::OperationType::Complete, variableMap);
+        }
+        else if(variableMap.count(audit_key)){
+            // check a local mirror against the catalog
+            return ucii.requestOperation(UCIIParser::OperationType::Audit, variableMap);
+        }
+        else if(variableMap.count(download_key)){
+            // download and verify an image
+            return ucii.requestOperation(UCIIParser::OperationType::Download, variableMap);
+        }
         else if(variableMap.count("listall")){
             // return a list of all currently supported ubuntu releases
-            ucii.requestOperation(UCIIParser::OperationType::AllSupportedUbuntuRelases);
+            return ucii.requestOperation(UCIIParser::OperationType::AllSupportedUbuntuRelases);
+        }
+        else if(variableMap.count(where_key) || variableMap.count(select_key)){
+            // filter the items of all architectures
+            return ucii.requestOperation(UCIIParser::OperationType::Query, variableMap);
+        }
+        else if(variableMap.count(latest_key)){
+            // return the newest version of a release
+            return ucii.requestOperation(UCIIParser::OperationType::Latest, variableMap);
+        }
+        else if(variableMap.count(supported_key)){
+            // return the supported ubuntu releases
+            return ucii.requestOperation(UCIIParser::OperationType::Supported, variableMap);
+        }
+        else if(variableMap.count(history_key)){
+            // list the recorded catalogs
+            return ucii.requestOperation(UCIIParser::OperationType::History, variableMap);
+        }
+        else if(variableMap.count(listversions_key)){
+            // return every version of all ubuntu releases
+            return ucii.requestOperation(UCIIParser::OperationType::AllVersions);
         }
         else if(variableMap.count("listcurr")){
             // return the current ubuntu lts version
-            ucii.requestOperation(UCIIParser::OperationType::CurrentUbuntuLTSVersion);
+            return ucii.requestOperation(UCIIParser::OperationType::CurrentUbuntuLTSVersion);
         }
         else if(variableMap.count(sha_key)){
             if(!variableMap[release_title_key].as<std::string>().empty() || !variableMap[release_codename_key].as<std::string>().empty()){
                 if(!variableMap[version_key].as<std::string>().empty()){
                     // return the sha256 of the disk1.img item of a given ubuntu release
-                    ucii.requestOperation(UCIIParser::OperationType::FetchSha256, variableMap);
+                    return ucii.requestOperation(UCIIParser::OperationType::FetchSha256, variableMap);
                 }
                 else{
                     // Find available version numbers for the given ubuntu release
-                    ucii.requestOperation(UCIIParser::OperationType::ListVersions, variableMap);
+                    return ucii.requestOperation(UCIIParser::OperationType::ListVersions, variableMap);
                 }
             }
             else{
                 std::cout << "Please specify the release tile or release codename of the ubuntu release." << std::endl;
             }
         }
+        else if(variableMap.count(batch_key)){
+            // answer many sha256 queries in one pass
+            return ucii.requestOperation(UCIIParser::OperationType::BatchSha256, variableMap);
+        }
+        else if(variableMap.count(build_snapshot_key)){
+            // convert the json file into a binary snapshot
+            return ucii.requestOperation(UCIIParser::OperationType::BuildSnapshot, variableMap);
+        }
         else{
             std::cout << "No command found." << std::endl;
             std::cout << descriptions << std::endl;
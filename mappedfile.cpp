@@ -0,0 +1,141 @@
+/**
+ * @file mappedfile.cpp
+ * @brief This source file contains the definitions of the read-only memory mapped file class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "mappedfile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mappedData(std::exchange(other.mappedData, nullptr)),
+      mappedSize(std::exchange(other.mappedSize, 0)),
+      opened(std::exchange(other.opened, false)),
+      error(std::move(other.error))
+{
+
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept{
+    if(this != &other){
+        close();
+        mappedData = std::exchange(other.mappedData, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0);
+        opened = std::exchange(other.opened, false);
+        error = std::move(other.error);
+    }
+    return *this;
+}
+
+void MappedFile::adviseSequential() const{
+#if !defined(_WIN32) && defined(POSIX_MADV_SEQUENTIAL)
+    if(mappedData){
+        posix_madvise(mappedData, mappedSize, POSIX_MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+bool MappedFile::open(const std::string& path){
+    close();
+    error.clear();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE){
+        error = "Could not open " + path;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize)){
+        CloseHandle(file);
+        error = "Could not read the size of " + path;
+        return false;
+    }
+
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+    opened = true;
+
+    if(mappedSize > 0){
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping){
+            mappedData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+
+    if(mappedSize > 0 && !mappedData){
+        opened = false;
+        mappedSize = 0;
+        error = "Could not map " + path;
+        return false;
+    }
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor < 0){
+        error = "Could not open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat status;
+    if(fstat(descriptor, &status) != 0){
+        error = "Could not read the size of " + path + ": " + std::strerror(errno);
+        ::close(descriptor);
+        return false;
+    }
+
+    mappedSize = static_cast<std::size_t>(status.st_size);
+    opened = true;
+
+    if(mappedSize > 0){
+        void* address = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if(address == MAP_FAILED){
+            error = "Could not map " + path + ": " + std::strerror(errno);
+            ::close(descriptor);
+            opened = false;
+            mappedSize = 0;
+            return false;
+        }
+
+        mappedData = address;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+#endif
+
+    return true;
+}
+
+void MappedFile::close(){
+    if(mappedData){
+#ifdef _WIN32
+        UnmapViewOfFile(mappedData);
+#else
+        munmap(mappedData, mappedSize);
+#endif
+    }
+
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file mappedfile.h
+ * @brief This header file contains the declarations of the read-only memory mapped file class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief This class maps a whole file into the memory as read-only and unmaps it on destruction
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief maps the given file, a previously mapped file is unmapped first.
+     * @return false if the file can not be opened or mapped, errorMessage() describes the problem.
+    */
+    bool open(const std::string& path);
+
+    /**
+     * @brief unmaps the file.
+    */
+    void close();
+
+    /**
+     * @brief tells the kernel that the mapping will be read once from the beginning to the end, so that it reads ahead
+     * aggressively. Has no effect where the hint is not supported.
+    */
+    void adviseSequential() const;
+
+    bool isOpen() const { return mappedData != nullptr || (opened && mappedSize == 0); }
+    const char* data() const { return static_cast<const char*>(mappedData); }
+    std::size_t size() const { return mappedSize; }
+    const std::string& errorMessage() const { return error; }
+
+private:
+    void* mappedData{nullptr};
+    std::size_t mappedSize{0};
+    // Empty files can not be mapped but they are valid
+    bool opened{false};
+    std::string error;
+};
+
+#endif // MAPPEDFILE_H
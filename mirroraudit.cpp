@@ -0,0 +1,199 @@
+/**
+ * @file mirroraudit.cpp
+ * @brief This source file contains the definitions of the audit of a local image mirror against the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "mirroraudit.h"
+#include "filehasher.h"
+#include "mappedfile.h"
+#include "sha256.h"
+#include "workstealingpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+
+// Files up to this size are hashed from a mapping by the worker, larger ones by a FileHasher
+#define mapped_hash_limit (16ull * 1024 * 1024)
+// Reads kept in flight by default, a worker hashing a mapped file waits for the storage on its page faults
+#define audit_io_depth 16u
+
+MirrorAudit::MirrorAudit(std::string root, unsigned workers)
+    : root(std::move(root)),
+      workers(workers != 0 ? workers : std::max(audit_io_depth, WorkStealingPool().workerCount()))
+{
+}
+
+void MirrorAudit::expect(const std::string& path, const std::string& sha256, std::uint64_t size){
+    Entry entry;
+    entry.path = path;
+    entry.expected = sha256;
+    entry.size = size;
+    entries.push_back(std::move(entry));
+}
+
+void MirrorAudit::ignore(const std::string& path){
+    ignoredPaths.push_back(path);
+}
+
+const char* MirrorAudit::resultName(Result result){
+    switch(result){
+        case Result::Ok: return "OK";
+        case Result::Missing: return "MISSING";
+        case Result::Corrupt: return "CORRUPT";
+        case Result::Unreadable: return "UNREADABLE";
+        case Result::Extra: return "EXTRA";
+    }
+    return "";
+}
+
+std::size_t MirrorAudit::run(const std::function<void(const Entry&)>& consumer){
+    auto start = std::chrono::steady_clock::now();
+
+    // Several versions may share a file
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs){ return lhs.path < rhs.path; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs){ return lhs.path == rhs.path; }), entries.end());
+
+    // Largest files first, so that the last ones to finish are small
+    std::vector<std::size_t> order(entries.size());
+    for(std::size_t index = 0; index < order.size(); index++){
+        order[index] = index;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs){ return entries[lhs].size > entries[rhs].size; });
+
+    // The tree is walked while the files are being hashed
+    std::vector<Entry> extra;
+    std::thread walker(&MirrorAudit::findExtra, this, std::ref(extra));
+
+    std::atomic<std::size_t> hashedFiles{0};
+    std::atomic<std::uint64_t> hashedBytes{0};
+
+    WorkStealingPool pool(workers);
+    pool.run(order.size(), [&](std::size_t index, unsigned){
+        std::uint64_t fileBytes = 0;
+        check(entries[order[index]], fileBytes);
+        if(fileBytes > 0){
+            hashedFiles.fetch_add(1, std::memory_order_relaxed);
+            hashedBytes.fetch_add(fileBytes, std::memory_order_relaxed);
+        }
+    });
+
+    walker.join();
+
+    hashed = hashedFiles.load();
+    bytes = hashedBytes.load();
+    steals = pool.stealCount();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t problems = 0;
+    for(const Entry& entry : entries){
+        problems += entry.result != Result::Ok;
+        consumer(entry);
+    }
+    for(const Entry& entry : extra){
+        problems++;
+        consumer(entry);
+    }
+
+    return problems;
+}
+
+void MirrorAudit::check(Entry& entry, std::uint64_t& hashedBytes) const{
+    std::filesystem::path filePath = std::filesystem::path(root) / entry.path;
+
+    std::error_code errorCode;
+    std::uint64_t fileSize = std::filesystem::file_size(filePath, errorCode);
+    if(errorCode){
+        if(errorCode == std::errc::no_such_file_or_directory){
+            entry.result = Result::Missing;
+        }
+        else{
+            entry.result = Result::Unreadable;
+            entry.detail = errorCode.message();
+        }
+        return;
+    }
+
+    // A file of a different size is corrupt without reading it
+    if(entry.size != 0 && fileSize != entry.size){
+        entry.result = Result::Corrupt;
+        entry.detail = "size " + std::to_string(fileSize) + " instead of " + std::to_string(entry.size);
+        return;
+    }
+
+    if(entry.expected.empty()){
+        return;
+    }
+
+    std::uint8_t digest[32];
+    if(fileSize <= mapped_hash_limit){
+        MappedFile file;
+        if(!file.open(filePath.string())){
+            entry.result = Result::Unreadable;
+            entry.detail = file.errorMessage();
+            return;
+        }
+        file.adviseSequential();
+
+        Sha256 hasher;
+        hasher.update(file.data(), file.size());
+        hasher.finish(digest);
+        hashedBytes = file.size();
+    }
+    else{
+        FileHasher hasher;
+        if(!hasher.hash(filePath.string(), digest)){
+            entry.result = Result::Unreadable;
+            entry.detail = hasher.errorMessage();
+            return;
+        }
+        hashedBytes = hasher.bytesHashed();
+    }
+
+    entry.computed = Sha256::toHex(digest);
+    if(entry.computed != entry.expected){
+        entry.result = Result::Corrupt;
+        entry.detail = "sha256";
+    }
+}
+
+void MirrorAudit::findExtra(std::vector<Entry>& extra) const{
+    std::unordered_set<std::string_view> expectedPaths;
+    expectedPaths.reserve(entries.size() + ignoredPaths.size());
+    for(const Entry& entry : entries){
+        expectedPaths.insert(entry.path);
+    }
+    for(const std::string& path : ignoredPaths){
+        expectedPaths.insert(path);
+    }
+
+    std::error_code errorCode;
+    std::filesystem::path rootPath(root);
+    std::filesystem::recursive_directory_iterator iterator(rootPath, std::filesystem::directory_options::skip_permission_denied, errorCode);
+
+    for(; !errorCode && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(errorCode)){
+        std::string relativePath = iterator->path().lexically_relative(rootPath).generic_string();
+
+        // The simplestreams metadata of the mirror is not an item
+        if(iterator.depth() == 0 && iterator->is_directory(errorCode) && relativePath == "streams"){
+            iterator.disable_recursion_pending();
+            continue;
+        }
+
+        if(iterator->is_regular_file(errorCode) && !expectedPaths.count(relativePath)){
+            Entry entry;
+            entry.path = std::move(relativePath);
+            entry.result = Result::Extra;
+            extra.push_back(std::move(entry));
+        }
+    }
+
+    std::sort(extra.begin(), extra.end(), [](const Entry& lhs, const Entry& rhs){ return lhs.path < rhs.path; });
+}
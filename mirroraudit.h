@@ -0,0 +1,103 @@
+/**
+ * @file mirroraudit.h
+ * @brief This header file contains the declarations of the audit of a local image mirror against the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef MIRRORAUDIT_H
+#define MIRRORAUDIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class MirrorAudit
+ * @brief This class checks the files of a local mirror against the items of the catalog. Every expected file is looked
+ * up under the root of the mirror, compared by its size and hashed, the files are spread over a work-stealing pool
+ * largest first. Small files are hashed from a memory mapping by the worker itself, large ones by a double buffered
+ * FileHasher whose reader thread keeps the next block coming while the worker hashes (sha256 is sequential, a single
+ * file can not be hashed by several workers). The tree of the root is walked for the extra files meanwhile.
+ */
+class MirrorAudit
+{
+public:
+    enum class Result{
+        Ok,
+        Missing,
+        // The size or the sha256 of the file does not match the catalog
+        Corrupt,
+        // The file exists but can not be read
+        Unreadable,
+        // The file is not an item of the catalog
+        Extra
+    };
+
+    struct Entry{
+        // Path relative to the root of the mirror
+        std::string path;
+        std::string expected;
+        std::uint64_t size{0};
+        Result result{Result::Ok};
+        std::string computed;
+        // Reason of a corrupt or unreadable result
+        std::string detail;
+    };
+
+    /**
+     * @brief MirrorAudit class constructor
+     * @param root root directory of the mirror, the catalog paths are relative to it
+     * @param workers number of hashing threads, 0 for one per core but at least 16. The audit is bound by the storage
+     * rather than the cpu: a worker is blocked by the page faults of the file it hashes, so more workers than cores keep
+     * enough reads in flight for the storage (and a network filesystem) to reach its throughput
+    */
+    MirrorAudit(std::string root, unsigned workers = 0);
+
+    /**
+     * @brief adds an item of the catalog, the same path given twice is checked once.
+     * @param sha256 expected digest, an item without one is only checked by its size
+     * @param size expected size in bytes, 0 if unknown
+    */
+    void expect(const std::string& path, const std::string& sha256, std::uint64_t size);
+
+    /**
+     * @brief adds an item of the catalog that is not checked (e.g. filtered out), it is not reported as an extra file
+     * if it exists.
+    */
+    void ignore(const std::string& path);
+
+    /**
+     * @brief checks every expected file and looks for the extra files, then passes the results to the consumer, the
+     * expected files in path order followed by the extra files.
+     * @return number of files that are not Ok.
+    */
+    std::size_t run(const std::function<void(const Entry&)>& consumer);
+
+    static const char* resultName(Result result);
+
+    // Statistics of the last run
+    std::size_t filesHashed() const { return hashed; }
+    std::uint64_t bytesHashed() const { return bytes; }
+    double elapsedSeconds() const { return seconds; }
+    unsigned workerCount() const { return workers; }
+    std::size_t stealCount() const { return steals; }
+
+private:
+    std::string root;
+    unsigned workers;
+    std::vector<Entry> entries;
+    std::vector<std::string> ignoredPaths;
+
+    std::size_t hashed{0};
+    std::uint64_t bytes{0};
+    double seconds{0};
+    std::size_t steals{0};
+
+    void check(Entry& entry, std::uint64_t& hashedBytes) const;
+    void findExtra(std::vector<Entry>& extra) const;
+};
+
+#endif // MIRRORAUDIT_H
@@ -0,0 +1,209 @@
+/**
+ * @file outputwriter.cpp
+ * @brief This source file contains the definitions of the buffered output writer of the operation results
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "outputwriter.h"
+
+OutputWriter::OutputWriter(std::ostream& out, std::size_t bufferSize)
+    : out(out), bufferSize(bufferSize)
+{
+    buffer.reserve(bufferSize);
+}
+
+OutputWriter::~OutputWriter(){
+    flush();
+}
+
+bool OutputWriter::parseFormat(const std::string& name, OutputFormat& format){
+    if(name == "text"){
+        format = OutputFormat::Text;
+    }
+    else if(name == "jsonl"){
+        format = OutputFormat::JsonLines;
+    }
+    else if(name == "csv"){
+        format = OutputFormat::Csv;
+    }
+    else if(name == "nul"){
+        format = OutputFormat::Nul;
+    }
+    else{
+        return false;
+    }
+
+    return true;
+}
+
+void OutputWriter::append(std::string_view data){
+    buffer.append(data.data(), data.size());
+}
+
+void OutputWriter::drain(){
+    if(buffer.size() >= bufferSize){
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void OutputWriter::appendJsonString(std::string_view value){
+    static const char hexDigits[] = "0123456789abcdef";
+
+    buffer.push_back('"');
+
+    // Copy the plain runs at once, escape the quotes, backslashes and control characters
+    std::size_t runStart = 0;
+    for(std::size_t i = 0; i < value.size(); i++){
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if(c >= 0x20 && c != '"' && c != '\\'){
+            continue;
+        }
+
+        buffer.append(value.data() + runStart, i - runStart);
+        runStart = i + 1;
+
+        switch(c){
+            case '"': buffer.append("\\\""); break;
+            case '\\': buffer.append("\\\\"); break;
+            case '\n': buffer.append("\\n"); break;
+            case '\r': buffer.append("\\r"); break;
+            case '\t': buffer.append("\\t"); break;
+            default:
+                buffer.append("\\u00");
+                buffer.push_back(hexDigits[c >> 4]);
+                buffer.push_back(hexDigits[c & 0xF]);
+                break;
+        }
+    }
+    buffer.append(value.data() + runStart, value.size() - runStart);
+
+    buffer.push_back('"');
+}
+
+void OutputWriter::appendCsvField(std::string_view value){
+    // Quote the fields containing a separator, a quote or a line break, quotes are doubled
+    if(value.find_first_of(",\"\r\n") == std::string_view::npos){
+        append(value);
+        return;
+    }
+
+    buffer.push_back('"');
+    for(char c : value){
+        if(c == '"'){
+            buffer.push_back('"');
+        }
+        buffer.push_back(c);
+    }
+    buffer.push_back('"');
+}
+
+void OutputWriter::columns(std::initializer_list<std::string_view> names){
+    columnNames.assign(names.begin(), names.end());
+    writeHeader();
+}
+
+void OutputWriter::columns(const std::vector<std::string>& names){
+    columnNames = names;
+    writeHeader();
+}
+
+void OutputWriter::writeHeader(){
+    if(format == OutputFormat::Csv){
+        bool first = true;
+        for(const std::string& name : columnNames){
+            if(!first){
+                buffer.push_back(',');
+            }
+            appendCsvField(name);
+            first = false;
+        }
+        buffer.push_back('\n');
+        drain();
+    }
+}
+
+void OutputWriter::row(std::initializer_list<std::string_view> values){
+    writeRow(values);
+}
+
+void OutputWriter::row(const std::vector<std::string_view>& values){
+    writeRow(values);
+}
+
+template<typename Values>
+void OutputWriter::writeRow(const Values& values){
+    std::size_t column = 0;
+    bool first = true;
+
+    switch(format){
+        case OutputFormat::Text:
+            for(std::string_view value : values){
+                if(value.empty()){
+                    continue;
+                }
+                if(!first){
+                    buffer.push_back(' ');
+                }
+                append(value);
+                first = false;
+            }
+            buffer.push_back('\n');
+            break;
+        case OutputFormat::JsonLines:
+            buffer.push_back('{');
+            for(std::string_view value : values){
+                if(!value.empty() && column < columnNames.size()){
+                    if(!first){
+                        buffer.push_back(',');
+                    }
+                    appendJsonString(columnNames[column]);
+                    buffer.push_back(':');
+                    appendJsonString(value);
+                    first = false;
+                }
+                column++;
+            }
+            buffer.append("}\n");
+            break;
+        case OutputFormat::Csv:
+            for(std::string_view value : values){
+                if(!first){
+                    buffer.push_back(',');
+                }
+                appendCsvField(value);
+                first = false;
+            }
+            buffer.push_back('\n');
+            break;
+        case OutputFormat::Nul:
+            for(std::string_view value : values){
+                if(!first){
+                    buffer.push_back('\t');
+                }
+                append(value);
+                first = false;
+            }
+            buffer.push_back('\0');
+            break;
+    }
+
+    drain();
+}
+
+OutputWriter& OutputWriter::text(std::string_view prose){
+    if(format == OutputFormat::Text){
+        append(prose);
+        drain();
+    }
+    return *this;
+}
+
+void OutputWriter::flush(){
+    if(!buffer.empty()){
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    out.flush();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file outputwriter.h
+ * @brief This header file contains the declarations of the buffered output writer of the operation results
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @enum Formats of the operation results
+*/
+enum class OutputFormat{
+    // Human readable text, the fields of a row are separated by a space
+    Text,
+    // One json object per row, empty fields are left out
+    JsonLines,
+    // Comma separated values with a header row
+    Csv,
+    // Fields separated by a tab and every row terminated by a NUL character, for xargs -0 and the like
+    Nul
+};
+
+/**
+ * @class OutputWriter
+ * @brief This class writes the results of the operations as rows of named columns in the selected format. Everything
+ * is appended to a large buffer that is written out when it is full and flushed once at the end, so that listing a
+ * large catalog costs neither a flush nor a temporary string per line. Human readable prose is written in the text
+ * format only.
+ */
+class OutputWriter
+{
+public:
+    /**
+     * @brief OutputWriter class constructor
+     * @param out destination of the output
+     * @param bufferSize amount of output collected before it is written to the destination
+    */
+    explicit OutputWriter(std::ostream& out, std::size_t bufferSize = 256 * 1024);
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * @brief parses the name of a format ('text', 'jsonl', 'csv' or 'nul').
+     * @return false if the name is unknown.
+    */
+    static bool parseFormat(const std::string& name, OutputFormat& format);
+
+    void setFormat(OutputFormat format) { this->format = format; }
+    OutputFormat outputFormat() const { return format; }
+    // True for the machine readable formats, prose is not written in them
+    bool structured() const { return format != OutputFormat::Text; }
+
+    /**
+     * @brief starts a table of the given columns, the csv format writes the header row.
+    */
+    void columns(std::initializer_list<std::string_view> names);
+    void columns(const std::vector<std::string>& names);
+
+    /**
+     * @brief writes a row, the values are given in the order of the columns.
+    */
+    void row(std::initializer_list<std::string_view> values);
+    void row(const std::vector<std::string_view>& values);
+
+    /**
+     * @brief writes the given prose as it is in the text format, ignored in the other formats.
+    */
+    OutputWriter& text(std::string_view prose);
+
+    /**
+     * @brief writes the buffered output to the destination and flushes it.
+    */
+    void flush();
+
+private:
+    std::ostream& out;
+    std::size_t bufferSize;
+    std::string buffer;
+
+    OutputFormat format{OutputFormat::Text};
+    std::vector<std::string> columnNames;
+
+    void append(std::string_view data);
+    void appendJsonString(std::string_view value);
+    void appendCsvField(std::string_view value);
+    void writeHeader();
+    template<typename Values>
+    void writeRow(const Values& values);
+    // Writes the buffer out once it exceeds its size
+    void drain();
+};
+
+#endif // OUTPUTWRITER_H
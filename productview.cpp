@@ -0,0 +1,248 @@
+/**
+ * @file productview.cpp
+ * @brief This source file contains the definitions of the product view builders
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "productview.h"
+
+#include <algorithm>
+#include <charconv>
+
+ProductViewBuilder::ProductViewBuilder(FeedView& view, std::string arch, ViewFields fields)
+    : view(view), arch(arch), fields(fields)
+{
+
+}
+
+void ProductViewBuilder::startObject(){
+    // Find the context of the new object from its parent and its member name
+    Context context = Context::Ignored;
+
+    if(contexts.empty()){
+        context = Context::Root;
+    }
+    else{
+        switch(contexts.back()){
+            case Context::Root:
+                if(lastKey == "products"){
+                    context = Context::Products;
+                }
+                break;
+            case Context::Products:
+                context = Context::Product;
+                product = ProductView();
+                product.id = lastKey;
+                break;
+            case Context::Product:
+                // Versions are not needed to list the releases
+                if(lastKey == "versions" && fields != ViewFields::Titles){
+                    context = Context::Versions;
+                }
+                break;
+            case Context::Versions:
+                context = Context::Version;
+                product.versions.push_back(VersionView{lastKey, "", "", 0, {}});
+                break;
+            case Context::Version:
+                if(lastKey == "items"){
+                    context = Context::Items;
+                }
+                break;
+            case Context::Items:
+                context = Context::Item;
+                itemName = lastKey;
+                if(fields == ViewFields::Items){
+                    product.versions.back().items.push_back(ItemView{itemName, "", "", "", 0});
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    contexts.push_back(context);
+}
+
+void ProductViewBuilder::endObject(){
+    // Keep the product only if it is in the requested architecture
+    if(contexts.back() == Context::Product && (product.arch == arch || fields == ViewFields::Items)){
+        view.products.push_back(std::move(product));
+    }
+
+    contexts.pop_back();
+}
+
+void ProductViewBuilder::startArray(){
+    contexts.push_back(Context::Ignored);
+}
+
+void ProductViewBuilder::endArray(){
+    contexts.pop_back();
+}
+
+void ProductViewBuilder::key(std::string_view name){
+    lastKey = name;
+}
+
+void ProductViewBuilder::value(std::string_view text, JsonScalarType type){
+    if(contexts.empty()){
+        return;
+    }
+
+    // Sizes of the items are the only numbers kept
+    if(type == JsonScalarType::Number){
+        if(contexts.back() == Context::Item && lastKey == "size"){
+            if(itemName == "disk1.img"){
+                std::from_chars(text.data(), text.data() + text.size(), product.versions.back().size);
+            }
+            if(fields == ViewFields::Items){
+                std::from_chars(text.data(), text.data() + text.size(), product.versions.back().items.back().size);
+            }
+        }
+        return;
+    }
+    if(type == JsonScalarType::Boolean){
+        if(contexts.back() == Context::Product && lastKey == "supported"){
+            product.supported = text == "true";
+        }
+        return;
+    }
+    if(type != JsonScalarType::String){
+        return;
+    }
+
+    switch(contexts.back()){
+        case Context::Root:
+            if(lastKey == "updated"){
+                view.updated = text;
+            }
+            break;
+        case Context::Product:
+            if(lastKey == "arch"){
+                product.arch = text;
+            }
+            else if(lastKey == "release_title"){
+                product.releaseTitle = text;
+            }
+            else if(lastKey == "release_codename"){
+                product.releaseCodename = text;
+            }
+            else if(lastKey == "release"){
+                product.release = text;
+            }
+            else if(lastKey == "version"){
+                product.releaseVersion = text;
+            }
+            else if(lastKey == "support_eol"){
+                product.supportEol = text;
+            }
+            break;
+        case Context::Item:
+            if(fields == ViewFields::Items){
+                ItemView& item = product.versions.back().items.back();
+                if(lastKey == "sha256"){
+                    item.sha256 = text;
+                }
+                else if(lastKey == "path"){
+                    item.path = text;
+                }
+                else if(lastKey == "ftype"){
+                    item.ftype = text;
+                }
+            }
+            if(itemName != "disk1.img"){
+                break;
+            }
+            if(lastKey == "sha256"){
+                product.versions.back().sha256 = text;
+            }
+            else if(lastKey == "path"){
+                product.versions.back().path = text;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+std::uint64_t versionsFingerprint(const std::vector<VersionView>& versions){
+    // FNV-1a over the version names and their sha256, separated so that the boundaries count
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& text){
+        for(unsigned char c : text){
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ull;
+    };
+
+    for(const VersionView& t_version : versions){
+        mix(t_version.version);
+        mix(t_version.sha256);
+    }
+
+    return hash;
+}
+
+void ProductViewBuilder::finish(){
+    // Json::Value keeps the object members sorted, sort the view the same way
+    std::sort(view.products.begin(), view.products.end(), [](const ProductView& lhs, const ProductView& rhs){
+        return lhs.id < rhs.id;
+    });
+
+    for(ProductView& t_product : view.products){
+        std::sort(t_product.versions.begin(), t_product.versions.end(), [](const VersionView& lhs, const VersionView& rhs){
+            return lhs.version < rhs.version;
+        });
+        t_product.fingerprint = versionsFingerprint(t_product.versions);
+    }
+}
+
+void ProductViewBuilder::fromJson(const Json::Value& root, FeedView& view, const std::string& arch, ViewFields fields){
+    const Json::Value& products = root["products"];
+
+    view.updated = root["updated"].asString();
+
+    // Iterate all elements under products tag
+    for(Json::Value::const_iterator productIt = products.begin(); productIt != products.end(); ++productIt){
+        const Json::Value& t_product = *productIt;
+
+        // Check if the architecture of the current product is the requested one. Continue otherwise.
+        if(t_product["arch"].asString() != arch && fields != ViewFields::Items){
+            continue;
+        }
+
+        ProductView productView;
+        productView.id = productIt.name();
+        productView.arch = t_product["arch"].asString();
+        productView.releaseTitle = t_product["release_title"].asString();
+        productView.releaseCodename = t_product["release_codename"].asString();
+        productView.release = t_product["release"].asString();
+        productView.releaseVersion = t_product["version"].asString();
+        productView.supportEol = t_product["support_eol"].asString();
+        productView.supported = t_product["supported"].isBool() && t_product["supported"].asBool();
+
+        if(fields != ViewFields::Titles){
+            const Json::Value& versions = t_product["versions"];
+
+            for(Json::Value::const_iterator versionIt = versions.begin(); versionIt != versions.end(); ++versionIt){
+                const Json::Value& items = (*versionIt)["items"];
+                const Json::Value& item = items["disk1.img"];
+                productView.versions.push_back(VersionView{versionIt.name(), item["sha256"].asString(), item["path"].asString(), item["size"].isUInt64() ? item["size"].asUInt64() : 0, {}});
+
+                if(fields == ViewFields::Items){
+                    for(Json::Value::const_iterator itemIt = items.begin(); itemIt != items.end(); ++itemIt){
+                        const Json::Value& t_item = *itemIt;
+                        productView.versions.back().items.push_back(ItemView{itemIt.name(), t_item["ftype"].asString(), t_item["sha256"].asString(),
+                            t_item["path"].asString(), t_item["size"].isUInt64() ? t_item["size"].asUInt64() : 0});
+                    }
+                }
+            }
+        }
+
+        // The members of a Json::Value object are sorted, so are the versions
+        productView.fingerprint = versionsFingerprint(productView.versions);
+        view.products.push_back(std::move(productView));
+    }
+}
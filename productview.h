@@ -0,0 +1,155 @@
+/**
+ * @file productview.h
+ * @brief This header file contains the declarations of the reduced product view of the simplestreams feed and its builders
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef PRODUCTVIEW_H
+#define PRODUCTVIEW_H
+
+#include "jsonstreamparser.h"
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ItemView
+ * @brief A single item (image, squashfs, manifest etc.) of a version
+ */
+struct ItemView{
+    // Member name of the item, e.g. 'disk1.img'
+    std::string name;
+    std::string ftype;
+    std::string sha256;
+    std::string path;
+    std::uint64_t size{0};
+};
+
+/**
+ * @struct VersionView
+ * @brief A single version (serial) of a product and the sha256, path and size of its disk1.img item
+ */
+struct VersionView{
+    std::string version;
+    std::string sha256;
+    // Path of the item relative to the root of the mirror
+    std::string path;
+    // Size of the item in bytes, 0 if unknown
+    std::uint64_t size{0};
+    // Every item of the version, only kept for ViewFields::Items
+    std::vector<ItemView> items;
+};
+
+/**
+ * @struct ProductView
+ * @brief Fields of a single product used by the cli operations
+ */
+struct ProductView{
+    // Name of the stream the product is aggregated from (e.g. 'daily'), empty for a single json file
+    std::string stream;
+    std::string id;
+    std::string arch;
+    std::string releaseTitle;
+    std::string releaseCodename;
+    // 'release' (e.g. focal) and 'version' (e.g. 20.04) fields of the product
+    std::string release;
+    std::string releaseVersion;
+    // 'support_eol' (e.g. 2025-04-25, empty if unknown) and 'supported' fields of the product
+    std::string supportEol;
+    bool supported{false};
+    // Sorted by the version string
+    std::vector<VersionView> versions;
+    // Fingerprint of the versions and their sha256, set by whatever builds the view, so that the unchanged products of
+    // two catalogs are told apart by a single comparison
+    std::uint64_t fingerprint{0};
+};
+
+/**
+ * @brief returns the fingerprint of the given sorted versions and their sha256.
+*/
+std::uint64_t versionsFingerprint(const std::vector<VersionView>& versions);
+
+/**
+ * @struct FeedView
+ * @brief Products of the requested architecture, sorted by the product id as the member order of a Json::Value object
+ */
+struct FeedView{
+    std::vector<ProductView> products;
+    // 'updated' field of the feed
+    std::string updated;
+};
+
+/**
+ * @enum Fields kept while building a view, operations only ask for what they need
+*/
+enum class ViewFields{
+    Titles,
+    Versions,
+    // Versions with all of their items, in every architecture
+    Items
+};
+
+/**
+ * @class ProductViewBuilder
+ * @brief This class receives the events of JsonStreamParser and keeps only the products of the requested architecture and
+ * the fields asked by the operation, everything else is dropped while the document is being parsed.
+ */
+class ProductViewBuilder : public JsonStreamHandler
+{
+public:
+    /**
+     * @brief ProductViewBuilder class constructor
+     * @param view destination of the products
+     * @param arch architecture of the products to be kept, ignored for ViewFields::Items
+     * @param fields fields to be kept
+    */
+    ProductViewBuilder(FeedView& view, std::string arch = "amd64", ViewFields fields = ViewFields::Versions);
+
+    void startObject() override;
+    void endObject() override;
+    void startArray() override;
+    void endArray() override;
+    void key(std::string_view name) override;
+    void value(std::string_view text, JsonScalarType type) override;
+
+    /**
+     * @brief sorts the collected products and versions and fingerprints the versions, must be called after the end of
+     * the document.
+    */
+    void finish();
+
+    /**
+     * @brief builds the same view from an already parsed Json::Value document.
+    */
+    static void fromJson(const Json::Value& root, FeedView& view, const std::string& arch = "amd64", ViewFields fields = ViewFields::Versions);
+
+private:
+    // Location of the parser in the simplestreams document
+    enum class Context{
+        Root,
+        Products,
+        Product,
+        Versions,
+        Version,
+        Items,
+        Item,
+        Ignored
+    };
+
+    FeedView& view;
+    std::string arch;
+    ViewFields fields;
+
+    std::vector<Context> contexts;
+    std::string lastKey;
+
+    // Product and item being parsed
+    ProductView product;
+    std::string itemName;
+};
+
+#endif // PRODUCTVIEW_H
@@ -0,0 +1,484 @@
+/**
+ * @file rangeddownloader.cpp
+ * @brief This source file contains the definitions of the parallel ranged downloader class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "rangeddownloader.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <curl/curl.h>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// A failed range is requested again this many times before the download is given up
+#define max_chunk_attempts 3
+
+struct RangedDownloader::Chunk
+{
+    std::uint64_t offset{0};
+    std::size_t length{0};
+    // Body of the range, released by the hasher
+    std::unique_ptr<std::uint8_t[]> data;
+    int attempts{0};
+    // Set when the chunk is written to the file, guarded by the hasher mutex
+    bool done{false};
+};
+
+namespace
+{
+
+// State of one of the concurrent requests
+struct RangeTransfer
+{
+    CURL* curl{nullptr};
+    // Chunk being downloaded, -1 if the transfer is idle
+    long chunkIndex{-1};
+    std::uint8_t* data{nullptr};
+    std::size_t length{0};
+    std::size_t received{0};
+    // Response code is checked on the first received bytes
+    bool checked{false};
+    // Server answered 200 with the whole file instead of the range
+    bool rejected{false};
+};
+
+// State of the single request fallback
+struct StreamTransfer
+{
+    CURL* curl{nullptr};
+    int fd{-1};
+    std::uint64_t offset{0};
+    Sha256* hasher{nullptr};
+    bool checked{false};
+    bool writeFailed{false};
+};
+
+int openOutput(const std::string& path){
+#ifdef _WIN32
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+void closeOutput(int fd){
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+bool resizeOutput(int fd, std::uint64_t size){
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+#else
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+// Writes the whole buffer at the given offset of the file
+bool writeAt(int fd, const std::uint8_t* data, std::size_t length, std::uint64_t offset){
+    while(length > 0){
+#ifdef _WIN32
+        // Chunks are written by a single thread, seek and write do not race
+        if(_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0){
+            return false;
+        }
+        int written = _write(fd, data, static_cast<unsigned>(std::min<std::size_t>(length, 1u << 30)));
+#else
+        ssize_t written = pwrite(fd, data, length, static_cast<off_t>(offset));
+#endif
+        if(written < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+
+        data += written;
+        length -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+
+    return true;
+}
+
+size_t rangeWriteCallback(char* contents, size_t size, size_t nmemb, void* userp){
+    RangeTransfer* transfer = static_cast<RangeTransfer*>(userp);
+    size_t totalBytes = size * nmemb;
+
+    // A server ignoring the range sends the whole file, stop the transfer immediately
+    if(!transfer->checked){
+        long httpCode = 0;
+        curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &httpCode);
+        if(httpCode != 206){
+            transfer->rejected = httpCode == 200;
+            return 0;
+        }
+        transfer->checked = true;
+    }
+
+    if(totalBytes > transfer->length - transfer->received){
+        return 0;
+    }
+
+    std::memcpy(transfer->data + transfer->received, contents, totalBytes);
+    transfer->received += totalBytes;
+
+    return totalBytes;
+}
+
+size_t streamWriteCallback(char* contents, size_t size, size_t nmemb, void* userp){
+    StreamTransfer* transfer = static_cast<StreamTransfer*>(userp);
+    size_t totalBytes = size * nmemb;
+
+    if(!transfer->checked){
+        long httpCode = 0;
+        curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &httpCode);
+        // Local files have no response code
+        if(httpCode != 200 && httpCode != 0){
+            return 0;
+        }
+        transfer->checked = true;
+    }
+
+    if(!writeAt(transfer->fd, reinterpret_cast<const std::uint8_t*>(contents), totalBytes, transfer->offset)){
+        transfer->writeFailed = true;
+        return 0;
+    }
+
+    transfer->hasher->update(contents, totalBytes);
+    transfer->offset += totalBytes;
+
+    return totalBytes;
+}
+
+size_t probeHeaderCallback(char* buffer, size_t size, size_t nitems, void* userp){
+    bool* acceptsRanges = static_cast<bool*>(userp);
+    size_t totalBytes = size * nitems;
+
+    std::string line(buffer, totalBytes);
+    std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c){ return std::tolower(c); });
+    if(line.compare(0, 14, "accept-ranges:") == 0 && line.find("bytes") != std::string::npos){
+        *acceptsRanges = true;
+    }
+
+    return totalBytes;
+}
+
+}
+
+RangedDownloader::RangedDownloader(TransferEngine& engine, unsigned connections, std::size_t chunkSize)
+    : engine(engine),
+      connections(std::max(1u, connections)),
+      chunkSize(std::max<std::size_t>(64 * 1024, chunkSize))
+{
+
+}
+
+CURL* RangedDownloader::acquire(const std::string& url){
+    CURL* curl = engine.acquire(url);
+
+    // Ranges of an encoded response would address the encoded bytes, images are requested as they are
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, nullptr);
+
+    return curl;
+}
+
+bool RangedDownloader::probe(const std::string& url, std::uint64_t& size, bool& acceptsRanges){
+    CURL* curl = acquire(url);
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, probeHeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &acceptsRanges);
+
+    CURLcode curlCode = curl_easy_perform(curl);
+    long httpCode = 0;
+    curl_off_t contentLength = -1;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength);
+    engine.release(curl);
+
+    if(curlCode != CURLE_OK || (httpCode != 200 && httpCode != 0)){
+        error = curlCode != CURLE_OK ? curl_easy_strerror(curlCode) : "server answered " + std::to_string(httpCode);
+        return false;
+    }
+
+    size = contentLength > 0 ? static_cast<std::uint64_t>(contentLength) : 0;
+
+    return true;
+}
+
+bool RangedDownloader::download(const std::string& url, const std::string& path, std::uint64_t expectedSize, std::uint8_t digest[32]){
+    bytes = 0;
+    seconds = 0;
+    usedConnections = 0;
+    error.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Size given by the catalog is trusted, the server is asked otherwise. Range requests are used only over http,
+    // a local file is simply copied.
+    bool http = url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0;
+    std::uint64_t size = expectedSize;
+    bool acceptsRanges = http && expectedSize > 0;
+    if(http && size == 0 && !probe(url, size, acceptsRanges)){
+        return false;
+    }
+
+    std::string partialPath = path + ".part";
+    int fd = openOutput(partialPath);
+    if(fd < 0){
+        error = "Could not create " + partialPath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    bool downloaded = false;
+    bool rangesRejected = false;
+    if(acceptsRanges && size > 0){
+        downloaded = downloadRanges(url, fd, size, digest, rangesRejected);
+    }
+    if(!acceptsRanges || size == 0 || rangesRejected){
+        error.clear();
+        downloaded = resizeOutput(fd, 0) && downloadStream(url, fd, digest);
+    }
+
+    closeOutput(fd);
+
+    std::error_code fileError;
+    if(!downloaded){
+        std::filesystem::remove(partialPath, fileError);
+        return false;
+    }
+
+    std::filesystem::rename(partialPath, path, fileError);
+    if(fileError){
+        std::filesystem::remove(partialPath, fileError);
+        error = "Could not move the download to " + path;
+        return false;
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return true;
+}
+
+bool RangedDownloader::downloadRanges(const std::string& url, int fd, std::uint64_t size, std::uint8_t digest[32], bool& rangesRejected){
+    if(!resizeOutput(fd, size)){
+        error = std::string("Could not allocate the file: ") + std::strerror(errno);
+        return false;
+    }
+
+    // Split the file into chunks
+    std::size_t chunkCount = static_cast<std::size_t>((size + chunkSize - 1) / chunkSize);
+    std::vector<Chunk> chunks(chunkCount);
+    for(std::size_t i = 0; i < chunkCount; i++){
+        chunks[i].offset = static_cast<std::uint64_t>(i) * chunkSize;
+        chunks[i].length = static_cast<std::size_t>(std::min<std::uint64_t>(chunkSize, size - chunks[i].offset));
+    }
+
+    CURLM* multi = engine.acquireMulti();
+
+    // Chunks are hashed in order by a separate thread, out of order chunks wait in memory. Requests are not started
+    // further than the window ahead of the hasher to bound the memory.
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool aborted = false;
+    std::atomic<std::size_t> hashedChunks{0};
+    const std::size_t window = static_cast<std::size_t>(connections) * 4;
+
+    std::thread hasherThread([&]{
+        Sha256 hasher;
+
+        for(std::size_t i = 0; i < chunkCount; i++){
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]{ return chunks[i].done || aborted; });
+                if(aborted){
+                    return;
+                }
+            }
+
+            hasher.update(chunks[i].data.get(), chunks[i].length);
+            chunks[i].data.reset();
+            hashedChunks = i + 1;
+
+            // Let the transfer loop start the requests held back by the window
+            curl_multi_wakeup(multi);
+        }
+
+        hasher.finish(digest);
+    });
+
+    std::vector<RangeTransfer> transfers(std::min<std::size_t>(connections, chunkCount));
+    for(RangeTransfer& transfer : transfers){
+        transfer.curl = acquire(url);
+        curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, rangeWriteCallback);
+        curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer);
+        curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+    }
+    usedConnections = static_cast<unsigned>(transfers.size());
+
+    std::deque<std::size_t> retries;
+    std::size_t nextChunk = 0;
+    std::size_t completedChunks = 0;
+    bool failed = false;
+
+    while(completedChunks < chunkCount && !failed){
+        // Hand the pending chunks to the idle transfers
+        for(RangeTransfer& transfer : transfers){
+            if(transfer.chunkIndex >= 0){
+                continue;
+            }
+
+            std::size_t index;
+            if(!retries.empty()){
+                index = retries.front();
+                retries.pop_front();
+            }
+            else if(nextChunk < chunkCount && nextChunk < hashedChunks + window){
+                index = nextChunk++;
+            }
+            else{
+                break;
+            }
+
+            Chunk& chunk = chunks[index];
+            if(!chunk.data){
+                chunk.data.reset(new std::uint8_t[chunk.length]);
+            }
+
+            std::string range = std::to_string(chunk.offset) + "-" + std::to_string(chunk.offset + chunk.length - 1);
+            curl_easy_setopt(transfer.curl, CURLOPT_RANGE, range.c_str());
+
+            transfer.chunkIndex = static_cast<long>(index);
+            transfer.data = chunk.data.get();
+            transfer.length = chunk.length;
+            transfer.received = 0;
+            transfer.checked = false;
+            transfer.rejected = false;
+            curl_multi_add_handle(multi, transfer.curl);
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+        curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        curl_multi_perform(multi, &running);
+
+        // Collect the finished requests
+        int remaining = 0;
+        while(CURLMsg* message = curl_multi_info_read(multi, &remaining)){
+            if(message->msg != CURLMSG_DONE){
+                continue;
+            }
+
+            RangeTransfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+            curl_multi_remove_handle(multi, message->easy_handle);
+
+            std::size_t index = static_cast<std::size_t>(transfer->chunkIndex);
+            Chunk& chunk = chunks[index];
+            transfer->chunkIndex = -1;
+            bytes += transfer->received;
+
+            if(transfer->rejected){
+                rangesRejected = true;
+                failed = true;
+            }
+            else if(message->data.result == CURLE_OK && transfer->checked && transfer->received == chunk.length){
+                if(!writeAt(fd, chunk.data.get(), chunk.length, chunk.offset)){
+                    error = std::string("Could not write the file: ") + std::strerror(errno);
+                    failed = true;
+                    continue;
+                }
+
+                completedChunks++;
+                std::lock_guard<std::mutex> lock(mutex);
+                chunk.done = true;
+                condition.notify_all();
+            }
+            else if(++chunk.attempts < max_chunk_attempts){
+                retries.push_back(index);
+            }
+            else{
+                long httpCode = 0;
+                curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &httpCode);
+                error = "Range " + std::to_string(chunk.offset) + "+" + std::to_string(chunk.length) + " failed: " +
+                        (httpCode >= 300 || message->data.result == CURLE_OK ? "server answered " + std::to_string(httpCode) : curl_easy_strerror(message->data.result));
+                failed = true;
+            }
+        }
+    }
+
+    if(failed){
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        condition.notify_all();
+    }
+    hasherThread.join();
+
+    for(RangeTransfer& transfer : transfers){
+        if(transfer.chunkIndex >= 0){
+            curl_multi_remove_handle(multi, transfer.curl);
+        }
+        engine.release(transfer.curl);
+    }
+    engine.releaseMulti(multi);
+
+    return !failed;
+}
+
+bool RangedDownloader::downloadStream(const std::string& url, int fd, std::uint8_t digest[32]){
+    Sha256 hasher;
+
+    StreamTransfer transfer;
+    transfer.curl = acquire(url);
+    transfer.fd = fd;
+    transfer.hasher = &hasher;
+
+    curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, streamWriteCallback);
+    curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer);
+
+    CURLcode curlCode = curl_easy_perform(transfer.curl);
+    long httpCode = 0;
+    curl_easy_getinfo(transfer.curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    engine.release(transfer.curl);
+
+    usedConnections = 1;
+    bytes = transfer.offset;
+
+    if(transfer.writeFailed){
+        error = std::string("Could not write the file: ") + std::strerror(errno);
+        return false;
+    }
+    if(curlCode != CURLE_OK || (httpCode != 200 && httpCode != 0)){
+        error = curlCode != CURLE_OK && httpCode < 300 ? curl_easy_strerror(curlCode) : "server answered " + std::to_string(httpCode);
+        return false;
+    }
+
+    hasher.finish(digest);
+
+    return true;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file rangeddownloader.h
+ * @brief This header file contains the declarations of the parallel ranged downloader class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef RANGEDDOWNLOADER_H
+#define RANGEDDOWNLOADER_H
+
+#include "transferengine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class RangedDownloader
+ * @brief This class downloads a large file by several concurrent http range requests on a single curl multi handle.
+ * Every completed chunk is written to its offset of the destination file and handed over to a hasher thread which
+ * computes the sha256 of the file in order, so the digest is ready as soon as the last chunk arrives. Servers that
+ * do not support range requests are downloaded by a single request and hashed while they are being received.
+ */
+class RangedDownloader
+{
+public:
+    /**
+     * @brief RangedDownloader class constructor
+     * @param engine provides the curl handles, a stalled request is aborted by its low speed limit and retried
+     * @param connections number of concurrent range requests
+     * @param chunkSize size of the range requested by each request
+    */
+    RangedDownloader(TransferEngine& engine, unsigned connections = 4, std::size_t chunkSize = 8 * 1024 * 1024);
+
+    /**
+     * @brief downloads the given url into the given path.
+     * @param url url of the file
+     * @param path destination of the file, it is written as '<path>.part' and renamed when it is complete
+     * @param expectedSize size of the file if known in advance, 0 to ask the server
+     * @param digest 32 byte sha256 digest of the downloaded file
+     * @return false if the download fails, errorMessage() describes the problem.
+    */
+    bool download(const std::string& url, const std::string& path, std::uint64_t expectedSize, std::uint8_t digest[32]);
+
+    // Statistics of the last download() call
+    std::uint64_t bytesDownloaded() const { return bytes; }
+    double elapsedSeconds() const { return seconds; }
+    // Number of connections actually used, 1 if the server does not support range requests
+    unsigned connectionsUsed() const { return usedConnections; }
+    const std::string& errorMessage() const { return error; }
+
+private:
+    TransferEngine& engine;
+    unsigned connections;
+    std::size_t chunkSize;
+
+    std::uint64_t bytes{0};
+    double seconds{0};
+    unsigned usedConnections{0};
+    std::string error;
+
+    struct Chunk;
+
+    // Asks the server for the size of the file and whether it accepts range requests
+    bool probe(const std::string& url, std::uint64_t& size, bool& acceptsRanges);
+    // Downloads the file by concurrent range requests, returns false and sets rangesRejected if a server answers 200
+    bool downloadRanges(const std::string& url, int fd, std::uint64_t size, std::uint8_t digest[32], bool& rangesRejected);
+    // Downloads the file by a single request
+    bool downloadStream(const std::string& url, int fd, std::uint8_t digest[32]);
+    // Acquires a handle from the engine for a transfer of raw image bytes
+    CURL* acquire(const std::string& url);
+};
+
+#endif // RANGEDDOWNLOADER_H
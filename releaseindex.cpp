@@ -0,0 +1,211 @@
+/**
+ * @file releaseindex.cpp
+ * @brief This source file contains the definitions of the case insensitive prefix index of the release names
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "releaseindex.h"
+
+#include "columnarcatalog.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+
+std::string lowercase(std::string_view text){
+    std::string lowered(text);
+    for(char& c : lowered){
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lowered;
+}
+
+}
+
+const char* ReleaseIndex::kindName(Kind kind){
+    switch(kind){
+        case Kind::Title: return "title";
+        case Kind::Codename: return "codename";
+        case Kind::Release: return "release";
+        case Kind::ReleaseVersion: return "release_version";
+    }
+    return "";
+}
+
+void ReleaseIndex::build(const std::vector<ProductView>& t_products){
+    clear(t_products.size());
+    products = &t_products;
+
+    for(std::uint32_t position = 0; position < t_products.size(); position++){
+        const ProductView& product = t_products[position];
+        addProduct(position, product.releaseTitle, product.releaseCodename, product.release, product.releaseVersion);
+    }
+
+    layTrie();
+}
+
+void ReleaseIndex::build(const ColumnarCatalog& catalog){
+    clear(catalog.productCount());
+
+    for(std::uint32_t position = 0; position < catalog.productCount(); position++){
+        addProduct(position, catalog.releaseTitle(position), catalog.releaseCodename(position), catalog.release(position),
+                   catalog.releaseVersion(position));
+    }
+
+    layTrie();
+}
+
+void ReleaseIndex::clear(std::size_t productCount){
+    products = nullptr;
+    names.clear();
+    nodes.clear();
+    derivedNames.clear();
+
+    // The names refer to the derived strings, which must not be reallocated
+    derivedNames.reserve(2 * productCount);
+}
+
+void ReleaseIndex::addProduct(std::uint32_t position, std::string_view releaseTitle, std::string_view releaseCodename,
+                              std::string_view release, std::string_view releaseVersion){
+    auto add = [this](std::string_view name, Kind kind, std::uint32_t t_position){
+        if(!name.empty()){
+            names.push_back(Name{lowercase(name), name, kind, t_position});
+        }
+    };
+
+    add(releaseTitle, Kind::Title, position);
+    add(releaseCodename, Kind::Codename, position);
+
+    // The release name is the first word of the codename (bionic) and the release version the number of the title
+    // (18.04) when the catalog does not keep them
+    if(!release.empty()){
+        add(release, Kind::Release, position);
+    }
+    else if(!releaseCodename.empty()){
+        derivedNames.push_back(lowercase(releaseCodename.substr(0, releaseCodename.find(' '))));
+        add(derivedNames.back(), Kind::Release, position);
+    }
+
+    if(!releaseVersion.empty()){
+        add(releaseVersion, Kind::ReleaseVersion, position);
+    }
+    else if(!releaseTitle.empty()){
+        derivedNames.push_back(std::string(releaseTitle.substr(0, releaseTitle.find(' '))));
+        add(derivedNames.back(), Kind::ReleaseVersion, position);
+    }
+}
+
+void ReleaseIndex::layTrie(){
+    // A name is kept once, for its best kind and the first product
+    std::sort(names.begin(), names.end(), [](const Name& lhs, const Name& rhs){
+        if(lhs.lowered != rhs.lowered){
+            return lhs.lowered < rhs.lowered;
+        }
+        if(lhs.kind != rhs.kind){
+            return lhs.kind < rhs.kind;
+        }
+        return lhs.product < rhs.product;
+    });
+    names.erase(std::unique(names.begin(), names.end(), [](const Name& lhs, const Name& rhs){ return lhs.lowered == rhs.lowered; }), names.end());
+
+    // Lay the trie over the sorted names breadth first, so that the children of a node are created together
+    nodes.push_back(Node{0, static_cast<std::uint32_t>(names.size()), 0, 0, '\0'});
+    std::vector<std::uint32_t> depths{0};
+
+    for(std::uint32_t index = 0; index < nodes.size(); index++){
+        std::uint32_t depth = depths[index];
+        std::uint32_t begin = nodes[index].namesBegin;
+        std::uint32_t end = nodes[index].namesEnd;
+
+        // The name that ends at this node sorts before the longer ones
+        if(begin < end && names[begin].lowered.size() == depth){
+            begin++;
+        }
+
+        nodes[index].childrenBegin = static_cast<std::uint32_t>(nodes.size());
+        while(begin < end){
+            char label = names[begin].lowered[depth];
+            std::uint32_t next = begin;
+            while(next < end && names[next].lowered[depth] == label){
+                next++;
+            }
+            nodes.push_back(Node{begin, next, 0, 0, label});
+            depths.push_back(depth + 1);
+            begin = next;
+        }
+        nodes[index].childrenEnd = static_cast<std::uint32_t>(nodes.size());
+    }
+}
+
+void ReleaseIndex::complete(std::string_view prefix, std::vector<Candidate>& candidates) const{
+    candidates.clear();
+    if(nodes.empty()){
+        return;
+    }
+
+    // Walk down the trie, one node per character
+    std::uint32_t node = 0;
+    for(char c : prefix){
+        char label = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        const Node* first = nodes.data() + nodes[node].childrenBegin;
+        const Node* last = nodes.data() + nodes[node].childrenEnd;
+        const Node* child = std::lower_bound(first, last, label, [](const Node& lhs, char rhs){ return lhs.label < rhs; });
+        if(child == last || child->label != label){
+            return;
+        }
+        node = static_cast<std::uint32_t>(child - nodes.data());
+    }
+
+    for(std::uint32_t index = nodes[node].namesBegin; index < nodes[node].namesEnd; index++){
+        const Name& t_name = names[index];
+        const ProductView* product = products ? &(*products)[t_name.product] : nullptr;
+        candidates.push_back(Candidate{product, t_name.product, t_name.name, t_name.kind, t_name.lowered.size() == prefix.size()});
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs){
+        if(lhs.exact != rhs.exact){
+            return lhs.exact;
+        }
+        if(lhs.name.size() != rhs.name.size()){
+            return lhs.name.size() < rhs.name.size();
+        }
+        if(lhs.kind != rhs.kind){
+            return lhs.kind < rhs.kind;
+        }
+        return lhs.position < rhs.position;
+    });
+}
+
+const ProductView* ReleaseIndex::resolve(std::string_view text, std::vector<Candidate>* candidates) const{
+    std::uint32_t position = resolvePosition(text, candidates);
+    return position == npos || !products ? nullptr : &(*products)[position];
+}
+
+std::uint32_t ReleaseIndex::resolvePosition(std::string_view text, std::vector<Candidate>* candidates) const{
+    std::vector<Candidate> found;
+    complete(text, found);
+
+    std::uint32_t position = npos;
+    if(!found.empty()){
+        position = found.front().position;
+
+        // Without an exact name every candidate has to be the same release
+        if(!found.front().exact){
+            for(const Candidate& candidate : found){
+                if(candidate.position != position){
+                    position = npos;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(candidates){
+        candidates->swap(found);
+    }
+
+    return position;
+}
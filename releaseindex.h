@@ -0,0 +1,114 @@
+/**
+ * @file releaseindex.h
+ * @brief This header file contains the declarations of the case insensitive prefix index of the release names
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef RELEASEINDEX_H
+#define RELEASEINDEX_H
+
+#include "productview.h"
+
+class ColumnarCatalog;
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ReleaseIndex
+ * @brief This class indexes every name a release is known by: its title (18.04 LTS), codename (Bionic Beaver), release
+ * name (bionic) and release version (18.04). The lowercase names are kept sorted and a trie is laid over them, every
+ * node of the trie holds the range of the names that start with its prefix, so the names starting with a given text are
+ * found by a walk of the length of the text. A name shared by several products (e.g. the streams of an aggregated
+ * catalog) refers to the first of them, as the exact lookups of the catalog do. The index is built over the products of
+ * a view or over the columns of a columnar catalog, the products are told apart by their position.
+ */
+class ReleaseIndex
+{
+public:
+    // Position returned when no release is resolved
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+    // Kinds of names, in the order of their rank
+    enum class Kind{
+        Title,
+        Codename,
+        Release,
+        ReleaseVersion
+    };
+
+    struct Candidate{
+        // Null if the index is built over a columnar catalog
+        const ProductView* product;
+        std::uint32_t position;
+        // Name as it is written in the catalog
+        std::string_view name;
+        Kind kind;
+        // True if the name is the whole text, not only starts with it
+        bool exact;
+    };
+
+    /**
+     * @brief indexes the names of the given products, which must outlive the index.
+    */
+    void build(const std::vector<ProductView>& products);
+    void build(const ColumnarCatalog& catalog);
+
+    /**
+     * @brief finds the names starting with the given text, case insensitive. Candidates are ranked by the exact match
+     * first, then by the length of the name, its kind and the order of the products.
+    */
+    void complete(std::string_view prefix, std::vector<Candidate>& candidates) const;
+
+    /**
+     * @brief resolves the given text to a release: the product of the name that equals the text, otherwise the only
+     * product whose names start with it.
+     * @param candidates ranked candidates, e.g. to be listed if the text is ambiguous, may be null
+     * @return null if no release or more than one release matches.
+    */
+    const ProductView* resolve(std::string_view text, std::vector<Candidate>* candidates = nullptr) const;
+
+    /**
+     * @brief resolves the given text as resolve() does.
+     * @return position of the product, npos if no release or more than one release matches.
+    */
+    std::uint32_t resolvePosition(std::string_view text, std::vector<Candidate>* candidates = nullptr) const;
+
+    static const char* kindName(Kind kind);
+
+private:
+    struct Name{
+        std::string lowered;
+        std::string_view name;
+        Kind kind;
+        std::uint32_t product;
+    };
+
+    // Children of a node are contiguous and sorted by their label
+    struct Node{
+        std::uint32_t namesBegin;
+        std::uint32_t namesEnd;
+        std::uint32_t childrenBegin;
+        std::uint32_t childrenEnd;
+        char label;
+    };
+
+    const std::vector<ProductView>* products{nullptr};
+    // Sorted by the lowercase name
+    std::vector<Name> names;
+    std::vector<Node> nodes;
+
+    // Product names derived when the feed does not have them
+    std::vector<std::string> derivedNames;
+
+    void clear(std::size_t productCount);
+    void addProduct(std::uint32_t position, std::string_view releaseTitle, std::string_view releaseCodename,
+                    std::string_view release, std::string_view releaseVersion);
+    void layTrie();
+};
+
+#endif // RELEASEINDEX_H
@@ -0,0 +1,135 @@
+/**
+ * @file runstats.cpp
+ * @brief This source file contains the definitions of the per-phase timing and transfer statistics of an invocation
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "runstats.h"
+
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+double infoSeconds(CURL* curl, CURLINFO info){
+    curl_off_t microseconds = 0;
+    curl_easy_getinfo(curl, info, &microseconds);
+    return static_cast<double>(microseconds) / 1e6;
+}
+
+double milliseconds(double seconds){
+    return seconds * 1000.0;
+}
+
+}
+
+void RunStats::recordTransfer(CURL* curl, const std::string& purpose, std::uint64_t bodyBytes, const std::string& contentEncoding){
+    TransferStats transfer;
+    transfer.purpose = purpose;
+
+    char* url = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+    transfer.url = url ? url : "";
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer.httpCode);
+
+    transfer.nameLookupSeconds = infoSeconds(curl, CURLINFO_NAMELOOKUP_TIME_T);
+    transfer.connectSeconds = infoSeconds(curl, CURLINFO_CONNECT_TIME_T);
+    transfer.appConnectSeconds = infoSeconds(curl, CURLINFO_APPCONNECT_TIME_T);
+    transfer.startTransferSeconds = infoSeconds(curl, CURLINFO_STARTTRANSFER_TIME_T);
+    transfer.totalSeconds = infoSeconds(curl, CURLINFO_TOTAL_TIME_T);
+
+    // Size of the body as received, before the content encoding is decoded
+    curl_off_t downloaded = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    transfer.downloadedBytes = static_cast<std::uint64_t>(downloaded);
+    transfer.bodyBytes = bodyBytes;
+    transfer.contentEncoding = contentEncoding;
+
+    transfers.push_back(std::move(transfer));
+}
+
+long RunStats::peakRssKiB(){
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))){
+        return 0;
+    }
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    // ru_maxrss is in KiB on Linux
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0){
+        return 0;
+    }
+    return usage.ru_maxrss;
+#endif
+}
+
+Json::Value RunStats::toJson() const{
+    Json::Value root(Json::objectValue);
+
+    root["source"] = source;
+
+    Json::Value& transferList = root["transfers"] = Json::Value(Json::arrayValue);
+    for(const TransferStats& transfer : transfers){
+        Json::Value entry(Json::objectValue);
+        entry["purpose"] = transfer.purpose;
+        entry["url"] = transfer.url;
+        entry["http_code"] = static_cast<Json::Int64>(transfer.httpCode);
+        entry["name_lookup_ms"] = milliseconds(transfer.nameLookupSeconds);
+        entry["connect_ms"] = milliseconds(transfer.connectSeconds);
+        entry["app_connect_ms"] = milliseconds(transfer.appConnectSeconds);
+        entry["start_transfer_ms"] = milliseconds(transfer.startTransferSeconds);
+        entry["total_ms"] = milliseconds(transfer.totalSeconds);
+        entry["downloaded_bytes"] = static_cast<Json::UInt64>(transfer.downloadedBytes);
+        entry["body_bytes"] = static_cast<Json::UInt64>(transfer.bodyBytes);
+        entry["compressed"] = !transfer.contentEncoding.empty() && transfer.contentEncoding != "identity";
+        entry["content_encoding"] = transfer.contentEncoding;
+        transferList.append(entry);
+    }
+
+    root["obtain_ms"] = milliseconds(obtainSeconds);
+    root["parse_ms"] = milliseconds(parseSeconds);
+    root["catalog_build_ms"] = milliseconds(catalogBuildSeconds);
+    root["lookup_ms"] = milliseconds(lookupSeconds);
+    root["output_ms"] = milliseconds(outputSeconds);
+    root["products"] = static_cast<Json::UInt64>(products);
+    root["versions"] = static_cast<Json::UInt64>(versions);
+    root["peak_rss_kib"] = static_cast<Json::Int64>(peakRssKiB());
+
+    return root;
+}
+
+void RunStats::print(std::ostream& out) const{
+    std::ios_base::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    out << "source            : " << (source.empty() ? "none" : source) << "\n";
+    for(const TransferStats& transfer : transfers){
+        out << "transfer          : " << transfer.purpose << " " << transfer.url << " -> " << transfer.httpCode << "\n"
+            << "  name lookup     : " << milliseconds(transfer.nameLookupSeconds) << " ms\n"
+            << "  connect         : " << milliseconds(transfer.connectSeconds) << " ms\n"
+            << "  app connect     : " << milliseconds(transfer.appConnectSeconds) << " ms\n"
+            << "  start transfer  : " << milliseconds(transfer.startTransferSeconds) << " ms\n"
+            << "  total           : " << milliseconds(transfer.totalSeconds) << " ms\n"
+            << "  downloaded      : " << transfer.downloadedBytes << " bytes (" << transfer.bodyBytes << " decoded, "
+            << (transfer.contentEncoding.empty() ? "uncompressed" : transfer.contentEncoding) << ")\n";
+    }
+    out << "obtain catalog    : " << milliseconds(obtainSeconds) << " ms\n"
+        << "  parse           : " << milliseconds(parseSeconds) << " ms\n"
+        << "  catalog build   : " << milliseconds(catalogBuildSeconds) << " ms\n"
+        << "lookup            : " << milliseconds(lookupSeconds) << " ms\n"
+        << "output            : " << milliseconds(outputSeconds) << " ms\n"
+        << "products          : " << products << "\n"
+        << "versions          : " << versions << "\n"
+        << "peak rss          : " << peakRssKiB() << " KiB" << std::endl;
+
+    out.flags(flags);
+}
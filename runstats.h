@@ -0,0 +1,116 @@
+/**
+ * @file runstats.h
+ * @brief This header file contains the declarations of the per-phase timing and transfer statistics of an invocation
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+#include <curl/curl.h>
+#include <json/json.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TransferStats
+ * @brief Timings and sizes of a single curl transfer, the times are measured from the start of the transfer
+ */
+struct TransferStats{
+    // What the transfer was for, e.g. 'feed' or 'index'
+    std::string purpose;
+    std::string url;
+    long httpCode{0};
+    double nameLookupSeconds{0};
+    double connectSeconds{0};
+    double appConnectSeconds{0};
+    double startTransferSeconds{0};
+    double totalSeconds{0};
+    // Bytes received on the wire and after decoding the content encoding
+    std::uint64_t downloadedBytes{0};
+    std::uint64_t bodyBytes{0};
+    // Content-Encoding of the response, empty if the body was not compressed
+    std::string contentEncoding;
+};
+
+/**
+ * @class RunStats
+ * @brief This class collects where the time of an invocation goes: the curl transfers, parsing, building the catalog,
+ * the lookups and writing the output, together with the size of the catalog and the peak memory usage. Phases that
+ * run several times accumulate.
+ */
+class RunStats
+{
+public:
+    /**
+     * @brief accumulates the elapsed time of its scope into the given phase.
+     */
+    class Timer
+    {
+    public:
+        explicit Timer(double& seconds) : seconds(seconds), start(std::chrono::steady_clock::now()) {}
+        ~Timer() { stop(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        // Ends the measurement before the end of the scope
+        void stop(){
+            if(running){
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                running = false;
+            }
+        }
+
+    private:
+        double& seconds;
+        std::chrono::steady_clock::time_point start;
+        bool running{true};
+    };
+
+    /**
+     * @brief records the timings of a completed transfer from its curl handle, must be called before the handle is reset.
+     * @param curl handle of the transfer
+     * @param purpose what the transfer was for
+     * @param bodyBytes size of the decoded body handed over to the write callback
+     * @param contentEncoding Content-Encoding header of the response
+    */
+    void recordTransfer(CURL* curl, const std::string& purpose, std::uint64_t bodyBytes, const std::string& contentEncoding);
+
+    /**
+     * @brief returns the peak resident set size of the process in KiB, 0 if it is not available.
+    */
+    static long peakRssKiB();
+
+    /**
+     * @brief returns the statistics as a json object.
+    */
+    Json::Value toJson() const;
+
+    /**
+     * @brief writes the statistics in a human readable form.
+    */
+    void print(std::ostream& out) const;
+
+    // Where the catalog came from: 'network', 'cache', 'snapshot' or 'local'
+    std::string source;
+    std::vector<TransferStats> transfers;
+
+    // Whole time of obtaining the catalog, includes the phases below
+    double obtainSeconds{0};
+    // Parsing the json file or reading the snapshot into the product views, overlaps the transfer for the stream parser
+    double parseSeconds{0};
+    double catalogBuildSeconds{0};
+    double lookupSeconds{0};
+    double outputSeconds{0};
+
+    std::uint64_t products{0};
+    std::uint64_t versions{0};
+};
+
+#endif // RUNSTATS_H
@@ -0,0 +1,265 @@
+/**
+ * @file sha256.cpp
+ * @brief This source file contains the definitions of the streaming sha256 hasher class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "sha256.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UCII_SHA_NI_AVAILABLE 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// Round constants
+alignas(16) static const std::uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline std::uint32_t rotateRight(std::uint32_t value, int count){
+    return (value >> count) | (value << (32 - count));
+}
+
+// Portable block function
+static void compressPortable(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count){
+    std::uint32_t w[64];
+
+    for(std::size_t block = 0; block < count; block++, blocks += 64){
+        for(int i = 0; i < 16; i++){
+            w[i] = (static_cast<std::uint32_t>(blocks[i * 4]) << 24) | (static_cast<std::uint32_t>(blocks[i * 4 + 1]) << 16) |
+                   (static_cast<std::uint32_t>(blocks[i * 4 + 2]) << 8) | static_cast<std::uint32_t>(blocks[i * 4 + 3]);
+        }
+        for(int i = 16; i < 64; i++){
+            std::uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for(int i = 0; i < 64; i++){
+            std::uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            std::uint32_t choice = (e & f) ^ (~e & g);
+            std::uint32_t t1 = h + s1 + choice + roundConstants[i] + w[i];
+            std::uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            std::uint32_t t2 = s0 + majority;
+
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#ifdef UCII_SHA_NI_AVAILABLE
+
+// Block function on the x86 SHA extensions, 4 rounds per iteration
+__attribute__((target("sha,sse4.1,ssse3")))
+static void compressShaNi(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count){
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Rearrange the state into the ABEF / CDGH layout of the instructions
+    __m128i temporary = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    temporary = _mm_shuffle_epi32(temporary, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    __m128i state0 = _mm_alignr_epi8(temporary, state1, 8);
+    state1 = _mm_blend_epi16(state1, temporary, 0xF0);
+
+    for(std::size_t block = 0; block < count; block++, blocks += 64){
+        const __m128i savedState0 = state0;
+        const __m128i savedState1 = state1;
+        __m128i schedule[16];
+
+        for(int i = 0; i < 16; i++){
+            if(i < 4){
+                schedule[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + i * 16)), byteSwapMask);
+            }
+            else{
+                // w[t] = s1(w[t-2]) + w[t-7] + s0(w[t-15]) + w[t-16] for four words at once
+                __m128i partial = _mm_add_epi32(_mm_sha256msg1_epu32(schedule[i - 4], schedule[i - 3]), _mm_alignr_epi8(schedule[i - 1], schedule[i - 2], 4));
+                schedule[i] = _mm_sha256msg2_epu32(partial, schedule[i - 1]);
+            }
+
+            __m128i message = _mm_add_epi32(schedule[i], _mm_load_si128(reinterpret_cast<const __m128i*>(&roundConstants[i * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            message = _mm_shuffle_epi32(message, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+        }
+
+        state0 = _mm_add_epi32(state0, savedState0);
+        state1 = _mm_add_epi32(state1, savedState1);
+    }
+
+    // Restore the ABCD / EFGH layout
+    temporary = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(temporary, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, temporary, 8);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+static bool cpuSupportsShaNi(){
+    unsigned eax, ebx, ecx, edx;
+
+    // SSSE3 and SSE4.1 are reported by leaf 1, SHA by leaf 7
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 9)) || !(ecx & (1u << 19))){
+        return false;
+    }
+    if(__get_cpuid_max(0, nullptr) < 7){
+        return false;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    return (ebx & (1u << 29)) != 0;
+}
+
+#endif
+
+using CompressFunction = void (*)(std::uint32_t*, const std::uint8_t*, std::size_t);
+
+// Selects the block function on the first use
+static CompressFunction selectCompress(){
+#ifdef UCII_SHA_NI_AVAILABLE
+    if(cpuSupportsShaNi()){
+        return compressShaNi;
+    }
+#endif
+    return compressPortable;
+}
+
+// Block function in use, selected once at startup
+static CompressFunction selectedCompress = selectCompress();
+
+static inline void compress(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count){
+    selectedCompress(state, blocks, count);
+}
+
+Sha256::Sha256(){
+    reset();
+}
+
+void Sha256::reset(){
+    static const std::uint32_t initialState[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    std::memcpy(state, initialState, sizeof(state));
+    bufferLength = 0;
+    totalLength = 0;
+}
+
+void Sha256::update(const void* data, std::size_t length){
+    const std::uint8_t* input = static_cast<const std::uint8_t*>(data);
+    totalLength += length;
+
+    // Complete the partially filled block first
+    if(bufferLength > 0){
+        std::size_t fill = 64 - bufferLength;
+        if(length < fill){
+            std::memcpy(buffer + bufferLength, input, length);
+            bufferLength += length;
+            return;
+        }
+
+        std::memcpy(buffer + bufferLength, input, fill);
+        compress(state, buffer, 1);
+        input += fill;
+        length -= fill;
+        bufferLength = 0;
+    }
+
+    // Hash the whole blocks directly from the input
+    std::size_t blocks = length / 64;
+    if(blocks > 0){
+        compress(state, input, blocks);
+        input += blocks * 64;
+        length -= blocks * 64;
+    }
+
+    std::memcpy(buffer, input, length);
+    bufferLength = length;
+}
+
+void Sha256::finish(std::uint8_t digest[32]){
+    std::uint64_t bitLength = totalLength * 8;
+
+    // Pad with 0x80, zeros and the big endian bit length
+    std::uint8_t padding[72] = {0x80};
+    std::size_t paddingLength = (bufferLength < 56) ? (56 - bufferLength) : (120 - bufferLength);
+    for(int i = 0; i < 8; i++){
+        padding[paddingLength + i] = static_cast<std::uint8_t>(bitLength >> (56 - i * 8));
+    }
+    update(padding, paddingLength + 8);
+
+    for(int i = 0; i < 8; i++){
+        digest[i * 4] = static_cast<std::uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<std::uint8_t>(state[i]);
+    }
+}
+
+std::string Sha256::hexDigest(){
+    std::uint8_t digest[32];
+    finish(digest);
+    return toHex(digest);
+}
+
+std::string Sha256::toHex(const std::uint8_t digest[32]){
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string text(64, '0');
+
+    for(std::size_t i = 0; i < 32; i++){
+        text[i * 2] = hexDigits[digest[i] >> 4];
+        text[i * 2 + 1] = hexDigits[digest[i] & 0x0F];
+    }
+
+    return text;
+}
+
+bool Sha256::fromHex(std::string_view text, std::uint8_t digest[32]){
+    if(text.size() != 64){
+        return false;
+    }
+
+    for(std::size_t i = 0; i < 32; i++){
+        int value = 0;
+        for(std::size_t j = 0; j < 2; j++){
+            char c = text[i * 2 + j];
+            value <<= 4;
+            if(c >= '0' && c <= '9') value |= c - '0';
+            else if(c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if(c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        digest[i] = static_cast<std::uint8_t>(value);
+    }
+
+    return true;
+}
+
+const char* Sha256::implementation(){
+    return selectedCompress == compressPortable ? "portable" : "sha-ni";
+}
+
+void Sha256::usePortable(bool portable){
+    selectedCompress = portable ? compressPortable : selectCompress();
+}
@@ -0,0 +1,74 @@
+/**
+ * @file sha256.h
+ * @brief This header file contains the declarations of the streaming sha256 hasher class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @class Sha256
+ * @brief This class computes the sha256 digest of the data passed in arbitrary sized chunks. The block function is selected
+ * once at runtime: the x86 SHA extensions (SHA-NI) are used when the cpu supports them, a portable implementation otherwise.
+ */
+class Sha256
+{
+public:
+    Sha256();
+
+    /**
+     * @brief restarts the digest computation.
+    */
+    void reset();
+
+    /**
+     * @brief hashes the next chunk of the data.
+    */
+    void update(const void* data, std::size_t length);
+
+    /**
+     * @brief finishes the computation and writes the 32 byte digest. The hasher must be reset before it is reused.
+    */
+    void finish(std::uint8_t digest[32]);
+
+    /**
+     * @brief finishes the computation and returns the digest as lowercase hexadecimal text.
+    */
+    std::string hexDigest();
+
+    /**
+     * @brief returns the name of the block function in use ("sha-ni" or "portable").
+    */
+    static const char* implementation();
+
+    /**
+     * @brief forces the portable block function (e.g. to compare the implementations), must not be called while hashing.
+    */
+    static void usePortable(bool portable);
+
+    /**
+     * @brief converts 32 raw bytes into lowercase hexadecimal text.
+    */
+    static std::string toHex(const std::uint8_t digest[32]);
+
+    /**
+     * @brief converts 64 hexadecimal characters (either case) into 32 raw bytes.
+     * @return false if the text is not a hexadecimal sha256 digest.
+    */
+    static bool fromHex(std::string_view text, std::uint8_t digest[32]);
+
+private:
+    std::uint32_t state[8];
+    std::uint8_t buffer[64];
+    std::size_t bufferLength{0};
+    std::uint64_t totalLength{0};
+};
+
+#endif // SHA256_H
@@ -0,0 +1,169 @@
+/**
+ * @file audittest.cpp
+ * @brief This source file contains the test case of the audit of a local image mirror against the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include "mirroraudit.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+namespace
+{
+
+#define feed_updated "Mon, 05 Oct 2026 10:00:00 +0000"
+
+std::string digestOf(const std::string& content){
+    Sha256 hasher;
+    hasher.update(content.data(), content.size());
+    return hasher.hexDigest();
+}
+
+// Writes the file below the root, creating its directories
+void place(const UCIITest::TemporaryDirectory& root, const std::string& path, const std::string& content){
+    std::filesystem::path filePath = std::filesystem::path(root.path()) / path;
+    std::filesystem::create_directories(filePath.parent_path());
+    UCIITest::writeFile(filePath.string(), content);
+}
+
+// Result and detail of every reported path
+std::map<std::string, std::string> auditOf(MirrorAudit& audit, std::size_t& problems){
+    std::map<std::string, std::string> results;
+    std::vector<std::string> order;
+    problems = audit.run([&](const MirrorAudit::Entry& entry){
+        results[entry.path] = std::string(MirrorAudit::resultName(entry.result)) + (entry.detail.empty() ? "" : " " + entry.detail);
+        order.push_back(entry.path);
+    });
+
+    // The expected files come in path order, the extra files after them
+    std::size_t firstExtra = order.size();
+    for(std::size_t index = 0; index < order.size(); index++){
+        if(results[order[index]] == "EXTRA" && firstExtra == order.size()){
+            firstExtra = index;
+        }
+    }
+    expect_that(std::is_sorted(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(firstExtra)));
+    expect_that(std::is_sorted(order.begin() + static_cast<std::ptrdiff_t>(firstExtra), order.end()));
+    return results;
+}
+
+void testClassification(unsigned workers){
+    UCIITest::TemporaryDirectory root;
+    std::string content = "disk image";
+    // Larger than the mapped files, hashed by the double buffered hasher
+    std::string large(16 * 1024 * 1024 + 1, 'x');
+
+    place(root, "ok.img", content);
+    place(root, "large/ok.img", large);
+    place(root, "large/flipped.img", large.substr(1) + "y");
+    place(root, "short.img", content.substr(1));
+    place(root, "flipped.img", "disk imagE");
+    place(root, "sizeonly.img", content);
+    place(root, "directory.img/inside", content);
+    place(root, "filtered.img", content);
+    place(root, "extra.img", content);
+    place(root, "nested/deeper/extra.img", content);
+    // The simplestreams metadata of the mirror is not an extra file
+    place(root, "streams/v1/index.json", "{}");
+
+    MirrorAudit audit(root.path(), workers);
+    audit.expect("ok.img", digestOf(content), content.size());
+    // The same path of several versions is checked once
+    audit.expect("ok.img", digestOf(content), content.size());
+    audit.expect("large/ok.img", digestOf(large), large.size());
+    audit.expect("large/flipped.img", digestOf(large), large.size());
+    audit.expect("missing.img", digestOf(content), content.size());
+    audit.expect("short.img", digestOf(content), content.size());
+    audit.expect("flipped.img", digestOf(content), content.size());
+    audit.expect("sizeonly.img", "", content.size());
+    audit.expect("directory.img", digestOf(content), content.size());
+    audit.ignore("filtered.img");
+
+    std::size_t problems = 0;
+    std::map<std::string, std::string> results = auditOf(audit, problems);
+
+    expect_that(results["ok.img"] == "OK");
+    expect_that(results["large/ok.img"] == "OK");
+    expect_that(results["large/flipped.img"] == "CORRUPT sha256");
+    expect_that(results["missing.img"] == "MISSING");
+    expect_that(results["short.img"] == "CORRUPT size 9 instead of 10");
+    expect_that(results["flipped.img"] == "CORRUPT sha256");
+    expect_that(results["sizeonly.img"] == "OK");
+    expect_that(results["directory.img"].compare(0, 10, "UNREADABLE") == 0);
+    expect_that(results["extra.img"] == "EXTRA");
+    expect_that(results["nested/deeper/extra.img"] == "EXTRA");
+    expect_that(results["directory.img/inside"] == "EXTRA");
+    expect_that(results.count("filtered.img") == 0);
+    expect_that(results.count("streams/v1/index.json") == 0);
+    expect_that(results.size() == 11);
+    expect_that(problems == 8);
+
+    // The files of a different size and the one checked by its size alone are not hashed
+    expect_that(audit.filesHashed() == 4);
+    expect_that(audit.bytesHashed() == 2 * large.size() + 2 * content.size());
+}
+
+void testExitStatus(){
+    UCIITest::TemporaryDirectory root;
+    std::string noble = "noble image";
+    std::string jammy = "jammy image";
+    std::string feed = UCIITest::feedDocument(feed_updated, {
+        {"noble", "20261001", digestOf(noble), noble.size(), "server/releases/noble/release-20261001/disk1.img"},
+        {"jammy", "20261001", digestOf(jammy), jammy.size(), "server/releases/jammy/release-20261001/disk1.img"}
+    });
+    place(root, "streams/v1/com.ubuntu.cloud:released:download.json", feed);
+    place(root, "server/releases/noble/release-20261001/disk1.img", noble);
+    place(root, "server/releases/jammy/release-20261001/disk1.img", jammy);
+
+    UCIITest::Arguments arguments{
+        {source_key, root.path() + "/streams/v1/com.ubuntu.cloud:released:download.json"},
+        {no_cache_key, std::string()},
+        {audit_key, root.path()},
+        {jobs_key, 2u}
+    };
+    std::string output;
+
+    // A complete mirror
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 0);
+    expect_that(output.find("2 files ok, 0 missing") != std::string::npos);
+
+    // An extra file is reported but does not fail the audit
+    place(root, "server/releases/noble/release-20261001/notes.txt", "notes");
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 0);
+    expect_that(output.find("EXTRA server/releases/noble/release-20261001/notes.txt") != std::string::npos);
+
+    // A corrupt file fails it
+    place(root, "server/releases/jammy/release-20261001/disk1.img", "jammy imagE");
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 1);
+    expect_that(output.find("CORRUPT server/releases/jammy/release-20261001/disk1.img") != std::string::npos);
+
+    // Unless the filter leaves it out, then it is not an extra file either
+    arguments[where_key] = std::string("release=24.04");
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 0);
+    expect_that(output.find("jammy") == std::string::npos);
+
+    // A missing file fails it
+    std::filesystem::remove(std::filesystem::path(root.path()) / "server/releases/noble/release-20261001/disk1.img");
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 1);
+    expect_that(output.find("MISSING server/releases/noble/release-20261001/disk1.img") != std::string::npos);
+
+    // An invalid filter fails before anything is read
+    arguments[where_key] = std::string("colour=red");
+    expect_that(UCIITest::runOperation(UCIIParser::Audit, arguments, output) == 1);
+    expect_that(output.find("Invalid query") != std::string::npos);
+}
+
+}
+
+void testAudit(){
+    testClassification(1);
+    testClassification(4);
+    testExitStatus();
+}
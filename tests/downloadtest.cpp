@@ -0,0 +1,117 @@
+/**
+ * @file downloadtest.cpp
+ * @brief This source file contains the test case of the download of an image by concurrent range requests
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+#include "standinserver.h"
+
+#include "sha256.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+
+#define feed_path "/streams/v1/com.ubuntu.cloud:released:download.json"
+#define image_path "server/releases/noble/release-20261001/disk1.img"
+
+// Four ranges of 1 MiB, the last one short
+std::string imageContent(){
+    std::string content(3 * 1024 * 1024 + 123, '\0');
+    std::uint32_t state = 88172645u;
+    for(char& c : content){
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        c = static_cast<char>(state);
+    }
+    return content;
+}
+
+std::string digestOf(const std::string& content){
+    Sha256 hasher;
+    hasher.update(content.data(), content.size());
+    return hasher.hexDigest();
+}
+
+bool exists(const std::string& path){
+    std::error_code error;
+    return std::filesystem::exists(path, error);
+}
+
+}
+
+void testDownload(){
+    StandInServer server;
+    if(!expect_that(server.start())){
+        return;
+    }
+
+    std::string image = imageContent();
+    server.serve(feed_path, UCIITest::feedDocument("Mon, 05 Oct 2026 10:00:00 +0000", {{"noble", "20261001", digestOf(image), image.size(), image_path}}));
+    server.serve("/" image_path, image);
+
+    UCIITest::TemporaryDirectory directory;
+    std::string destination = directory.file("disk1.img");
+    UCIITest::Arguments arguments{
+        {source_key, server.url(feed_path)},
+        {cache_dir_key, directory.file("cache")},
+        {max_age_key, 3600L},
+        {download_key, destination},
+        {release_title_key, std::string()},
+        {release_codename_key, std::string("Noble Numbat")},
+        {version_key, std::string("20261001")},
+        {connections_key, 3u},
+        {chunk_size_key, 1u}
+    };
+    std::string output;
+
+    // Every range is requested once, the json file is cached and not requested again by the next downloads
+    expect_that(UCIITest::runOperation(UCIIParser::Download, arguments, output) == 0);
+    expect_that(output.find("OK: " + destination) != std::string::npos);
+    expect_that(server.rangeRequests() == 4);
+    expect_that(UCIITest::readFile(destination) == image);
+
+    // Failed ranges are requested again
+    std::filesystem::remove(destination);
+    server.resetCounters();
+    server.failNext(2, 503);
+    expect_that(UCIITest::runOperation(UCIIParser::Download, arguments, output) == 0);
+    expect_that(server.failed() == 2 && server.rangeRequests() == 4 && server.requests() == 6);
+    expect_that(UCIITest::readFile(destination) == image);
+
+    // A range failing every attempt fails the download, nothing is left behind
+    std::filesystem::remove(destination);
+    server.resetCounters();
+    server.failNext(100, 503);
+    expect_that(UCIITest::runOperation(UCIIParser::Download, arguments, output) == 1);
+    expect_that(output.find("Could not download the image: Range") != std::string::npos);
+    expect_that(output.find("server answered 503") != std::string::npos);
+    expect_that(!exists(destination) && !exists(destination + ".part"));
+    server.failNext(0);
+
+    // A server ignoring the ranges answers the whole file, it is downloaded by a single request instead
+    server.resetCounters();
+    server.acceptRanges(false);
+    expect_that(UCIITest::runOperation(UCIIParser::Download, arguments, output) == 0);
+    expect_that(server.rangeRequests() == 0);
+    expect_that(output.find("over 1 connections") != std::string::npos);
+    expect_that(UCIITest::readFile(destination) == image);
+    server.acceptRanges(true);
+
+    // An image that does not match the catalog is removed, by both ways of downloading it
+    std::string corrupt = image;
+    corrupt[corrupt.size() / 2] ^= 1;
+    server.serve("/" image_path, corrupt);
+    for(bool ranges : {true, false}){
+        std::filesystem::remove(destination);
+        server.acceptRanges(ranges);
+        expect_that(UCIITest::runOperation(UCIIParser::Download, arguments, output) == 1);
+        expect_that(output.find("MISMATCH: " + destination + " is removed") != std::string::npos);
+        expect_that(!exists(destination) && !exists(destination + ".part"));
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ * @file hashtest.cpp
+ * @brief This source file contains the test case of the sha256 block functions and of the double buffered file hasher
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include "filehasher.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+#define eight_mebibytes (8 * 1024 * 1024)
+
+struct KnownAnswer{
+    std::string message;
+    const char* digest;
+};
+
+// The sha256 examples of FIPS 180-2, the one million 'a' message crosses many blocks
+std::vector<KnownAnswer> knownAnswers(){
+    return {
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+        {std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"}
+    };
+}
+
+std::string digestOf(std::string_view message, std::size_t chunkSize){
+    Sha256 hasher;
+    for(std::size_t offset = 0; offset < message.size(); offset += chunkSize){
+        hasher.update(message.data() + offset, std::min(chunkSize, message.size() - offset));
+    }
+    return hasher.hexDigest();
+}
+
+void testKnownAnswers(){
+    for(const KnownAnswer& answer : knownAnswers()){
+        // At once, byte by byte and in chunks that never end on a block boundary
+        expect_that(digestOf(answer.message, answer.message.size() + 1) == answer.digest);
+        if(answer.message.size() < 1000){
+            expect_that(digestOf(answer.message, 1) == answer.digest);
+        }
+        expect_that(digestOf(answer.message, 63) == answer.digest);
+        expect_that(digestOf(answer.message, 65) == answer.digest);
+    }
+
+    // A hasher is reused after a reset
+    Sha256 hasher;
+    hasher.update("abc", 3);
+    hasher.hexDigest();
+    hasher.reset();
+    hasher.update("abc", 3);
+    expect_that(hasher.hexDigest() == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+// A file of the given size, its content is not periodic in the block size
+std::string fileContent(std::size_t size){
+    std::string content(size, '\0');
+    std::uint32_t state = 2463534242u;
+    for(char& c : content){
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        c = static_cast<char>(state);
+    }
+    return content;
+}
+
+void testFileHasher(){
+    UCIITest::TemporaryDirectory directory;
+    FileHasher fileHasher;
+
+    // Empty, one byte short of a buffer, exactly a buffer and one byte over a buffer
+    for(std::size_t size : {std::size_t(0), std::size_t(eight_mebibytes - 1), std::size_t(eight_mebibytes), std::size_t(eight_mebibytes + 1)}){
+        std::string content = fileContent(size);
+        std::string path = directory.file("image_" + std::to_string(size));
+        if(!expect_that(UCIITest::writeFile(path, content))){
+            continue;
+        }
+
+        std::uint8_t digest[32];
+        if(!expect_that(fileHasher.hash(path, digest))){
+            std::cerr << fileHasher.errorMessage() << std::endl;
+            continue;
+        }
+        expect_that(Sha256::toHex(digest) == digestOf(content, content.size() + 1));
+        expect_that(fileHasher.bytesHashed() == size);
+    }
+
+    // A missing file is an error
+    std::uint8_t digest[32];
+    expect_that(!fileHasher.hash(directory.file("missing"), digest));
+    expect_that(!fileHasher.errorMessage().empty());
+}
+
+}
+
+void testHashing(){
+    // Every block function available on this cpu is forced in turn
+    for(bool portable : {true, false}){
+        Sha256::usePortable(portable);
+        if(!portable && std::strcmp(Sha256::implementation(), "portable") == 0){
+            std::cerr << "The sha-ni block function is not supported by this cpu, only the portable one is tested" << std::endl;
+            continue;
+        }
+
+        testKnownAnswers();
+        testFileHasher();
+    }
+
+    Sha256::usePortable(false);
+}
@@ -0,0 +1,243 @@
+/**
+ * @file hedgetest.cpp
+ * @brief This source file contains the test case of the hedged and retried requests of the json file
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+#include "standinserver.h"
+
+#include "catalogsnapshot.h"
+#include "columnarcatalog.h"
+#include "hedgepolicy.h"
+#include "uciiparser.h"
+
+#include <filesystem>
+#include <sstream>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Every stand-in server answers with a feed of its own 'updated' field, which tells the winner apart
+#define source_updated "Mon, 05 Oct 2026 10:00:00 +0000"
+#define mirror_updated "Tue, 06 Oct 2026 10:00:00 +0000"
+
+std::string feedOf(const std::string& updated){
+    return UCIITest::feedDocument(updated, {{"noble", "20261001", std::string(64, 'a'), 1024, "server/releases/noble/disk1.img"}});
+}
+
+// Feed requests of the parser under the given settings, the catalog is null if all of them failed
+std::shared_ptr<const ColumnarCatalog> fetchCatalog(const UCIIOptions& options){
+    std::ostringstream errors, warnings;
+    UCIIParser parser;
+    parser.setMessageStreams(errors, warnings);
+    parser.configure(options);
+    return parser.columnarCatalog();
+}
+
+bool answeredBy(const std::shared_ptr<const ColumnarCatalog>& catalog, const char* updated){
+    return catalog && catalog->updated() == CatalogSnapshot::parseFeedTimestamp(updated);
+}
+
+void testPolicy(){
+    // A fake clock moved by hand
+    HedgePolicy::Clock::time_point fakeNow{};
+    auto now = [&fakeNow]{ return fakeNow; };
+
+    // The same seed draws the same backoffs, each of them within the limit of full jitter
+    HedgePolicy first(0, 2, 42, now);
+    HedgePolicy second(0, 2, 42, now);
+    for(unsigned failures = 1; failures <= 8; failures++){
+        std::chrono::milliseconds backoff = first.backoff(failures);
+        expect_that(backoff == second.backoff(failures));
+
+        long limit = failures >= 7 ? 8000 : 250L << (failures - 1);
+        expect_that(backoff.count() >= 0 && backoff.count() <= limit);
+    }
+
+    // The retry and hedge times follow the clock of the policy
+    HedgePolicy policy(0, 2, 7, now);
+    expect_that(policy.now() == fakeNow);
+    fakeNow += 10s;
+    expect_that(policy.now() == fakeNow);
+    HedgePolicy twin(0, 2, 7, now);
+    expect_that(policy.retryAt(3) == fakeNow + twin.backoff(3));
+    expect_that(policy.hedgeAt(fakeNow) == fakeNow + 1000ms);
+
+    // The adaptive delay is the smoothed time plus four deviations, within its limits
+    expect_that(policy.hedgeDelay() == 1000ms);
+    policy.recordFirstByte(0.2);
+    expect_that(policy.hedgeDelay() == 600ms);
+    policy.recordFirstByte(60);
+    expect_that(policy.hedgeDelay() == 4000ms);
+    HedgePolicy fast(0, 2, 7, now);
+    fast.recordFirstByte(0.001);
+    expect_that(fast.hedgeDelay() == 50ms);
+
+    // A restored estimate replaces the initial delay, a zero time is ignored
+    HedgePolicy restored(0, 2, 7, now);
+    restored.restore(0, 0);
+    expect_that(restored.hedgeDelay() == 1000ms);
+    restored.restore(0.1, 0.05);
+    expect_that(restored.hedgeDelay() == 300ms);
+
+    // A fixed delay does not adapt
+    HedgePolicy fixed(250, 1, 7, now);
+    fixed.recordFirstByte(3);
+    expect_that(!fixed.adaptive());
+    expect_that(fixed.hedgeDelay() == 250ms);
+    expect_that(fixed.retries() == 1);
+}
+
+void testMirrors(){
+    StandInServer source, mirror;
+    if(!expect_that(source.start() && mirror.start())){
+        return;
+    }
+    source.serve("/download.json", feedOf(source_updated));
+    mirror.serve("/download.json", feedOf(mirror_updated));
+
+    UCIIOptions options;
+    options.source = source.url("/download.json");
+    options.mirrors = mirror.url("/download.json");
+    options.cacheEnabled = false;
+    options.hedgeDelay = 100;
+    options.retries = 2;
+
+    // A healthy source answers alone
+    std::shared_ptr<const ColumnarCatalog> catalog = fetchCatalog(options);
+    expect_that(answeredBy(catalog, source_updated));
+    expect_that(source.requests() == 1 && mirror.requests() == 0);
+
+    // A failing source fails over to the mirror
+    source.resetCounters();
+    source.failNext(1);
+    catalog = fetchCatalog(options);
+    expect_that(answeredBy(catalog, mirror_updated));
+    expect_that(source.requests() == 1 && source.failed() == 1 && mirror.requests() == 1);
+
+    // A slow source is hedged by the mirror after the hedge delay, the mirror wins long before the source answers
+    source.resetCounters();
+    mirror.resetCounters();
+    source.setDelay(3000ms);
+    auto started = std::chrono::steady_clock::now();
+    catalog = fetchCatalog(options);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    expect_that(answeredBy(catalog, mirror_updated));
+    expect_that(elapsed >= 100ms && elapsed < 2000ms);
+    expect_that(source.requests() == 1 && mirror.requests() == 1);
+
+    // Both slow, the hedge is started but the source answers first and is the single winner
+    source.resetCounters();
+    mirror.resetCounters();
+    source.setDelay(400ms);
+    mirror.setDelay(1500ms);
+    catalog = fetchCatalog(options);
+    expect_that(answeredBy(catalog, source_updated));
+    expect_that(source.requests() == 1 && mirror.requests() == 1);
+    source.setDelay(0ms);
+    mirror.setDelay(0ms);
+
+    // Without a mirror the source is hedged by itself on a new connection, the hedges stop at two running requests
+    UCIIOptions single = options;
+    single.mirrors.clear();
+    source.resetCounters();
+    source.setDelay(300ms);
+    catalog = fetchCatalog(single);
+    expect_that(answeredBy(catalog, source_updated));
+    expect_that(source.requests() == 2);
+    source.setDelay(0ms);
+
+    // All of them failing, the requests stop at one per source plus the retries
+    source.resetCounters();
+    mirror.resetCounters();
+    source.failNext(10, 503);
+    mirror.failNext(10, 503);
+    catalog = fetchCatalog(options);
+    expect_that(!catalog);
+    expect_that(source.requests() + mirror.requests() == 4);
+    expect_that(source.requests() == 2 && mirror.requests() == 2);
+
+    // The retries wait for the full jitter backoff: after the failures they succeed within the cap of the backoffs
+    source.resetCounters();
+    mirror.resetCounters();
+    source.failNext(2, 503);
+    mirror.failNext(1, 503);
+    started = std::chrono::steady_clock::now();
+    catalog = fetchCatalog(options);
+    elapsed = std::chrono::steady_clock::now() - started;
+    expect_that(answeredBy(catalog, mirror_updated));
+    expect_that(source.requests() == 2 && mirror.requests() == 2);
+    expect_that(elapsed < 250ms + 500ms + 1000ms);
+
+    // No retries allowed, a single failure of each ends the attempts
+    source.resetCounters();
+    mirror.resetCounters();
+    source.failNext(10, 503);
+    mirror.failNext(10, 503);
+    options.retries = 0;
+    catalog = fetchCatalog(options);
+    expect_that(!catalog);
+    expect_that(source.requests() == 1 && mirror.requests() == 1);
+    source.failNext(0);
+    mirror.failNext(0);
+}
+
+// Path of the cached body of the source, the cache keeps a body per source url
+std::string cachedBody(const std::string& cacheDirectory){
+    for(const auto& entry : std::filesystem::directory_iterator(cacheDirectory)){
+        std::string name = entry.path().filename().string();
+        if(name.compare(0, 9, "download-") == 0 && entry.path().extension() == ".json"){
+            return entry.path().string();
+        }
+    }
+    return "";
+}
+
+void testNotModified(){
+    StandInServer source;
+    if(!expect_that(source.start())){
+        return;
+    }
+    source.serve("/download.json", feedOf(source_updated));
+
+    UCIITest::TemporaryDirectory cache;
+    UCIIOptions options;
+    options.source = source.url("/download.json");
+    options.cacheDirectory = cache.path();
+    options.maxAge = 0;
+
+    // The first request stores the body and its etag
+    expect_that(answeredBy(fetchCatalog(options), source_updated));
+    expect_that(source.requests() == 1 && source.notModified() == 0);
+
+    // The next one is revalidated by a conditional request and answered from the cache
+    source.resetCounters();
+    expect_that(answeredBy(fetchCatalog(options), source_updated));
+    expect_that(source.requests() == 1 && source.notModified() == 1);
+
+    // A torn cached body is not trusted on a 304, it is requested again unconditionally
+    std::string body = cachedBody(cache.path());
+    expect_that(!body.empty());
+    std::string content = UCIITest::readFile(body);
+    UCIITest::writeFile(body, content.substr(0, content.size() / 2));
+    source.resetCounters();
+    expect_that(answeredBy(fetchCatalog(options), source_updated));
+    expect_that(source.requests() == 2 && source.notModified() == 1);
+
+    // And the stored body is whole again
+    source.resetCounters();
+    expect_that(answeredBy(fetchCatalog(options), source_updated));
+    expect_that(source.requests() == 1 && source.notModified() == 1);
+}
+
+}
+
+void testHedging(){
+    testPolicy();
+    testMirrors();
+    testNotModified();
+}
@@ -0,0 +1,213 @@
+/**
+ * @file historytest.cpp
+ * @brief This source file contains the test case of the append-only history of the catalogs
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include "cataloghistory.h"
+#include "catalogsnapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+
+// Number of the synthetic catalogs, enough for two checkpoints by the interval
+#define catalog_count 80
+// The catalog in which every sha256 changes, its delta outgrows the checkpoint
+#define mass_change 45
+
+// 'updated' field of the feed of the given catalog, one minute apart
+std::string updatedOf(int index){
+    char text[64];
+    std::snprintf(text, sizeof(text), "Mon, 05 Oct 2026 %02d:%02d:00 +0000", 10 + index / 60, index % 60);
+    return text;
+}
+
+std::string digestOf(unsigned seed){
+    static const char digits[] = "0123456789abcdef";
+    std::string digest(64, '0');
+    std::uint32_t state = seed * 2654435761u + 1;
+    for(char& c : digest){
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        c = digits[state & 15];
+    }
+    return digest;
+}
+
+ProductView productOf(int number){
+    ProductView product;
+    std::string releaseVersion = std::to_string(10 + number / 2) + (number % 2 ? ".10" : ".04");
+    product.id = "com.ubuntu.cloud:server:" + releaseVersion + ":amd64";
+    product.arch = "amd64";
+    product.release = "release" + std::to_string(number);
+    product.releaseTitle = releaseVersion + (number % 2 ? "" : " LTS");
+    product.releaseCodename = "Codename " + std::to_string(number);
+    product.releaseVersion = releaseVersion;
+    product.supportEol = "2099-04-25";
+    product.supported = true;
+    return product;
+}
+
+VersionView versionOf(int product, int serial, unsigned shaSeed){
+    VersionView version;
+    version.version = "2026" + std::to_string(1000 + serial);
+    version.sha256 = digestOf(shaSeed);
+    version.path = "server/releases/" + std::to_string(product) + "/" + version.version + "/disk1.img";
+    version.size = 1000000 + static_cast<std::uint64_t>(serial);
+    return version;
+}
+
+// The next catalog: a new version of one product, the oldest version of another one dropped, a changed sha256, from time
+// to time a product removed or added, and once every sha256 changed
+void mutate(FeedView& view, int index){
+    ProductView& grown = view.products[static_cast<std::size_t>(index) % view.products.size()];
+    int productNumber = std::stoi(grown.release.substr(7));
+    grown.versions.push_back(versionOf(productNumber, 100 + index, static_cast<unsigned>(index * 7919)));
+
+    ProductView& shrunk = view.products[static_cast<std::size_t>(index * 3) % view.products.size()];
+    if(shrunk.versions.size() > 1){
+        shrunk.versions.erase(shrunk.versions.begin());
+    }
+
+    ProductView& changed = view.products[static_cast<std::size_t>(index * 5) % view.products.size()];
+    changed.versions.back().sha256 = digestOf(static_cast<unsigned>(index * 104729));
+
+    if(index % 9 == 0){
+        view.products.erase(view.products.begin() + (index % static_cast<int>(view.products.size())));
+    }
+    if(index % 11 == 0){
+        ProductView product = productOf(100 + index);
+        product.versions.push_back(versionOf(100 + index, 0, static_cast<unsigned>(index)));
+        view.products.push_back(std::move(product));
+    }
+    if(index == mass_change){
+        for(ProductView& product : view.products){
+            for(VersionView& version : product.versions){
+                version.sha256 = digestOf(static_cast<unsigned>(index) ^ static_cast<unsigned>(std::hash<std::string>{}(version.path)));
+            }
+        }
+    }
+
+    for(ProductView& product : view.products){
+        std::sort(product.versions.begin(), product.versions.end(), [](const VersionView& lhs, const VersionView& rhs){ return lhs.version < rhs.version; });
+    }
+    std::sort(view.products.begin(), view.products.end(), [](const ProductView& lhs, const ProductView& rhs){ return lhs.id < rhs.id; });
+    view.updated = updatedOf(index);
+}
+
+std::vector<FeedView> syntheticCatalogs(){
+    FeedView view;
+    for(int number = 0; number < 24; number++){
+        ProductView product = productOf(number);
+        for(int serial = 0; serial < 12; serial++){
+            product.versions.push_back(versionOf(number, serial, static_cast<unsigned>(number * 100 + serial)));
+        }
+        view.products.push_back(std::move(product));
+    }
+    std::sort(view.products.begin(), view.products.end(), [](const ProductView& lhs, const ProductView& rhs){ return lhs.id < rhs.id; });
+    view.updated = updatedOf(0);
+
+    std::vector<FeedView> catalogs{view};
+    for(int index = 1; index < catalog_count; index++){
+        mutate(view, index);
+        catalogs.push_back(view);
+    }
+    return catalogs;
+}
+
+bool sameCatalog(const FeedView& lhs, const FeedView& rhs){
+    if(lhs.updated != rhs.updated || lhs.products.size() != rhs.products.size()){
+        return false;
+    }
+    for(std::size_t i = 0; i < lhs.products.size(); i++){
+        const ProductView& left = lhs.products[i];
+        const ProductView& right = rhs.products[i];
+        if(left.id != right.id || left.arch != right.arch || left.releaseTitle != right.releaseTitle || left.releaseCodename != right.releaseCodename ||
+           left.release != right.release || left.releaseVersion != right.releaseVersion || left.supportEol != right.supportEol ||
+           left.supported != right.supported || left.versions.size() != right.versions.size() || left.fingerprint != versionsFingerprint(right.versions)){
+            return false;
+        }
+        for(std::size_t j = 0; j < left.versions.size(); j++){
+            const VersionView& a = left.versions[j];
+            const VersionView& b = right.versions[j];
+            if(a.version != b.version || a.sha256 != b.sha256 || a.path != b.path || a.size != b.size){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Every stamp and the time between two stamps rebuild the catalog recorded at that stamp
+void expectAsOf(CatalogHistory& history, const std::vector<FeedView>& catalogs, std::size_t count){
+    for(std::size_t index = 0; index < count; index++){
+        std::time_t at = CatalogSnapshot::parseFeedTimestamp(catalogs[index].updated);
+        FeedView view;
+        if(!expect_that(history.load(at, view))){
+            std::cerr << history.errorMessage() << std::endl;
+            continue;
+        }
+        expect_that(sameCatalog(view, catalogs[index]));
+        expect_that(history.load(at + 30, view) && sameCatalog(view, catalogs[index]));
+    }
+}
+
+}
+
+void testHistory(){
+    UCIITest::TemporaryDirectory directory;
+    std::string path = directory.file("history.bin");
+    std::vector<FeedView> catalogs = syntheticCatalogs();
+
+    CatalogHistory history(path);
+    for(std::size_t index = 0; index < catalogs.size(); index++){
+        expect_that(history.record(catalogs[index], 0));
+        expect_that(history.appended());
+
+        // The same feed again is not recorded twice
+        expect_that(history.record(catalogs[index], 0));
+        expect_that(!history.appended());
+    }
+    if(!expect_that(history.scan() && history.records().size() == catalogs.size())){
+        return;
+    }
+
+    // Checkpoints start the history, follow every 32 records and follow a delta larger than the last checkpoint
+    std::size_t lastCheckpoint = 0;
+    for(std::size_t index = 0; index < history.records().size(); index++){
+        bool expected = index == 0 || index == mass_change || index - lastCheckpoint == 32;
+        expect_that((history.records()[index].kind == CatalogHistory::Kind::Checkpoint) == expected);
+        if(expected){
+            lastCheckpoint = index;
+        }
+    }
+    expect_that(history.records()[32].kind == CatalogHistory::Kind::Checkpoint);
+    expect_that(history.records()[mass_change + 32].kind == CatalogHistory::Kind::Checkpoint);
+
+    // Nothing is recorded before the first stamp
+    FeedView view;
+    expect_that(!history.load(CatalogSnapshot::parseFeedTimestamp(catalogs[0].updated) - 1, view));
+
+    expectAsOf(history, catalogs, catalogs.size());
+
+    // A record torn by a few bytes is dropped, the catalogs before it are intact
+    std::uint64_t fullSize = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, fullSize - 5);
+    expect_that(history.scan() && history.records().size() == catalogs.size() - 1);
+    expect_that(history.load(CatalogSnapshot::parseFeedTimestamp(catalogs.back().updated), view) && sameCatalog(view, catalogs[catalogs.size() - 2]));
+
+    // The next append overwrites the torn record
+    expect_that(history.record(catalogs.back(), 0) && history.appended());
+    expect_that(std::filesystem::file_size(path) == fullSize);
+    expect_that(history.scan() && history.records().size() == catalogs.size());
+    expectAsOf(history, catalogs, catalogs.size());
+}
@@ -0,0 +1,199 @@
+/**
+ * @file querytest.cpp
+ * @brief This source file contains the test case of the filter and projection query over the catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include "catalog.h"
+#include "catalogquery.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+
+struct Release{
+    const char* version;
+    const char* release;
+    const char* codename;
+    const char* title;
+};
+
+const Release releases[] = {
+    {"20.04", "focal", "Focal Fossa", "20.04 LTS"},
+    {"22.04", "jammy", "Jammy Jellyfish", "22.04 LTS"},
+    {"24.04", "noble", "Noble Numbat", "24.04 LTS"}
+};
+
+ProductView productOf(const Release& release, const std::string& arch){
+    ProductView product;
+    product.id = std::string("com.ubuntu.cloud:server:") + release.version + ":" + arch;
+    product.arch = arch;
+    product.release = release.release;
+    product.releaseCodename = release.codename;
+    product.releaseTitle = release.title;
+    product.releaseVersion = release.version;
+    product.supportEol = "2099-04-25";
+    product.supported = true;
+
+    // Two versions, each with a disk image, a squashfs and a manifest
+    std::uint64_t size = 1000;
+    for(const char* serial : {"20260101", "20260201"}){
+        VersionView version;
+        version.version = serial;
+        for(const char* item : {"disk1.img", "manifest", "squashfs"}){
+            ItemView itemView;
+            itemView.name = item;
+            itemView.ftype = item == std::string("disk1.img") ? "disk1.img" : item;
+            itemView.sha256 = std::string(64, static_cast<char>('a' + size % 6));
+            itemView.path = "server/releases/" + std::string(release.release) + "/release-" + serial + "/" + arch + "/" + item;
+            itemView.size = size++;
+            version.items.push_back(itemView);
+        }
+        version.sha256 = version.items.front().sha256;
+        version.path = version.items.front().path;
+        version.size = version.items.front().size;
+        product.versions.push_back(std::move(version));
+    }
+    product.fingerprint = versionsFingerprint(product.versions);
+    return product;
+}
+
+// Three releases in amd64, two of them in arm64 and one in s390x
+std::unique_ptr<Catalog> testCatalog(){
+    FeedView view;
+    view.updated = "Mon, 05 Oct 2026 10:00:00 +0000";
+    for(const Release& release : releases){
+        view.products.push_back(productOf(release, "amd64"));
+    }
+    view.products.push_back(productOf(releases[0], "arm64"));
+    view.products.push_back(productOf(releases[2], "arm64"));
+    view.products.push_back(productOf(releases[1], "s390x"));
+    std::sort(view.products.begin(), view.products.end(), [](const ProductView& lhs, const ProductView& rhs){ return lhs.id < rhs.id; });
+    return std::make_unique<Catalog>(std::move(view));
+}
+
+// Rows of the query, the values of a row joined by spaces, empty with the error message if it does not compile
+std::vector<std::string> rowsOf(const Catalog& catalog, CatalogQuery& query, const std::string& where, const std::string& select){
+    std::vector<std::string> rows;
+    if(!query.compile(where, select)){
+        std::cerr << "Query '" << where << "' '" << select << "': " << query.errorMessage() << std::endl;
+        return rows;
+    }
+
+    query.run(catalog, [&rows](const std::vector<std::string_view>& values){
+        std::string row;
+        for(std::string_view value : values){
+            row += (row.empty() ? "" : " ") + std::string(value);
+        }
+        rows.push_back(row);
+    });
+    return rows;
+}
+
+bool rejected(const std::string& where, const std::string& select, const std::string& message){
+    CatalogQuery query;
+    return !query.compile(where, select) && query.errorMessage().find(message) != std::string::npos;
+}
+
+void testGrammar(){
+    // Conditions without a field, an operator or a value
+    expect_that(rejected("arch", "", "expected <field><operator><value>"));
+    expect_that(rejected("=amd64", "", "expected <field><operator><value>"));
+    expect_that(rejected("arch=", "", "Invalid condition 'arch='"));
+    expect_that(rejected("release>= ", "", "Invalid condition"));
+
+    // Unknown fields and columns
+    expect_that(rejected("colour=red", "", "Unknown field 'colour'"));
+    expect_that(rejected("", "version,colour", "Unknown column 'colour'"));
+    expect_that(rejected("", ", ,", "No column is selected"));
+
+    // Operators that do not apply to the field, sizes that are not numbers
+    expect_that(rejected("arch>amd64", "", "can only be compared by '=' or '!='"));
+    expect_that(rejected("sha256<=abc", "", "can only be compared by '=' or '!='"));
+    expect_that(rejected("size>1k", "", "Size must be a number of bytes"));
+    expect_that(rejected("size=12a", "", "Size must be a number of bytes"));
+
+    // A failed compile leaves nothing behind, the next one starts over
+    CatalogQuery query;
+    expect_that(!query.compile("colour=red", ""));
+    expect_that(query.compile("  arch = amd64 , release>=22.04 ", " version , sha256 "));
+    expect_that(query.errorMessage().empty());
+    expect_that((query.selectedColumns() == std::vector<std::string>{"version", "sha256"}));
+    expect_that(query.compile("", ""));
+    expect_that((query.selectedColumns() == std::vector<std::string>{"title", "arch", "version", "item", "sha256"}));
+}
+
+void testLevels(const Catalog& catalog){
+    CatalogQuery query;
+
+    // The row is the deepest level used by the filter or the projection
+    expect_that(rowsOf(catalog, query, "", "title,arch").size() == 6);
+    expect_that(rowsOf(catalog, query, "", "title,version").size() == 12);
+    expect_that(rowsOf(catalog, query, "", "").size() == 36);
+    expect_that(rowsOf(catalog, query, "version=20260201", "title").size() == 6);
+    expect_that(rowsOf(catalog, query, "item=disk1.img", "title").size() == 12);
+
+    // Releases compare numerically, codenames without case and by either name
+    expect_that((rowsOf(catalog, query, "release>=22.04,arch=amd64", "codename") == std::vector<std::string>{"jammy", "noble"}));
+    expect_that(rowsOf(catalog, query, "release<=20.04", "title").size() == 2);
+    expect_that(rowsOf(catalog, query, "release=2?.04", "title").size() == 6);
+    expect_that(rowsOf(catalog, query, "codename=FOCAL", "arch").size() == 2);
+    expect_that((rowsOf(catalog, query, "codename=noble numbat,arch=arm64", "release_codename,arch") == std::vector<std::string>{"Noble Numbat arm64"}));
+    expect_that(rowsOf(catalog, query, "codename!=focal|jammy", "title").size() == 2);
+
+    // Wildcards and alternatives of the items, sizes compare numerically
+    expect_that(rowsOf(catalog, query, "arch=amd64,item=*.img|squash*", "item").size() == 12);
+    expect_that(rowsOf(catalog, query, "arch=amd64,version=20260101,item=manifest", "path").size() == 3);
+    expect_that((rowsOf(catalog, query, "arch=amd64,release=20.04,size>=1004,size<1006", "version,item,size") == std::vector<std::string>{"20260201 manifest 1004", "20260201 squashfs 1005"}));
+    expect_that(rowsOf(catalog, query, "size=1000", "arch").size() == 6);
+
+    // Projected values of every level
+    std::vector<std::string> rows = rowsOf(catalog, query, "arch=s390x,version=20260101,item=disk1.img", "title,codename,release_codename,arch,version,item,ftype,path,size");
+    expect_that((rows == std::vector<std::string>{"22.04 LTS jammy Jammy Jellyfish s390x 20260101 disk1.img disk1.img server/releases/jammy/release-20260101/s390x/disk1.img 1000"}));
+}
+
+void testPartitions(const Catalog& catalog){
+    CatalogQuery query;
+
+    // A plain architecture visits its partition only
+    expect_that(rowsOf(catalog, query, "arch=arm64", "codename") == (std::vector<std::string>{"focal", "noble"}));
+    expect_that(query.productsVisited() == 2);
+    expect_that(rowsOf(catalog, query, "arch=arm64|s390x", "arch").size() == 3);
+    expect_that(query.productsVisited() == 3);
+
+    // Repeated names are visited once, several conditions intersect
+    expect_that(rowsOf(catalog, query, "arch=arm64|arm64", "arch").size() == 2);
+    expect_that(query.productsVisited() == 2);
+    expect_that(rowsOf(catalog, query, "arch=arm64|amd64,arch=amd64", "arch").size() == 3);
+    expect_that(query.productsVisited() == 3);
+    expect_that(rowsOf(catalog, query, "arch=arm64,arch=amd64", "arch").empty());
+    expect_that(query.productsVisited() == 0);
+
+    // An architecture not in the catalog visits nothing
+    expect_that(rowsOf(catalog, query, "arch=ppc64el", "arch").empty());
+    expect_that(query.productsVisited() == 0);
+
+    // Wildcards and negations can not select a partition, every product is visited
+    expect_that(rowsOf(catalog, query, "arch=arm*", "arch").size() == 2);
+    expect_that(query.productsVisited() == 6);
+    expect_that(rowsOf(catalog, query, "arch!=amd64", "arch").size() == 3);
+    expect_that(query.productsVisited() == 6);
+    expect_that(rowsOf(catalog, query, "", "arch").size() == 6);
+    expect_that(query.productsVisited() == 6);
+}
+
+}
+
+void testQuery(){
+    testGrammar();
+
+    std::unique_ptr<Catalog> catalog = testCatalog();
+    testLevels(*catalog);
+    testPartitions(*catalog);
+}
@@ -0,0 +1,254 @@
+/**
+ * @file standinserver.cpp
+ * @brief This source file contains the definitions of the loopback http server standing in for the mirrors in the tests
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "standinserver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+
+bool sendAll(int descriptor, const char* data, std::size_t length){
+    while(length > 0){
+        ssize_t sent = ::send(descriptor, data, length, 0);
+        if(sent <= 0){
+            return false;
+        }
+        data += sent;
+        length -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+// Value of the given header of a request, empty if it is not present
+std::string headerOf(const std::string& request, const std::string& name){
+    std::istringstream lines(request);
+    std::string line;
+    while(std::getline(lines, line)){
+        if(!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        if(line.size() > name.size() + 1 && line.compare(0, name.size(), name) == 0 && line[name.size()] == ':'){
+            std::size_t start = line.find_first_not_of(' ', name.size() + 1);
+            return start == std::string::npos ? "" : line.substr(start);
+        }
+    }
+    return "";
+}
+
+const char* reasonOf(int status){
+    switch(status){
+        case 200: return "OK";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 404: return "Not Found";
+        case 503: return "Service Unavailable";
+        default: return "Internal Server Error";
+    }
+}
+
+}
+
+StandInServer::~StandInServer(){
+    stop();
+}
+
+bool StandInServer::start(){
+    listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(listener < 0){
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    if(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 64) != 0
+    || ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0){
+        ::close(listener);
+        listener = -1;
+        return false;
+    }
+    port = ntohs(address.sin_port);
+
+    stopping = false;
+    acceptor = std::thread(&StandInServer::acceptLoop, this);
+
+    return true;
+}
+
+void StandInServer::stop(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stopped.notify_all();
+
+    if(acceptor.joinable()){
+        acceptor.join();
+    }
+    for(std::thread& connection : connections){
+        connection.join();
+    }
+    connections.clear();
+
+    if(listener >= 0){
+        ::close(listener);
+        listener = -1;
+    }
+}
+
+std::string StandInServer::url(const std::string& path) const{
+    return "http://127.0.0.1:" + std::to_string(port) + path;
+}
+
+void StandInServer::serve(const std::string& path, std::string body){
+    std::lock_guard<std::mutex> lock(mutex);
+    files[path] = std::move(body);
+}
+
+void StandInServer::setDelay(std::chrono::milliseconds t_delay){
+    std::lock_guard<std::mutex> lock(mutex);
+    delay = t_delay;
+}
+
+void StandInServer::failNext(unsigned count, int status){
+    std::lock_guard<std::mutex> lock(mutex);
+    failures = count;
+    failureStatus = status;
+}
+
+void StandInServer::acceptRanges(bool accept){
+    std::lock_guard<std::mutex> lock(mutex);
+    ranges = accept;
+}
+
+void StandInServer::resetCounters(){
+    requestCount = 0;
+    notModifiedCount = 0;
+    failedCount = 0;
+    rangeCount = 0;
+}
+
+void StandInServer::acceptLoop(){
+    while(!stopping){
+        pollfd descriptor{listener, POLLIN, 0};
+        if(::poll(&descriptor, 1, 20) <= 0){
+            continue;
+        }
+
+        int connection = ::accept(listener, nullptr, nullptr);
+        if(connection >= 0){
+            connections.emplace_back(&StandInServer::answer, this, connection);
+        }
+    }
+}
+
+void StandInServer::answer(int descriptor){
+    // Requests carry no body, the headers end by an empty line
+    std::string request;
+    char buffer[4096];
+    while(request.find("\r\n\r\n") == std::string::npos && !stopping){
+        pollfd readable{descriptor, POLLIN, 0};
+        if(::poll(&readable, 1, 20) <= 0){
+            continue;
+        }
+        ssize_t received = ::recv(descriptor, buffer, sizeof(buffer), 0);
+        if(received <= 0){
+            ::close(descriptor);
+            return;
+        }
+        request.append(buffer, static_cast<std::size_t>(received));
+    }
+    requestCount++;
+
+    std::istringstream requestLine(request);
+    std::string method, path;
+    requestLine >> method >> path;
+
+    int status = 200;
+    std::string body;
+    std::string etag;
+    std::string extraHeaders;
+    {
+        // The response is decided when the request arrives, a delayed response does not take the failures of the
+        // requests that arrive while it waits
+        std::unique_lock<std::mutex> lock(mutex);
+        std::chrono::milliseconds t_delay = delay;
+
+        auto file = files.find(path);
+        if(failures > 0){
+            failures--;
+            failedCount++;
+            status = failureStatus;
+        }
+        else if(file == files.end()){
+            status = 404;
+        }
+        else{
+            etag = "\"" + std::to_string(std::hash<std::string>{}(file->second)) + "\"";
+            std::string range = headerOf(request, "Range");
+            if(headerOf(request, "If-None-Match") == etag){
+                status = 304;
+                notModifiedCount++;
+            }
+            else if(ranges && range.compare(0, 6, "bytes=") == 0){
+                rangeCount++;
+                std::size_t separator = range.find('-');
+                std::uint64_t first = std::strtoull(range.c_str() + 6, nullptr, 10);
+                std::uint64_t last = separator + 1 < range.size() ? std::strtoull(range.c_str() + separator + 1, nullptr, 10) : file->second.size() - 1;
+                last = std::min<std::uint64_t>(last, file->second.size() - 1);
+                status = 206;
+                body = file->second.substr(static_cast<std::size_t>(first), static_cast<std::size_t>(last + 1 - first));
+                extraHeaders += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(file->second.size()) + "\r\n";
+            }
+            else{
+                body = file->second;
+            }
+            if(ranges){
+                extraHeaders += "Accept-Ranges: bytes\r\n";
+            }
+        }
+
+        if(t_delay.count() > 0){
+            stopped.wait_for(lock, t_delay, [this]{ return stopping.load(); });
+        }
+        if(stopping){
+            ::close(descriptor);
+            return;
+        }
+    }
+
+    std::string headers = "HTTP/1.1 " + std::to_string(status) + " " + reasonOf(status) + "\r\n";
+    if(!etag.empty()){
+        headers += "ETag: " + etag + "\r\n";
+    }
+    headers += extraHeaders;
+    if(status != 304){
+        headers += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    headers += "Connection: close\r\n\r\n";
+
+    if(sendAll(descriptor, headers.data(), headers.size()) && method != "HEAD"){
+        sendAll(descriptor, body.data(), body.size());
+    }
+
+    ::close(descriptor);
+}
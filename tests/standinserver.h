@@ -0,0 +1,88 @@
+/**
+ * @file standinserver.h
+ * @brief This header file contains the declarations of the loopback http server standing in for the mirrors in the tests
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class StandInServer
+ * @brief This class serves a few files over http on a loopback port, standing in for a mirror in the tests. Its
+ * behaviour is configured by the test: every response can be delayed, the next requests can be failed, and range
+ * requests can be accepted or ignored. A request carrying the etag of a file is answered by 304 Not Modified. Every
+ * connection is closed after its response. Posix only.
+ */
+class StandInServer
+{
+public:
+    StandInServer() = default;
+    ~StandInServer();
+
+    StandInServer(const StandInServer&) = delete;
+    StandInServer& operator=(const StandInServer&) = delete;
+
+    /**
+     * @brief listens on a free loopback port.
+    */
+    bool start();
+    void stop();
+
+    /**
+     * @brief returns the url of the given path, e.g. /download.json.
+    */
+    std::string url(const std::string& path) const;
+
+    void serve(const std::string& path, std::string body);
+
+    // Every response waits for the delay before its headers are sent
+    void setDelay(std::chrono::milliseconds delay);
+    // The next requests are answered by the given status without a body
+    void failNext(unsigned count, int status = 500);
+    // Range requests are answered by 206 if accepted, by the whole file otherwise
+    void acceptRanges(bool accept);
+
+    // Counters of the requests received so far
+    unsigned requests() const { return requestCount.load(); }
+    unsigned notModified() const { return notModifiedCount.load(); }
+    unsigned failed() const { return failedCount.load(); }
+    unsigned rangeRequests() const { return rangeCount.load(); }
+    void resetCounters();
+
+private:
+    int listener{-1};
+    int port{0};
+
+    std::thread acceptor;
+    std::vector<std::thread> connections;
+    std::atomic<bool> stopping{false};
+
+    mutable std::mutex mutex;
+    std::condition_variable stopped;
+    std::map<std::string, std::string> files;
+    std::chrono::milliseconds delay{0};
+    unsigned failures{0};
+    int failureStatus{500};
+    bool ranges{true};
+
+    std::atomic<unsigned> requestCount{0};
+    std::atomic<unsigned> notModifiedCount{0};
+    std::atomic<unsigned> failedCount{0};
+    std::atomic<unsigned> rangeCount{0};
+
+    void acceptLoop();
+    void answer(int descriptor);
+};
+
+#endif // STANDINSERVER_H
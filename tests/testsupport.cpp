@@ -0,0 +1,161 @@
+/**
+ * @file testsupport.cpp
+ * @brief This source file contains the definitions of the helpers shared by the test cases
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include <json/json.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+std::atomic<unsigned> failedExpectations{0};
+std::atomic<unsigned> createdDirectories{0};
+
+struct KnownRelease{
+    const char* release;
+    const char* version;
+    const char* codename;
+    bool lts;
+};
+
+const KnownRelease knownReleases[] = {
+    {"trusty", "14.04", "Trusty Tahr", true},
+    {"xenial", "16.04", "Xenial Xerus", true},
+    {"bionic", "18.04", "Bionic Beaver", true},
+    {"focal", "20.04", "Focal Fossa", true},
+    {"jammy", "22.04", "Jammy Jellyfish", true},
+    {"noble", "24.04", "Noble Numbat", true}
+};
+
+}
+
+namespace UCIITest
+{
+
+bool expectThat(bool condition, const char* text, const char* file, int line){
+    if(!condition){
+        failedExpectations++;
+        std::cerr << file << ":" << line << ": expectation failed: " << text << std::endl;
+    }
+    return condition;
+}
+
+unsigned failures(){
+    return failedExpectations.load();
+}
+
+TemporaryDirectory::TemporaryDirectory(){
+    std::filesystem::path base = std::filesystem::temp_directory_path();
+    directory = (base / ("ucii_test_" + std::to_string(getpid()) + "_" + std::to_string(createdDirectories++))).string();
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(directory, error);
+}
+
+TemporaryDirectory::~TemporaryDirectory(){
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+std::string feedDocument(const std::string& updated, const std::vector<TestImage>& images){
+    Json::Value root(Json::objectValue);
+    Json::Value& products = root["products"];
+
+    for(const TestImage& image : images){
+        const KnownRelease* known = nullptr;
+        for(const KnownRelease& release : knownReleases){
+            if(image.release == release.release){
+                known = &release;
+            }
+        }
+        if(!known){
+            continue;
+        }
+
+        Json::Value& product = products[std::string("com.ubuntu.cloud:server:") + known->version + ":amd64"];
+        product["arch"] = "amd64";
+        product["os"] = "ubuntu";
+        product["release"] = known->release;
+        product["release_codename"] = known->codename;
+        product["release_title"] = std::string(known->version) + (known->lts ? " LTS" : "");
+        product["support_eol"] = "2099-04-25";
+        product["supported"] = true;
+        product["version"] = known->version;
+
+        Json::Value& item = product["versions"][image.serial]["items"]["disk1.img"];
+        item["ftype"] = "disk1.img";
+        item["path"] = image.path;
+        item["sha256"] = image.sha256;
+        item["size"] = static_cast<Json::UInt64>(image.size);
+    }
+
+    root["content_id"] = "com.ubuntu.cloud:released:download";
+    root["datatype"] = "image-downloads";
+    root["format"] = "products:1.0";
+    root["updated"] = updated;
+
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = " ";
+    return Json::writeString(writerBuilder, root);
+}
+
+bool writeFile(const std::string& path, const std::string& content){
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    return static_cast<bool>(file.write(content.data(), static_cast<std::streamsize>(content.size())));
+}
+
+std::string readFile(const std::string& path){
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+int runOperation(UCIIParser::OperationType operation, const Arguments& arguments, std::string& output){
+    boost::program_options::variables_map args;
+    for(const auto& argument : arguments){
+        args.insert(std::make_pair(argument.first, boost::program_options::variable_value(argument.second, false)));
+    }
+
+    // The output writer of the parser writes to std::cout, its buffer is replaced for the run
+    std::ostringstream captured;
+    std::streambuf* standardOutput = std::cout.rdbuf(captured.rdbuf());
+    std::streambuf* standardError = std::cerr.rdbuf(captured.rdbuf());
+
+    int status;
+    try{
+        UCIIParser parser;
+        parser.configure(args);
+        status = parser.requestOperation(operation, args);
+    }
+    catch(const std::exception& exception){
+        captured << exception.what() << std::endl;
+        status = 1;
+    }
+
+    std::cout.rdbuf(standardOutput);
+    std::cerr.rdbuf(standardError);
+
+    output = captured.str();
+    return status;
+}
+
+}
@@ -0,0 +1,86 @@
+/**
+ * @file testsupport.h
+ * @brief This header file contains the declarations of the helpers shared by the test cases
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include "uciiparser.h"
+
+#include <boost/any.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Reports a failed expectation with its location, the test case fails if any of its expectations failed
+#define expect_that(condition) UCIITest::expectThat((condition), #condition, __FILE__, __LINE__)
+
+namespace UCIITest
+{
+
+bool expectThat(bool condition, const char* text, const char* file, int line);
+
+// Number of the failed expectations so far
+unsigned failures();
+
+/**
+ * @class TemporaryDirectory
+ * @brief A directory created under the temporary directory of the system and removed with everything in it
+ */
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    const std::string& path() const { return directory; }
+    std::string file(const std::string& name) const { return directory + "/" + name; }
+
+private:
+    std::string directory;
+};
+
+/**
+ * @struct TestImage
+ * @brief The disk1.img item of a version of an amd64 product of a generated feed
+ */
+struct TestImage{
+    // e.g. 'noble', its title and codename are derived from the known releases
+    std::string release;
+    std::string serial;
+    std::string sha256;
+    std::uint64_t size{0};
+    // Path of the item below the root of the mirror
+    std::string path;
+};
+
+/**
+ * @brief writes a download.json like document with the given 'updated' field and a product per release of the images.
+ * The known releases are trusty, xenial, bionic, focal, jammy and noble.
+*/
+std::string feedDocument(const std::string& updated, const std::vector<TestImage>& images);
+
+bool writeFile(const std::string& path, const std::string& content);
+std::string readFile(const std::string& path);
+
+// Options of an operation by their names in uciiparser.h, with the types main gives them
+using Arguments = std::map<std::string, boost::any>;
+
+/**
+ * @brief configures a parser by the arguments and runs the operation as main does, everything written to the standard
+ * output and the standard error meanwhile is captured.
+ * @return exit status of the operation.
+*/
+int runOperation(UCIIParser::OperationType operation, const Arguments& arguments, std::string& output);
+
+}
+
+#endif // TESTSUPPORT_H
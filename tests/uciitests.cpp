@@ -0,0 +1,59 @@
+/**
+ * @file uciitests.cpp
+ * @brief This source file contains the entry point of the test cases run by ctest, one case per invocation
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "testsupport.h"
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+// Test cases, each of them is registered as a ctest test of the same name
+void testAudit();
+void testDownload();
+void testHashing();
+void testHedging();
+void testHistory();
+void testQuery();
+
+namespace
+{
+
+struct TestCase{
+    const char* name;
+    void (*run)();
+};
+
+const TestCase testCases[] = {
+    {"audit", testAudit},
+    {"download", testDownload},
+    {"hashing", testHashing},
+    {"hedging", testHedging},
+    {"history", testHistory},
+    {"query", testQuery}
+};
+
+}
+
+int main(int argc, char* argv[]){
+    // A peer closing its connection early must not end the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if(argc < 2){
+        std::cerr << "Usage: ucii_tests <case>" << std::endl;
+        return 2;
+    }
+
+    for(const TestCase& testCase : testCases){
+        if(std::strcmp(testCase.name, argv[1]) == 0){
+            testCase.run();
+            return UCIITest::failures() > 0 ? 1 : 0;
+        }
+    }
+
+    std::cerr << "Unknown test case: " << argv[1] << std::endl;
+    return 2;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file transferengine.cpp
+ * @brief This source file contains the definitions of the reusable http transfer engine class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "transferengine.h"
+
+TransferEngine::TransferEngine(long connectTimeout, long lowSpeedTime)
+    : connectTimeout(connectTimeout), lowSpeedTime(lowSpeedTime)
+{
+    // Reference counted by libcurl, must be called before any thread uses curl
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+TransferEngine::~TransferEngine(){
+    // Handles must be cleaned up before the share they use
+    for(CURLM* multi : idleMultiHandles){
+        curl_multi_cleanup(multi);
+    }
+    for(CURL* curl : idleHandles){
+        curl_easy_cleanup(curl);
+    }
+    curl_share_cleanup(share);
+    curl_global_cleanup();
+}
+
+void TransferEngine::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userp){
+    static_cast<TransferEngine*>(userp)->shareMutexes[data].lock();
+}
+
+void TransferEngine::unlockShare(CURL*, curl_lock_data data, void* userp){
+    static_cast<TransferEngine*>(userp)->shareMutexes[data].unlock();
+}
+
+CURL* TransferEngine::acquire(const std::string& url){
+    CURL* curl = nullptr;
+    long t_connectTimeout, t_lowSpeedTime;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if(!idleHandles.empty()){
+            curl = idleHandles.back();
+            idleHandles.pop_back();
+        }
+        else{
+            curl = curl_easy_init();
+            createdHandles++;
+        }
+        t_connectTimeout = connectTimeout;
+        t_lowSpeedTime = lowSpeedTime;
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+
+    // Follow HTTP redirects if necessary.
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    // Handles are used from several threads, signals can not be used for the timeouts
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    // Large bodies take long, abort only a connection attempt or a stalled transfer instead of limiting the total time
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, t_connectTimeout);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, t_lowSpeedTime);
+
+    // Accept every encoding libcurl can decode, the write callbacks receive the decoded body
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+
+    // Multiplex over http/2 where the server supports it and keep the idle connections alive
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    return curl;
+}
+
+void TransferEngine::release(CURL* curl){
+    if(!curl){
+        return;
+    }
+
+    // Reset clears the options of the previous request but keeps the open connections
+    curl_easy_reset(curl);
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    idleHandles.push_back(curl);
+}
+
+CURLM* TransferEngine::acquireMulti(){
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if(!idleMultiHandles.empty()){
+            CURLM* multi = idleMultiHandles.back();
+            idleMultiHandles.pop_back();
+            return multi;
+        }
+    }
+
+    return curl_multi_init();
+}
+
+void TransferEngine::releaseMulti(CURLM* multi){
+    if(!multi){
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    idleMultiHandles.push_back(multi);
+}
+
+void TransferEngine::setTimeouts(long connectTimeout, long lowSpeedTime){
+    std::lock_guard<std::mutex> lock(poolMutex);
+    this->connectTimeout = connectTimeout;
+    this->lowSpeedTime = lowSpeedTime;
+}
+
+std::size_t TransferEngine::handlesCreated() const{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return createdHandles;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file transferengine.h
+ * @brief This header file contains the declarations of the reusable http transfer engine class
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef TRANSFERENGINE_H
+#define TRANSFERENGINE_H
+
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class TransferEngine
+ * @brief This class hands out curl easy handles prepared with the common transfer options and takes them back after
+ * use. Returned handles are kept with their open connections, so the following requests to the same host reuse the
+ * connection (keep-alive, http/2 where the server supports it). All handles share the dns and tls session caches and
+ * accept every content encoding supported by libcurl (gzip, br etc.). Handles can be acquired from several threads.
+ * Multi handles are pooled the same way, a transfer run by a multi handle leaves its connection in the cache of that
+ * multi handle, so the next concurrent transfers reuse it as long as the multi handle is kept.
+ */
+class TransferEngine
+{
+public:
+    /**
+     * @brief TransferEngine class constructor
+     * @param connectTimeout seconds allowed to establish a connection
+     * @param lowSpeedTime a transfer slower than 1 KiB/s for the given seconds is aborted
+    */
+    TransferEngine(long connectTimeout = 10, long lowSpeedTime = 30);
+    ~TransferEngine();
+
+    TransferEngine(const TransferEngine&) = delete;
+    TransferEngine& operator=(const TransferEngine&) = delete;
+
+    /**
+     * @brief returns an easy handle for the given url with the common options applied. The handle must be given back
+     * by release().
+    */
+    CURL* acquire(const std::string& url);
+
+    /**
+     * @brief takes back a handle returned by acquire(), its connection stays open for the next acquire().
+    */
+    void release(CURL* curl);
+
+    /**
+     * @brief returns a multi handle to run concurrent transfers, the handle must be given back by releaseMulti().
+    */
+    CURLM* acquireMulti();
+
+    /**
+     * @brief takes back a multi handle returned by acquireMulti(), all of its easy handles must be removed before.
+     * Its open connections are reused by the next acquireMulti().
+    */
+    void releaseMulti(CURLM* multi);
+
+    /**
+     * @brief changes the timeouts of the handles acquired afterwards.
+    */
+    void setTimeouts(long connectTimeout, long lowSpeedTime);
+
+    // Number of easy handles created so far, a count lower than the number of requests means handles were reused
+    std::size_t handlesCreated() const;
+
+private:
+    CURLSH* share{nullptr};
+    // Guards the data shared between the handles, one mutex per curl_lock_data
+    std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+
+    mutable std::mutex poolMutex;
+    std::vector<CURL*> idleHandles;
+    std::vector<CURLM*> idleMultiHandles;
+    std::size_t createdHandles{0};
+    long connectTimeout;
+    long lowSpeedTime;
+
+    static void lockShare(CURL* curl, curl_lock_data data, curl_lock_access access, void* userp);
+    static void unlockShare(CURL* curl, curl_lock_data data, void* userp);
+};
+
+#endif // TRANSFERENGINE_H
@@ -0,0 +1,337 @@
+/**
+ * @file ucii.cpp
+ * @brief This source file contains the definitions of the embeddable ucii library
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "ucii.h"
+#include "columnarcatalog.h"
+#include "uciiparser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+// Generations of the published catalogs, 0 while a service has published nothing
+std::atomic<std::uint64_t> nextGeneration{1};
+
+// Services of the process, the set of the live ones is only read after a service is destroyed
+std::atomic<std::uint64_t> nextService{1};
+std::atomic<std::uint64_t> destroyedServices{0};
+std::mutex servicesMutex;
+std::unordered_set<std::uint64_t> liveServices;
+
+// Last snapshot of a service read by the thread
+struct LocalSnapshot{
+    std::uint64_t service{0};
+    std::uint64_t generation{0};
+    std::shared_ptr<const ColumnarCatalog> catalog;
+};
+
+// Snapshots of the thread, one per service it reads. A process has a few services, they are searched in turn.
+struct LocalSnapshots{
+    std::vector<LocalSnapshot> slots;
+    // Number of the destroyed services when their slots were last dropped
+    std::uint64_t destroyedSeen{0};
+};
+
+thread_local LocalSnapshots localSnapshots;
+
+}
+
+std::time_t UCIICatalog::updated() const{
+    return catalog ? catalog->updated() : 0;
+}
+
+std::size_t UCIICatalog::releaseCount() const{
+    return catalog ? catalog->productCount() : 0;
+}
+
+UCIICatalog::Release UCIICatalog::release(std::size_t index) const{
+    return releaseAt(static_cast<std::uint32_t>(index));
+}
+
+UCIICatalog::Release UCIICatalog::releaseAt(std::uint32_t product) const{
+    Release release;
+    release.title = catalog->releaseTitle(product);
+    release.codename = catalog->releaseCodename(product);
+    release.arch = catalog->arch(product);
+    release.stream = catalog->stream(product);
+    return release;
+}
+
+UCIIStatus UCIICatalog::currentLTS(Release& release) const{
+    if(!catalog){
+        return UCIIStatus::NotLoaded;
+    }
+
+    std::uint32_t product = catalog->latestLTS();
+    if(product == ColumnarCatalog::npos){
+        return UCIIStatus::ReleaseNotFound;
+    }
+
+    release = releaseAt(product);
+    return UCIIStatus::Ok;
+}
+
+UCIIStatus UCIICatalog::versions(std::string_view release, std::vector<std::string_view>& versions) const{
+    versions.clear();
+    if(!catalog){
+        return UCIIStatus::NotLoaded;
+    }
+
+    std::uint32_t product = catalog->findRelease(release);
+    if(product == ColumnarCatalog::npos){
+        return UCIIStatus::ReleaseNotFound;
+    }
+
+    for(std::uint32_t t_version = catalog->versionsBegin(product); t_version < catalog->versionsEnd(product); t_version++){
+        versions.push_back(catalog->version(t_version));
+    }
+
+    return UCIIStatus::Ok;
+}
+
+UCIICatalog::Image UCIICatalog::image(std::string_view release, std::string_view version) const{
+    Image image;
+    if(!catalog){
+        return image;
+    }
+
+    std::uint32_t product = catalog->findRelease(release);
+    if(product == ColumnarCatalog::npos){
+        image.status = UCIIStatus::ReleaseNotFound;
+        return image;
+    }
+    image.release = releaseAt(product);
+
+    std::uint32_t t_version = catalog->findVersion(product, version);
+    if(t_version == ColumnarCatalog::npos){
+        image.status = UCIIStatus::VersionNotFound;
+        return image;
+    }
+
+    image.status = UCIIStatus::Ok;
+    image.version = catalog->version(t_version);
+    image.size = catalog->versionSize(t_version);
+
+    // Format the digest in place, the result does not own any string
+    if(const std::uint8_t* digest = catalog->versionDigest(t_version)){
+        static const char hexDigits[] = "0123456789abcdef";
+        for(int i = 0; i < 32; i++){
+            image.sha256[2 * i] = hexDigits[digest[i] >> 4];
+            image.sha256[2 * i + 1] = hexDigits[digest[i] & 0x0F];
+        }
+        image.sha256[64] = '\0';
+    }
+
+    return image;
+}
+
+UCIIService::UCIIService(UCIIOptions options)
+    : serviceId(nextService.fetch_add(1)),
+      parser(new UCIIParser()),
+      refreshSeconds(options.refreshSeconds)
+{
+    {
+    std::lock_guard<std::mutex> lock(servicesMutex);
+    liveServices.insert(serviceId);
+    }
+
+    parser->configure(options);
+    refreshThread = std::thread(&UCIIService::refreshLoop, this);
+}
+
+UCIIService::~UCIIService()
+{
+    {
+    std::lock_guard<std::mutex> lock(refreshMutex);
+    stopping = true;
+    }
+    refreshCondition.notify_all();
+    refreshThread.join();
+
+    // The other threads drop their slots of this service by their next call
+    releaseSnapshot();
+    {
+    std::lock_guard<std::mutex> lock(servicesMutex);
+    liveServices.erase(serviceId);
+    }
+    destroyedServices.fetch_add(1, std::memory_order_release);
+}
+
+bool UCIIService::refresh(std::string* error){
+    std::shared_ptr<const ColumnarCatalog> refreshed;
+    std::ostringstream errors;
+
+    {
+    std::lock_guard<std::mutex> lock(parserMutex);
+
+    // The library does not write to the standard streams, the warnings (e.g. an outdated cache is used) are dropped
+    std::ostringstream warnings;
+    parser->setMessageStreams(errors, warnings);
+
+    try{
+        refreshed = parser->columnarCatalog(std::atomic_load(&current));
+    }
+    catch(std::exception& e){
+        errors << e.what() << std::endl;
+    }
+
+    // Unchanged feeds keep the published catalog and the snapshots of the readers
+    if(refreshed && refreshed != std::atomic_load(&current)){
+        publish(refreshed);
+    }
+    }
+
+    completePending();
+
+    if(!refreshed && error){
+        *error = errors.str();
+        while(!error->empty() && (error->back() == '\n' || error->back() == ' ')){
+            error->pop_back();
+        }
+    }
+
+    return refreshed != nullptr;
+}
+
+void UCIIService::publish(std::shared_ptr<const ColumnarCatalog> catalog){
+    // The catalog is stored before its generation, a reader that sees the new generation also finds the new catalog
+    std::atomic_store(&current, std::move(catalog));
+    generation.store(nextGeneration.fetch_add(1), std::memory_order_release);
+}
+
+UCIICatalog UCIIService::catalog() const{
+    std::uint64_t published = generation.load(std::memory_order_acquire);
+    if(published == 0){
+        return UCIICatalog();
+    }
+
+    LocalSnapshots& snapshots = localSnapshots;
+
+    // Drop the catalogs of the services destroyed since the last call, they are not read anymore
+    std::uint64_t destroyed = destroyedServices.load(std::memory_order_acquire);
+    if(snapshots.destroyedSeen != destroyed){
+        std::lock_guard<std::mutex> lock(servicesMutex);
+        snapshots.slots.erase(std::remove_if(snapshots.slots.begin(), snapshots.slots.end(), [](const LocalSnapshot& slot){
+            return liveServices.count(slot.service) == 0;
+        }), snapshots.slots.end());
+        snapshots.destroyedSeen = destroyed;
+    }
+
+    auto slot = std::find_if(snapshots.slots.begin(), snapshots.slots.end(), [this](const LocalSnapshot& t_slot){ return t_slot.service == serviceId; });
+    if(slot == snapshots.slots.end()){
+        slot = snapshots.slots.insert(snapshots.slots.end(), LocalSnapshot{serviceId, 0, nullptr});
+    }
+
+    // Renew the snapshot of the thread only after a swap, the steady state is a comparison and a reference count
+    if(slot->generation != published){
+        slot->catalog = std::atomic_load(&current);
+        slot->generation = published;
+    }
+
+    return UCIICatalog(slot->catalog);
+}
+
+void UCIIService::releaseSnapshot() const{
+    std::vector<LocalSnapshot>& slots = localSnapshots.slots;
+    slots.erase(std::remove_if(slots.begin(), slots.end(), [this](const LocalSnapshot& slot){ return slot.service == serviceId; }), slots.end());
+}
+
+std::future<bool> UCIIService::refreshAsync(){
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+
+    {
+    std::lock_guard<std::mutex> lock(refreshMutex);
+    refreshRequests.push_back(std::move(promise));
+    }
+    refreshCondition.notify_all();
+
+    return future;
+}
+
+void UCIIService::refreshLoop(){
+    std::unique_lock<std::mutex> lock(refreshMutex);
+
+    while(!stopping){
+        // Sleep until the next periodic refresh, a request or the shutdown
+        auto woken = [this]{ return stopping || !refreshRequests.empty(); };
+        if(refreshSeconds > 0){
+            refreshCondition.wait_for(lock, std::chrono::seconds(refreshSeconds), woken);
+        }
+        else{
+            refreshCondition.wait(lock, woken);
+        }
+        if(stopping){
+            break;
+        }
+
+        // Requests made during the refresh wait for the next one
+        std::vector<std::promise<bool>> requests;
+        requests.swap(refreshRequests);
+
+        lock.unlock();
+        bool refreshed = refresh();
+        for(std::promise<bool>& request : requests){
+            request.set_value(refreshed);
+        }
+        lock.lock();
+    }
+
+    for(std::promise<bool>& request : refreshRequests){
+        request.set_value(false);
+    }
+    refreshRequests.clear();
+}
+
+void UCIIService::completePending(){
+    std::vector<std::function<void(const UCIICatalog&)>> completions;
+    {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    firstRefreshDone = true;
+    completions.swap(pending);
+    }
+
+    UCIICatalog snapshot = catalog();
+    for(std::function<void(const UCIICatalog&)>& completion : completions){
+        completion(snapshot);
+    }
+}
+
+void UCIIService::whenLoaded(std::function<void(const UCIICatalog&)> completion){
+    // Loaded catalogs are answered without a lock
+    if(generation.load(std::memory_order_acquire) == 0){
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if(!firstRefreshDone){
+            pending.push_back(std::move(completion));
+            return;
+        }
+    }
+
+    completion(catalog());
+}
+
+std::future<UCIICatalog> UCIIService::catalogAsync(){
+    // std::function needs a copyable callable, the promise is shared
+    std::shared_ptr<std::promise<UCIICatalog>> promise = std::make_shared<std::promise<UCIICatalog>>();
+    std::future<UCIICatalog> future = promise->get_future();
+
+    whenLoaded([promise](const UCIICatalog& snapshot){
+        promise->set_value(snapshot);
+    });
+
+    return future;
+}
+
+void UCIIService::imageAsync(std::string release, std::string version, std::function<void(const UCIICatalog&, const UCIICatalog::Image&)> completion){
+    whenLoaded([release = std::move(release), version = std::move(version), completion = std::move(completion)](const UCIICatalog& snapshot){
+        completion(snapshot, snapshot.image(release, version));
+    });
+}
@@ -0,0 +1,251 @@
+/**
+ * @file ucii.h
+ * @brief This header file contains the declarations of the embeddable ucii library, a typed and thread-safe lookup api
+ * over the ubuntu cloud image catalog
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef UCII_H
+#define UCII_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class ColumnarCatalog;
+class UCIIParser;
+
+/**
+ * @struct UCIIOptions
+ * @brief Location of the catalog and how it is fetched, the same settings as the cli options of the same names
+ */
+struct UCIIOptions{
+    // Url or local path of the json file, empty for the released stream of cloud-images.ubuntu.com
+    std::string source;
+    // Comma separated urls of equivalent copies of the source, requested if the source fails or is slow to answer
+    std::string mirrors;
+    // Milliseconds without the first byte of the response before a hedged request is started, 0 to adapt it to the
+    // observed times to the first byte
+    long hedgeDelay{0};
+    // Requests of the json file allowed in addition to one per source and mirror
+    unsigned retries{2};
+    // Comma separated streams to aggregate instead of the source, e.g. 'released,daily' or name=url entries
+    std::string streams;
+    // Empty for the default cache directory of the platform
+    std::string cacheDirectory;
+    long maxAge{300};
+    bool cacheEnabled{true};
+    // 'stream', 'simd' or 'jsoncpp'
+    std::string parser{"stream"};
+    long connectTimeout{10};
+    long lowSpeedTime{30};
+    // Interval of the background refresh in seconds, 0 disables the refresh
+    long refreshSeconds{0};
+};
+
+/**
+ * @enum UCIIStatus
+ * @brief Outcome of a lookup
+ */
+enum class UCIIStatus{
+    Ok,
+    // No catalog is loaded yet, or the first load failed
+    NotLoaded,
+    ReleaseNotFound,
+    VersionNotFound
+};
+
+/**
+ * @class UCIICatalog
+ * @brief An immutable catalog snapshot. Copies are cheap (a reference count) and share the same catalog, which lives as
+ * long as any copy. All methods are const and can be called from any number of threads without locks, lookups do not
+ * allocate. The strings of the results are views into the catalog, valid as long as the snapshot they come from.
+ * Releases are given by their title (24.04 LTS) or by their codename (Noble Numbat).
+ */
+class UCIICatalog
+{
+public:
+    /**
+     * @brief constructs an empty snapshot, every lookup returns UCIIStatus::NotLoaded
+    */
+    UCIICatalog() = default;
+
+    bool loaded() const { return catalog != nullptr; }
+
+    /**
+     * @brief returns the 'updated' time of the feed as unix time, 0 if it is not known.
+    */
+    std::time_t updated() const;
+
+    /**
+     * @brief returns the number of releases, release(index) returns them in catalog order.
+    */
+    std::size_t releaseCount() const;
+
+    struct Release{
+        std::string_view title;
+        std::string_view codename;
+        std::string_view arch;
+        // Stream of the release if several streams are aggregated, empty otherwise
+        std::string_view stream;
+    };
+
+    Release release(std::size_t index) const;
+
+    /**
+     * @brief finds the LTS release with the highest release version.
+    */
+    UCIIStatus currentLTS(Release& release) const;
+
+    /**
+     * @brief lists the versions of a release in ascending order into the given vector, which can be reused by the
+     * caller across the lookups to avoid the allocations.
+    */
+    UCIIStatus versions(std::string_view release, std::vector<std::string_view>& versions) const;
+
+    /**
+     * @struct Image
+     * @brief The disk1.img item of a version
+     */
+    struct Image{
+        UCIIStatus status{UCIIStatus::NotLoaded};
+        Release release;
+        std::string_view version;
+        std::uint64_t size{0};
+        // Lowercase hex digest, empty if the catalog has none
+        char sha256[65]{};
+    };
+
+    /**
+     * @brief finds the disk1.img of the given version of a release.
+    */
+    Image image(std::string_view release, std::string_view version) const;
+
+private:
+    friend class UCIIService;
+
+    explicit UCIICatalog(std::shared_ptr<const ColumnarCatalog> catalog) : catalog(std::move(catalog)) {}
+
+    std::shared_ptr<const ColumnarCatalog> catalog;
+
+    Release releaseAt(std::uint32_t product) const;
+};
+
+/**
+ * @class UCIIService
+ * @brief This class keeps the catalog of a process for the embedding applications. The catalog is loaded (and
+ * refreshed) by the same fetch, cache and parser machinery as the cli and published as an immutable UCIICatalog. A
+ * refresh builds the new catalog aside and swaps it in, readers keep the snapshot they started with (read-copy-update):
+ * catalog() takes no lock, the thread-local snapshot of the caller is renewed once after every swap. Every thread keeps
+ * a snapshot per service it reads, so the services of a process do not evict each other's snapshots.
+ *
+ * The synchronous methods block the caller, the asynchronous ones return futures or call a completion. Asynchronous
+ * lookups issued before the first load completes are answered once it completes.
+ */
+class UCIIService
+{
+public:
+    /**
+     * @brief UCIIService class constructor, nothing is fetched until refresh() or refreshAsync() is called or the first
+     * background refresh is due
+     * @param options location of the catalog and the interval of the background refresh
+     * @throws std::invalid_argument if the parser or a stream is unknown
+    */
+    explicit UCIIService(UCIIOptions options = UCIIOptions());
+
+    /**
+     * @brief stops the refresh thread, a refresh in progress is completed first
+    */
+    ~UCIIService();
+
+    UCIIService(const UCIIService&) = delete;
+    UCIIService& operator=(const UCIIService&) = delete;
+
+    /**
+     * @brief fetches the catalog (from the cache if it is fresh) and publishes it. The current catalog is kept if the
+     * fetch fails. Concurrent refreshes are serialized.
+     * @param error description of the problem if the refresh fails, may be null
+     * @return true if a catalog is published.
+    */
+    bool refresh(std::string* error = nullptr);
+
+    /**
+     * @brief asks the refresh thread of the service to refresh now, the requests made while a refresh is in progress
+     * are answered by the next one.
+     * @return true once a catalog is published, false if the refresh fails or the service is destroyed first.
+    */
+    std::future<bool> refreshAsync();
+
+    /**
+     * @brief returns the current snapshot, an empty one if nothing is loaded yet. Lock free: the snapshot of the
+     * calling thread is kept in a thread-local slot of this service and only renewed after a swap, so a thread holds on
+     * to the last catalog it read until its next call. The slots of a destroyed service are dropped by the next call of
+     * the thread to any service.
+    */
+    UCIICatalog catalog() const;
+
+    /**
+     * @brief drops the snapshot of this service kept by the calling thread, so that a thread about to stay idle for a
+     * long time does not retain a replaced catalog.
+    */
+    void releaseSnapshot() const;
+
+    /**
+     * @brief calls the completion with the current snapshot, right away if a catalog is loaded, otherwise on the thread
+     * that completes the first refresh (with an empty snapshot if it fails).
+    */
+    void whenLoaded(std::function<void(const UCIICatalog&)> completion);
+
+    /**
+     * @brief returns the current snapshot as soon as the first refresh completes.
+    */
+    std::future<UCIICatalog> catalogAsync();
+
+    /**
+     * @brief finds the disk1.img of the given version of a release once a catalog is loaded and passes it to the
+     * completion together with the snapshot its strings point into.
+    */
+    void imageAsync(std::string release, std::string version, std::function<void(const UCIICatalog&, const UCIICatalog::Image&)> completion);
+
+private:
+    // Identity of the service in the thread-local slots, unique for the lifetime of the process
+    std::uint64_t serviceId;
+
+    // Only the refreshes use the parser, one at a time
+    std::unique_ptr<UCIIParser> parser;
+    std::mutex parserMutex;
+
+    // Published catalog and its generation, readers compare the generation with the one of their thread-local snapshot
+    std::shared_ptr<const ColumnarCatalog> current;
+    std::atomic<std::uint64_t> generation{0};
+
+    // Completions waiting for the first refresh
+    std::mutex pendingMutex;
+    std::vector<std::function<void(const UCIICatalog&)>> pending;
+    bool firstRefreshDone{false};
+
+    // Refresh thread, refreshes every refreshSeconds (if positive) and on request
+    long refreshSeconds;
+    std::mutex refreshMutex;
+    std::condition_variable refreshCondition;
+    std::vector<std::promise<bool>> refreshRequests;
+    bool stopping{false};
+    std::thread refreshThread;
+
+    void publish(std::shared_ptr<const ColumnarCatalog> catalog);
+    void completePending();
+    void refreshLoop();
+};
+
+#endif // UCII_H
@@ -6,13 +6,37 @@
  */
 
 #include "uciiparser.h"
-
+#include "catalogdiff.h"
+#include "cataloghistory.h"
+#include "catalogquery.h"
+#include "filehasher.h"
+#include "jsonstructuralparser.h"
+#include "mappedfile.h"
+#include "mirroraudit.h"
+#include "rangeddownloader.h"
+#include "sha256.h"
+#include "uciiserver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <csignal>
+#include <cstdlib>
 #include <curl/curl.h>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-#define LTS_keyword "LTS"
+// Requests of the json file running at the same time, the first one and its hedges
+#define max_hedged_requests 2
 
 UCIIParser::UCIIParser() {
 
@@ -40,6 +64,13 @@ int UCIIParser::requestOperation(boost::any operationType, boost::program_option
             // Perform related operation
             retVal = doOperationAllSupportedUbuntuReleases();
             break;
+        // Print every version of all amd64 arch. ubuntu releases
+        case OperationType::AllVersions:
+            // No preliminary control required
+
+            // Perform related operation
+            retVal = doOperationAllVersions();
+            break;
         // Print last released ubuntu amd64 arch. lts version name
         case OperationType::CurrentUbuntuLTSVersion:
             // No preliminary control required
@@ -47,6 +78,31 @@ int UCIIParser::requestOperation(boost::any operationType, boost::program_option
             // Perform related operation
             retVal = doOperationCurrentUbuntuLTSVersion();
             break;
+        // Print the newest version of a release
+        case OperationType::Latest:
+            {
+            auto releaseTitle = args[release_title_key].as<std::string>();
+            auto releaseCodename = args[release_codename_key].as<std::string>();
+
+            // Perform related operation
+            retVal = doOperationLatest(releaseTitle, releaseCodename);
+
+            break;
+            }
+        // Print the supported releases
+        case OperationType::Supported:
+            // No preliminary control required
+
+            // Perform related operation
+            retVal = doOperationSupported();
+            break;
+        // List the catalogs recorded in the history
+        case OperationType::History:
+            // No preliminary control required
+
+            // Perform related operation
+            retVal = doOperationHistory();
+            break;
         // Fetch sha256 value of the disk1.img item of the given ubuntu release with specific version
         case OperationType::FetchSha256:
             {
@@ -85,385 +141,2531 @@ int UCIIParser::requestOperation(boost::any operationType, boost::program_option
 
             break;
             }
-    }
+        // Convert the json file into a binary snapshot
+        case OperationType::BuildSnapshot:
+            {
+            auto path = args[build_snapshot_key].as<std::string>();
 
-    return retVal;
-}
+            if(path.empty()){
+                std::cout << "Please specify a non empty snapshot path." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationBuildSnapshot(path);
+            }
 
-// Curl callback function
-std::size_t curlWriteCallback(
-            const char* in,
-            std::size_t size,
-            std::size_t num,
-            std::string* out)
-    {
-        const std::size_t totalBytes(size * num);
-        out->append(in, totalBytes);
-        return totalBytes;
-    }
+            break;
+            }
+        // Answer many sha256 queries from a file or the standard input
+        case OperationType::BatchSha256:
+            {
+            auto source = args[batch_key].as<std::string>();
+
+            if(source.empty()){
+                std::cout << "Please specify a query file or '-' for the standard input." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationBatch(source);
+            }
+
+            break;
+            }
+        // Serve the lookups over a unix domain socket
+        case OperationType::Serve:
+            {
+            auto socketPath = args[serve_key].as<std::string>();
+
+            if(socketPath.empty()){
+                std::cout << "Please specify a non empty socket path." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationServe(socketPath, args[refresh_key].as<long>());
+            }
+
+            break;
+            }
+        // Forward the operation to a running server
+        case OperationType::ClientRequest:
+            {
+            auto socketPath = args[connect_key].as<std::string>();
+            auto releaseTitle = args[release_title_key].as<std::string>();
+            auto releaseCodename = args[release_codename_key].as<std::string>();
+            auto version = args[version_key].as<std::string>();
 
-bool UCIIParser::obtainJsonFile(){
-    // Define URL
-    const std::string url = "https://cloud-images.ubuntu.com/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+            // Build the json request of the operation
+            Json::Value request;
+            if(args.count("listall")){
+                request["op"] = "listall";
+            }
+            else if(args.count("listcurr")){
+                request["op"] = "listcurr";
+            }
+            else if(args.count(sha_key) && (!releaseTitle.empty() || !releaseCodename.empty())){
+                request["op"] = version.empty() ? "versions" : "sha";
+                request[release_title_key] = releaseTitle;
+                request[release_codename_key] = releaseCodename;
+                request[version_key] = version;
+            }
+            else{
+                std::cout << "Please specify one of the listall, listcurr or sha operations to send to the server." << std::endl;
+                retVal = 1;
+                break;
+            }
 
-    // Initialize curl instance
-    CURL* curl = curl_easy_init();
+            Json::StreamWriterBuilder writerBuilder;
+            writerBuilder["indentation"] = "";
 
-    // Set remote URL.
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            // Perform related operation
+            retVal = doOperationClientRequest(socketPath, Json::writeString(writerBuilder, request));
 
-    /* ask libcurl to show us the verbose output */
-    curl_easy_setopt(curl, CURLOPT_VERBOSE, 0L);
+            break;
+            }
+        // Verify a local disk1.img against the sha256 in the catalog
+        case OperationType::Verify:
+            {
+            auto path = args[verify_key].as<std::string>();
+            auto releaseTitle = args[release_title_key].as<std::string>();
+            auto releaseCodename = args[release_codename_key].as<std::string>();
+            auto version = args[version_key].as<std::string>();
 
-    // Don't bother trying IPv6, which would increase DNS resolution time.
-    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+            if(path.empty()){
+                std::cout << "Please specify a non empty image path." << std::endl;
+                retVal = 1;
+            }
+            else if((releaseTitle.empty() && releaseCodename.empty()) || version.empty()){
+                std::cout << "Please specify the release title or release codename and the version of the image." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationVerify(path, releaseTitle, releaseCodename, version);
+            }
 
-    // Don't wait forever, time out after 10 seconds.
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10);
+            break;
+            }
+        // Download a disk1.img by concurrent range requests
+        case OperationType::Download:
+            {
+            auto path = args[download_key].as<std::string>();
+            auto releaseTitle = args[release_title_key].as<std::string>();
+            auto releaseCodename = args[release_codename_key].as<std::string>();
+            auto version = args[version_key].as<std::string>();
+            auto connections = args[connections_key].as<unsigned>();
+            auto chunkSize = args[chunk_size_key].as<unsigned>();
 
-    // Follow HTTP redirects if necessary.
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+            if(path.empty()){
+                std::cout << "Please specify a non empty destination path." << std::endl;
+                retVal = 1;
+            }
+            else if((releaseTitle.empty() && releaseCodename.empty()) || version.empty()){
+                std::cout << "Please specify the release title or release codename and the version of the image." << std::endl;
+                retVal = 1;
+            }
+            else if(connections == 0 || chunkSize == 0){
+                std::cout << "Please specify a positive number of connections and chunk size." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationDownload(path, releaseTitle, releaseCodename, version, connections, static_cast<std::size_t>(chunkSize) * 1024 * 1024);
+            }
 
-    // Response information.
-    int httpCode(0);
-    std::unique_ptr<std::string> httpData(new std::string());
+            break;
+            }
+        // Complete a release name or a version
+        case OperationType::Complete:
+            {
+            auto prefix = args[complete_key].as<std::string>();
+            auto releaseTitle = args[release_title_key].as<std::string>();
+            auto releaseCodename = args[release_codename_key].as<std::string>();
 
-    // Hook up data handling function.
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+            // Perform related operation
+            retVal = doOperationComplete(prefix, releaseTitle, releaseCodename);
 
-    // Hook up data container (will be passed as the last parameter to the
-    // callback handling function).  Can be any pointer type, since it will
-    // internally be passed as a void pointer.
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, httpData.get());
+            break;
+            }
+        // Check a local mirror against the catalog
+        case OperationType::Audit:
+            {
+            auto root = args[audit_key].as<std::string>();
+            auto where = args.count(where_key) ? args[where_key].as<std::string>() : "";
+            auto jobs = args[jobs_key].as<unsigned>();
 
-    // Run our HTTP GET command, capture the HTTP response code, and clean up.
-    curl_easy_perform(curl);
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    curl_easy_cleanup(curl);
+            if(root.empty() || !std::filesystem::is_directory(root)){
+                std::cout << "Please specify the root directory of the mirror." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationAudit(root, where, jobs);
+            }
 
-    // If returned with no error
-    if (httpCode == 200)
-    {
-        Json::Reader jsonReader;
+            break;
+            }
+        // Write the changes of the catalog until interrupted
+        case OperationType::Watch:
+            {
+            auto intervalSeconds = args[interval_key].as<long>();
 
-        // If returned data can be parsed without any error
-        if (jsonReader.parse(*httpData, jsonData))
-        {
-            // return with no error
-            return true;
-        }
-        // If an error occured during json data parsing
-        else
-        {
-            std::cout << "Could not parse HTTP data as JSON" << std::endl;
-            std::cout << "HTTP data was:\n" << *httpData.get() << std::endl;
-            return false;
-        }
+            if(intervalSeconds <= 0){
+                std::cout << "Please specify a positive poll interval." << std::endl;
+                retVal = 1;
+            }
+            else{
+                // Perform related operation
+                retVal = doOperationWatch(intervalSeconds);
+            }
+
+            break;
+            }
+        // Filter the catalog of all architectures and items
+        case OperationType::Query:
+            {
+            auto where = args.count(where_key) ? args[where_key].as<std::string>() : "";
+            auto select = args.count(select_key) ? args[select_key].as<std::string>() : "";
+
+            // Perform related operation
+            retVal = doOperationQuery(where, select);
+
+            break;
+            }
+        default:
+            break;
     }
-    else
-    {
-        std::cout << "Couldn't GET from " << url << " - exiting" << std::endl;
-        return false;
+
+    // Write the results before the statistics
+    output.flush();
+
+    if(statsEnabled){
+        reportStats();
     }
 
-    return false;
+    return retVal;
 }
 
-int UCIIParser::doOperationAllSupportedUbuntuReleases(){
-    bool curlParseOk = obtainJsonFile();
+void UCIIParser::reportStats() const{
+    if(statsAsJson){
+        // Microsecond resolution is enough for the millisecond fields
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder["indentation"] = "";
+        writerBuilder["precision"] = 3;
+        writerBuilder["precisionType"] = "decimal";
+        std::cerr << Json::writeString(writerBuilder, stats.toJson()) << std::endl;
+    }
+    else{
+        stats.print(std::cerr);
+    }
+}
 
-    // Return immediately if json file reading caused an error
-    if(!curlParseOk){
-        return 1;
+// Simplestreams feeds that can be given to the streams option by their names
+struct KnownStream{
+    const char* name;
+    const char* url;
+};
+
+static const KnownStream known_streams[] = {
+    {"released", default_source_url},
+    {"daily", "https://cloud-images.ubuntu.com/daily/streams/v1/com.ubuntu.cloud:daily:download.json"},
+    {"minimal", "https://cloud-images.ubuntu.com/minimal/releases/streams/v1/com.ubuntu.cloud:released:download.json"},
+    {"minimal-daily", "https://cloud-images.ubuntu.com/minimal/daily/streams/v1/com.ubuntu.cloud:daily:download.json"}
+};
+
+// Returns the url of the given source, a plain path is a local file
+static std::string sourceLocation(const std::string& source){
+    if(source.find("://") != std::string::npos){
+        return source;
     }
 
-    std::string t_releaseTitle;
-    std::string t_releaseCodename;
+    std::error_code pathError;
+    return "file://" + std::filesystem::absolute(source, pathError).generic_string();
+}
 
-    // Iterate all elements under products tag
-    for(const Json::Value& product : jsonData["products"]){
-        // Check if the architecture of the current product is amd64. Continue otherwise.
-        if(product["arch"].asString() != "amd64"){
-            continue;
-        }
-        else{
-            // If the current release is in amd64 architecture parse the release title and the codename of the given release/product
-            t_releaseTitle = product["release_title"].asString();
-            t_releaseCodename = product["release_codename"].asString();
+// Returns the name the feed of the given url is cached under
+static std::string cacheNameOf(const std::string& url){
+    if(url == default_source_url){
+        return "download";
+    }
 
-            // Print the release title and the codename
-            std::cout << t_releaseTitle + " " + t_releaseCodename + " amd64" << std::endl;
-        }
+    std::uint64_t hash = 14695981039346656037ull;
+    for(unsigned char c : url){
+        hash = (hash ^ c) * 1099511628211ull;
     }
+    std::ostringstream name;
+    name << "download-" << std::hex << hash;
 
-    return 0;
+    return name.str();
 }
 
-int UCIIParser::doOperationCurrentUbuntuLTSVersion(){
-    bool curlParseOk = obtainJsonFile();
+// Bytes of the body shown on each side of the offset of a parse error
+#define error_excerpt_bytes 40
 
-    // Return immediately if json file reading caused an error
-    if(!curlParseOk){
-        return 1;
+// Describes a parse error of the body from the given source with the bytes around its offset, neither a large body nor
+// its control characters end up in the message. The excerpt is left out if the body is not kept
+static std::string parseErrorMessage(const std::string& source, const std::string& detail, std::string_view bytes, std::size_t offset){
+    std::string message = "Could not parse the JSON data of " + source + ": " + detail;
+    if(bytes.empty()){
+        return message;
     }
 
-    size_t productCount = jsonData["products"].size();
-
-    Json::Value::const_iterator productToSearch = jsonData["products"].end();
-    Json::Value::const_iterator firstProduct = jsonData["products"].begin();
-
-    do{
-        productToSearch--;
-        if((*productToSearch)["arch"].asString() != "amd64"){
-            continue;
-        }
-        std::string t_releaseTitle = (*productToSearch)["release_title"].asString();
-        std::string t_releaseCodename = (*productToSearch)["release_codename"].asString();
+    offset = std::min(offset, bytes.size());
+    std::size_t begin = offset > error_excerpt_bytes ? offset - error_excerpt_bytes : 0;
+    std::size_t end = std::min(bytes.size(), offset + error_excerpt_bytes);
+
+    std::string label = "\n  near offset " + std::to_string(offset) + ": ";
+    std::string excerpt = begin > 0 ? "..." : "";
+    // The caret marks the offset below the excerpt
+    std::size_t caret = label.size() - 1 + excerpt.size() + (offset - begin);
+    for(std::size_t position = begin; position < end; position++){
+        unsigned char c = static_cast<unsigned char>(bytes[position]);
+        excerpt += c >= 0x20 && c < 0x7f ? static_cast<char>(c) : '.';
+    }
+    if(end < bytes.size()){
+        excerpt += "...";
+    }
 
-        if(t_releaseTitle.find(LTS_keyword) != std::string::npos){
-            std::cout << t_releaseTitle + " " + t_releaseCodename + " amd64" << std::endl;
-            break;
-        }
+    return message + label + excerpt + "\n" + std::string(caret, ' ') + "^";
+}
 
-    }while(productToSearch != firstProduct);
+void UCIIParser::configure(boost::program_options::variables_map& args)
+{
+    // Feed options are optional, keep the defaults for the missing ones
+    UCIIOptions options;
+    options.cacheDirectory = args.count(cache_dir_key) ? args[cache_dir_key].as<std::string>() : "";
+    options.maxAge = args.count(max_age_key) ? args[max_age_key].as<long>() : feedCache.maxAge();
+    options.source = args.count(source_key) ? args[source_key].as<std::string>() : "";
+    options.streams = args.count(streams_key) ? args[streams_key].as<std::string>() : "";
+    options.mirrors = args.count(mirrors_key) ? args[mirrors_key].as<std::string>() : "";
+    if(args.count(hedge_key)){
+        options.hedgeDelay = args[hedge_key].as<long>();
+    }
+    if(args.count(retries_key)){
+        options.retries = args[retries_key].as<unsigned>();
+    }
+    options.cacheEnabled = args.count(no_cache_key) == 0;
+    if(args.count(parser_key)){
+        options.parser = args[parser_key].as<std::string>();
+    }
+    if(args.count(connect_timeout_key)){
+        options.connectTimeout = args[connect_timeout_key].as<long>();
+    }
+    if(args.count(low_speed_time_key)){
+        options.lowSpeedTime = args[low_speed_time_key].as<long>();
+    }
 
-    return 0;
-}
+    configure(options);
 
-int UCIIParser::doOperationFetchSha256(std::string releaseTitle, std::string releaseCodename, std::string version){
-    bool curlParseOk = obtainJsonFile();
+    // Statistics are collected anyway, the flags only select whether and how they are reported
+    statsAsJson = args.count(stats_json_key) != 0;
+    statsEnabled = statsAsJson || args.count(stats_key) != 0;
 
-    // Return immediately if json file reading caused an error
-    if(!curlParseOk){
-        return 1;
+    // Select the output format
+    if(args.count(format_key)){
+        OutputFormat format;
+        if(!OutputWriter::parseFormat(args[format_key].as<std::string>(), format)){
+            throw std::invalid_argument("Unknown format '" + args[format_key].as<std::string>() + "', please use 'text', 'jsonl', 'csv' or 'nul'.");
+        }
+        output.setFormat(format);
     }
 
-    bool searchByReleaseTitle = true;
+    snapshotPath = args.count(snapshot_key) ? args[snapshot_key].as<std::string>() : "";
 
-    // Search by 'release title' is prioritized
-    if(releaseTitle.empty()){
-        // Switch to search by release codename
-        searchByReleaseTitle = false;
-        std::cout << "Searching by codename: " << releaseCodename << std::endl;
+    // Operations are answered from the history instead of the current json file
+    asOf = 0;
+    if(args.count(as_of_key) && !CatalogHistory::parseDate(args[as_of_key].as<std::string>(), asOf)){
+        throw std::invalid_argument("Invalid date '" + args[as_of_key].as<std::string>() + "', please use YYYY-MM-DD or YYYY-MM-DDTHH:MM:SSZ.");
     }
-    else{
-        std::cout << "Searching by title: " << releaseTitle << std::endl;
+}
+
+void UCIIParser::configure(const UCIIOptions& options)
+{
+    // Feeds of different sources are cached under different names
+    sourceUrl = sourceLocation(options.source.empty() ? default_source_url : options.source);
+    feedCache = FeedCache(options.cacheDirectory, options.maxAge, cacheNameOf(sourceUrl));
+
+    // Mirrors hold the same json file, they share the cache of the source
+    mirrorUrls.clear();
+    std::stringstream mirrorList(options.mirrors);
+    std::string mirror;
+    while(std::getline(mirrorList, mirror, ',')){
+        if(!mirror.empty()){
+            mirrorUrls.push_back(sourceLocation(mirror));
+        }
     }
 
-    // Flag to indicate that a suitable product found by given title or codename
-    bool foundProduct = false;
-    // Flag to indicate that both a suitable product and a matching version number are found
-    bool foundVersion = false;
-    // sha256 text value to be stored
-    std::string sha256{""};
+    // The hedge delay starts from the times to the first byte observed by the previous invocations
+    hedgePolicy = HedgePolicy(options.hedgeDelay, options.retries);
+    if(options.cacheEnabled){
+        hedgePolicy.restore(feedCache.firstByteSmoothed(), feedCache.firstByteDeviation());
+    }
 
-    // Search among all product values in json file
-    for(const Json::Value& product : jsonData["products"]){
-        // Continue if the current product's architecture is not amd64
-        if(product["arch"].asString() != "amd64"){
+    // Streams aggregated into a single catalog, known names or name=url pairs
+    streams.clear();
+    std::stringstream list(options.streams);
+    std::string entry;
+    while(std::getline(list, entry, ',')){
+        if(entry.empty()){
             continue;
         }
-        else{
-            // Fetch release title and codename
-            std::string t_releaseTitle = product["release_title"].asString();
-            std::string t_releaseCodename = product["release_codename"].asString();
-            std::string t_availableVersions{""};
-
-            // If current search is based on release title
-            if(searchByReleaseTitle){
-                // If product release title is matched
-                if(t_releaseTitle == releaseTitle){
-                    // Set flag positive
-                    foundProduct = true;
-
-                    // Get all version numbers of the current product
-                    auto versionNames = product["versions"].getMemberNames();
-
-                    // If the given version number is not included by the available versions
-                    if(std::find(versionNames.begin(), versionNames.end(), version) == versionNames.end()){
-                        // version not found
-                        break;
-                    }
-                    // If the given version number is included in the available versions list
-                    else{
-                        // Set flag positive
-                        foundVersion = true;
-                        // Fetch the sha256 value from the file
-                        sha256 = product["versions"][version]["items"]["disk1.img"]["sha256"].asString();
-                    }
 
-                    break;
+        FeedStream stream;
+        std::size_t separator = entry.find('=');
+        if(separator != std::string::npos){
+            stream.name = entry.substr(0, separator);
+            stream.url = sourceLocation(entry.substr(separator + 1));
+        }
+        else{
+            stream.name = entry;
+            for(const KnownStream& known : known_streams){
+                if(entry == known.name){
+                    stream.url = known.url;
                 }
             }
-            // If current search is based on release codename
-            else{
-                // If product matches
-                if(t_releaseCodename == releaseCodename){
-                    // Set flag positive
-                    foundProduct = true;
-
-                    // Get all version numbers of the current product
-                    auto versionNames = product["versions"].getMemberNames();
-
-                    // If the given version number is not included by the available versions
-                    if(std::find(versionNames.begin(), versionNames.end(), version) == versionNames.end()){
-                        // version not found
-                        break;
-                    }
-                    // If the given version number is included in the available versions list
-                    else{
-                        // Set flag positive
-                        foundVersion = true;
-                        // Fetch the sha256 value from the file
-                        sha256 = product["versions"][version]["items"]["disk1.img"]["sha256"].asString();
-                    }
-
-                    break;
-                }
+            if(stream.url.empty()){
+                throw std::invalid_argument("Unknown stream '" + entry + "', please use 'released', 'daily', 'minimal', 'minimal-daily' or name=url.");
             }
         }
-    }
 
-    // If product found by title or codename
-    if(foundProduct){
-        // If both product found and a suitable version is found
-        if(foundVersion){
-            // Display the sha256 result by given release title
-            if(searchByReleaseTitle){
-                std::cout << "sha256 of the disk1.img of the ubuntu release (" << releaseTitle << " amd64) is : " << sha256 << std::endl;
-            }
-            // Display the sha256 result by given release codename
-            else{
-                std::cout << "sha256 of the disk1.img of the ubuntu release (" << releaseTitle << " amd64) is : " << sha256 << std::endl;
-            }
-        }
-        // If product found but there is no matching version number for this product
-        else{
-            // Inform user about that there is no matching version and display available version numbers
-            if(searchByReleaseTitle){
-                std::cout << "Matching ubuntu release found by title but no matching version found." << std::endl;
-                doOperationFindVersions(releaseTitle, releaseCodename, true);
-            }
-            else{
-                std::cout << "Matching ubuntu release found by codename but no matching version found." << std::endl;
-                doOperationFindVersions(releaseTitle, releaseCodename, true);
+        for(const FeedStream& other : streams){
+            if(other.name == stream.name){
+                throw std::invalid_argument("Stream '" + stream.name + "' is given more than once.");
             }
         }
+
+        stream.cache = FeedCache(options.cacheDirectory, options.maxAge, cacheNameOf(stream.url));
+        streams.push_back(std::move(stream));
+    }
+
+    // Transfer timeouts
+    transferEngine.setTimeouts(options.connectTimeout, options.lowSpeedTime);
+    cacheEnabled = options.cacheEnabled;
+
+    // Select the json parser
+    if(options.parser == "jsoncpp"){
+        parserType = ParserType::JsonCppParser;
+    }
+    else if(options.parser == "stream"){
+        parserType = ParserType::StreamParser;
+    }
+    else if(options.parser == "simd"){
+        parserType = ParserType::SimdParser;
     }
-    // If there is no product based on the given release title nor release codename
     else{
-        // Inform user about that there is no product found
-        if(searchByReleaseTitle){
-            std::cout << "Could not find a matching ubuntu release title." << std::endl;
-        }
-        else{
-            std::cout << "Could not find a matching ubuntu release codename." << std::endl;
-        }
+        throw std::invalid_argument("Unknown parser '" + options.parser + "', please use 'stream', 'simd' or 'jsoncpp'.");
     }
 
-    return 0;
+    // The catalog of the previous settings is not valid anymore
+    catalog.reset();
 }
 
-int UCIIParser::doOperationFindVersions(std::string releaseTitle, std::string releaseCodename, bool bypassHeadingText){
-    bool curlParseOk = obtainJsonFile();
-
-    // Return immediately if json file reading caused an error
-    if(!curlParseOk){
-        return 1;
+std::shared_ptr<const ColumnarCatalog> UCIIParser::columnarCatalog(const std::shared_ptr<const ColumnarCatalog>& current){
+    // Keep the current catalog while the index shows that the json file did not change, the streams are revalidated
+    // by their conditional requests instead
+    std::string indexStamp;
+    if(current && cacheEnabled && streams.empty() && fetchIndexStamp(indexStamp) && indexStamp == feedCache.indexUpdated()){
+        feedCache.touch();
+        return current;
     }
 
-    // Default behaviour is searching a product by input release title
-    bool searchByReleaseTitle = true;
-
-    // release title is prioritized
-    if(releaseTitle.empty()){
-        // switch to search by release codename
-        searchByReleaseTitle = false;
-        // Do not display the information if function is called by doOperationFetchSha256
-        if(!bypassHeadingText)
-            std::cout << "Searching by codename: " << releaseCodename << std::endl;
-    }
-    else{
-        // Do not display the information if function is called by doOperationFetchSha256
-        if(!bypassHeadingText)
-            std::cout << "Searching by title: " << releaseTitle << std::endl;
+    if(!obtainJsonFile(ViewFields::Versions)){
+        return nullptr;
     }
 
-    // Flag to indicate that a product found by given title or codename
-    bool found = false;
+    // The compact columnar form is kept, the view of the parser is released once it is copied
+    std::shared_ptr<const ColumnarCatalog> columnar = std::make_shared<const ColumnarCatalog>(catalog->feedView());
+    catalog.reset();
 
-    // Search among all products in the json file
-    for(const Json::Value& product : jsonData["products"]){
-        // Continue if the architecture is not amd64
-        if(product["arch"].asString() != "amd64"){
-            continue;
-        }
-        // If the architecture is amd64
-        else{
-            // Fetch release title and the codename
-            std::string t_releaseTitle = product["release_title"].asString();
-            std::string t_releaseCodename = product["release_codename"].asString();
-            std::string t_availableVersions{""};
-
-            // If search is based on the release title
-            if(searchByReleaseTitle){
-                // If product release title matches
-                if(t_releaseTitle == releaseTitle){
-                    // Get all available version numbers
-                    auto versionNames = product["versions"].getMemberNames();
-
-                    // Merge version numbers together to display
-                    for(auto version: versionNames){
-                        t_availableVersions += version + ", ";
-                    }
+    return columnar;
+}
 
-                    // Delete last ', ' characters
-                    t_availableVersions = t_availableVersions.substr(0, t_availableVersions.size() - 2);
+void UCIIParser::setMessageStreams(std::ostream& errors, std::ostream& warnings){
+    errorStream = &errors;
+    warningStream = &warnings;
+}
 
-                    // Display the available version numbers for given release title/codename
-                    std::cout << "Please use one of the following version numbers : " << t_availableVersions << std::endl;
+// Destination of the downloaded body
+struct FeedTransfer{
+    CURL* curl{nullptr};
+    // Response code, read when the first chunk of the body arrives
+    long httpCode{0};
+    // Local files have no response code, they are successful once they are read
+    bool localFile{false};
+    bool httpCodeChecked{false};
+    // Cache to store the body, null if the cache is disabled
+    FeedCache* cache{nullptr};
+    bool storing{false};
+    // Stream parser consuming the body, the body is collected into 'body' if null or if keepBody is set
+    JsonStreamParser* parser{nullptr};
+    bool keepBody{false};
+    std::string body;
+    // Decoded bytes of the successful body and the time spent in the parser while receiving it
+    std::uint64_t bodyBytes{0};
+    double parseSeconds{0};
+};
 
-                    // Set flag as positive
-                    found = true;
+// Curl callback function
+std::size_t curlWriteCallback(
+            const char* in,
+            std::size_t size,
+            std::size_t num,
+            FeedTransfer* out)
+    {
+        const std::size_t totalBytes(size * num);
+
+        // Start storing the body once the response is known to be successful
+        if(!out->httpCodeChecked){
+            curl_easy_getinfo(out->curl, CURLINFO_RESPONSE_CODE, &out->httpCode);
+            out->httpCodeChecked = true;
+
+            if(out->localFile && out->httpCode == 0){
+                out->httpCode = 200;
+            }
+
+            if(out->httpCode == 200 && out->cache){
+                out->storing = out->cache->beginStore();
+            }
+        }
+
+        // Bodies of the unsuccessful responses are not used
+        if(out->httpCode != 200){
+            return totalBytes;
+        }
+
+        out->bodyBytes += totalBytes;
+
+        if(out->storing && !out->cache->appendBody(in, totalBytes)){
+            out->cache->abortStore();
+            out->storing = false;
+        }
+
+        if(out->parser){
+            // Abort the transfer if the body is not a valid json document
+            RunStats::Timer timer(out->parseSeconds);
+            if(!out->parser->feed(in, totalBytes)){
+                return 0;
+            }
+        }
+        if(!out->parser || out->keepBody){
+            out->body.append(in, totalBytes);
+        }
+
+        return totalBytes;
+    }
+
+// Validators of the http response
+struct ResponseValidators{
+    std::string etag;
+    std::string lastModified;
+    // Not a validator, kept for the statistics
+    std::string contentEncoding;
+};
+
+// Curl header callback function, collects the cache validators of the response
+std::size_t curlHeaderCallback(
+            const char* in,
+            std::size_t size,
+            std::size_t num,
+            ResponseValidators* out)
+    {
+        const std::size_t totalBytes(size * num);
+        std::string header(in, totalBytes);
+
+        std::size_t separator = header.find(':');
+        if(separator != std::string::npos){
+            std::string name = header.substr(0, separator);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c){ return std::tolower(c); });
+
+            // Trim the leading spaces and the trailing line ending of the value
+            std::size_t first = header.find_first_not_of(" \t", separator + 1);
+            std::size_t last = header.find_last_not_of(" \t\r\n");
+            std::string value = (first == std::string::npos || last < first) ? "" : header.substr(first, last - first + 1);
+
+            if(name == "etag"){
+                out->etag = value;
+            }
+            else if(name == "last-modified"){
+                out->lastModified = value;
+            }
+            else if(name == "content-encoding"){
+                out->contentEncoding = value;
+            }
+        }
+
+        return totalBytes;
+    }
+
+// A request of the json file to the source or one of its mirrors
+struct FeedAttempt{
+    std::string url;
+    // Reported in the statistics: 'feed', 'feed:hedge' or 'feed:retry'
+    std::string purpose;
+    FeedTransfer transfer;
+    ResponseValidators validators;
+    struct curl_slist* conditionalHeaders{nullptr};
+    HedgePolicy::Clock::time_point started;
+    bool firstByte{false};
+    // Products of the body, built while it is being downloaded if the stream parser is selected
+    FeedView view;
+    std::unique_ptr<ProductViewBuilder> builder;
+    std::unique_ptr<JsonStreamParser> parser;
+};
+
+bool UCIIParser::obtainJsonFile(ViewFields fields){
+    // Reuse the view if it is already built by a previous operation with the required fields. A view of the items has
+    // all architectures, the amd64 operations can not use it.
+    if(catalog && (loadedFields == fields || (loadedFields == ViewFields::Versions && fields == ViewFields::Titles))){
+        return true;
+    }
+
+    RunStats::Timer timer(stats.obtainSeconds);
+
+    // Rebuild the catalog of an earlier time from the history
+    if(asOf != 0){
+        return loadHistory(fields);
+    }
+
+    // Answer from the binary snapshot if one is given, it only has the disk1.img items of amd64 and does not know the
+    // streams of the products
+    if(!snapshotPath.empty() && fields != ViewFields::Items && streams.empty()){
+        return loadSnapshot(fields);
+    }
+
+    return fetchJsonFile(fields);
+}
+
+bool UCIIParser::loadSnapshot(ViewFields fields){
+    CatalogSnapshot snapshot;
+    std::string staleReason;
+
+    if(!snapshot.open(snapshotPath)){
+        staleReason = snapshot.errorMessage();
+    }
+    // Snapshot is outdated if it is older than the max-age (unless the index shows that the json file it was built
+    // from is still current) or a newer json file is already cached
+    else if(std::time(nullptr) - snapshot.builtAt() >= feedCache.maxAge()){
+        std::string indexStamp;
+        if(!fetchIndexStamp(indexStamp) || CatalogSnapshot::parseFeedTimestamp(indexStamp) != snapshot.sourceTimestamp()){
+            staleReason = "Snapshot is older than the max-age";
+        }
+    }
+    else if(cacheEnabled && feedCache.fetchedAt() > snapshot.builtAt()){
+        staleReason = "Snapshot is older than the cached json file";
+    }
+
+    if(staleReason.empty()){
+        {
+        RunStats::Timer timer(stats.parseSeconds);
+        snapshot.toView(feedView, fields);
+        }
+        stats.source = "snapshot";
+        adoptFeedView(fields);
+        return true;
+    }
+
+    // Rebuild the snapshot from the json file
+    *warningStream << staleReason << ", rebuilding " << snapshotPath << std::endl;
+
+    if(!fetchJsonFile(ViewFields::Versions)){
+        return false;
+    }
+
+    std::string error;
+    if(!CatalogSnapshot::write(catalog->feedView(), snapshotPath, error)){
+        *warningStream << error << std::endl;
+    }
+
+    return true;
+}
+
+bool UCIIParser::fetchJsonFile(ViewFields fields){
+    // The catalog of several streams is aggregated from all of their json files
+    if(!streams.empty()){
+        return fetchStreams(fields);
+    }
+
+    feedView = FeedView();
+    catalog.reset();
+
+    // Local files are parsed in place, neither curl nor the cache is involved
+    if(isLocalSource()){
+        return loadLocalFile(fields);
+    }
+
+    // Skip the network entirely while the cached body is younger than the max-age, the watch polls always revalidate
+    if(!watching && cacheEnabled && feedCache.isFresh()){
+        if(loadCachedJsonFile(fields)){
+            return true;
+        }
+        // A corrupt body would be revalidated by a 304 forever, it is fetched again unconditionally
+        feedCache.discard();
+    }
+
+    // Ask the small index first, the cached body is still current if the stamp of its entry did not change
+    std::string indexStamp;
+    bool indexKnown = cacheEnabled && fetchIndexStamp(indexStamp);
+    if(indexKnown && feedCache.hasBody() && indexStamp == feedCache.indexUpdated()){
+        if(watching){
+            feedCache.touch();
+            feedUnchanged = true;
+            return true;
+        }
+        if(loadCachedJsonFile(fields)){
+            feedCache.touch();
+            return true;
+        }
+        feedCache.discard();
+    }
+
+    std::unique_ptr<FeedAttempt> attempt = requestJsonFile(fields);
+
+    // The next invocation starts from the times to the first byte observed so far
+    if(cacheEnabled){
+        feedCache.setFirstByte(hedgePolicy.smoothedFirstByte(), hedgePolicy.firstByteDeviation());
+    }
+
+    // If the cached body is still valid, it is already parsed
+    if (attempt && attempt->transfer.httpCode == 304)
+    {
+        feedCache.touch();
+        if(indexKnown){
+            feedCache.setIndexUpdated(indexStamp);
+        }
+        if(watching){
+            feedUnchanged = true;
+        }
+        return true;
+    }
+    // If returned with no error, the body is already parsed
+    else if (attempt)
+    {
+        stats.source = "network";
+        feedView = std::move(attempt->view);
+        adoptFeedView(fields);
+
+        // Body of the request that held the store is already on the disk, the others are kept in memory
+        bool stored = true;
+        if (attempt->transfer.storing)
+        {
+            stored = feedCache.commitStore(attempt->validators.etag, attempt->validators.lastModified);
+        }
+        else if (cacheEnabled && attempt->transfer.keepBody)
+        {
+            stored = feedCache.store(attempt->transfer.body, attempt->validators.etag, attempt->validators.lastModified);
+        }
+        else
+        {
+            return true;
+        }
+
+        if (!stored)
+        {
+            *warningStream << "Could not write the cache directory " << feedCache.directory() << std::endl;
+        }
+        else if (indexKnown)
+        {
+            feedCache.setIndexUpdated(indexStamp);
+        }
+
+        return true;
+    }
+
+    // Fall back to the outdated cached body if the remote is unreachable
+    if (cacheEnabled && feedCache.hasBody())
+    {
+        *warningStream << "Couldn't GET from " << sourceUrl << " - using the cached copy" << std::endl;
+        if(watching){
+            feedUnchanged = true;
+            return true;
+        }
+        if(loadCachedJsonFile(fields)){
+            return true;
+        }
+        feedCache.discard();
+        *errorStream << "Couldn't GET from " << sourceUrl << " and the cached copy is corrupt - exiting" << std::endl;
+        return false;
+    }
+    else
+    {
+        *errorStream << "Couldn't GET from " << sourceUrl << " - exiting" << std::endl;
+        return false;
+    }
+
+    return false;
+}
+
+std::unique_ptr<FeedAttempt> UCIIParser::requestJsonFile(ViewFields fields){
+    // The source is requested first, the mirrors in turn by the hedges and the retries
+    std::vector<const std::string*> sources{&sourceUrl};
+    for(const std::string& mirror : mirrorUrls){
+        sources.push_back(&mirror);
+    }
+
+    // Every source is requested once, the failures may be retried
+    std::size_t requestLimit = sources.size() + hedgePolicy.retries();
+    std::size_t requested = 0;
+    unsigned failures = 0;
+
+    CURLM* multi = transferEngine.acquireMulti();
+    std::vector<std::unique_ptr<FeedAttempt>> running;
+    std::unique_ptr<FeedAttempt> winner;
+    // The body is streamed into the cache by a single request at a time, the others keep it in memory until they win
+    FeedAttempt* storingAttempt = nullptr;
+    // A retry waits for the backoff of the previous failure
+    HedgePolicy::Clock::time_point retryAt = hedgePolicy.now();
+
+    auto startRequest = [&](const char* purpose){
+        auto attempt = std::make_unique<FeedAttempt>();
+        attempt->url = *sources[requested % sources.size()];
+        attempt->purpose = purpose;
+        requested++;
+
+        // The engine applies the url, timeouts, redirects and the compressed transfer options
+        CURL* curl = transferEngine.acquire(attempt->url);
+        attempt->transfer.curl = curl;
+        attempt->transfer.localFile = attempt->url.compare(0, 7, "file://") == 0;
+        if(cacheEnabled && !storingAttempt){
+            attempt->transfer.cache = &feedCache;
+            storingAttempt = attempt.get();
+        }
+        else{
+            attempt->transfer.keepBody = cacheEnabled;
+        }
+
+        // The stream parser builds the view while the body is being downloaded
+        if(parserType == ParserType::StreamParser){
+            attempt->builder = std::make_unique<ProductViewBuilder>(attempt->view, "amd64", fields);
+            attempt->parser = std::make_unique<JsonStreamParser>(*attempt->builder);
+            attempt->transfer.parser = attempt->parser.get();
+        }
+
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &attempt->transfer);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &attempt->validators);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, attempt.get());
+
+        // Revalidate the cached body by a conditional request, server answers 304 without a body if it is not modified
+        if(cacheEnabled && feedCache.hasBody()){
+            if(!feedCache.etag().empty()){
+                attempt->conditionalHeaders = curl_slist_append(attempt->conditionalHeaders, ("If-None-Match: " + feedCache.etag()).c_str());
+            }
+            if(!feedCache.lastModified().empty()){
+                attempt->conditionalHeaders = curl_slist_append(attempt->conditionalHeaders, ("If-Modified-Since: " + feedCache.lastModified()).c_str());
+            }
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, attempt->conditionalHeaders);
+        }
+
+        // A hedge of a source that is still being requested must not wait behind the same (possibly stalled) connection
+        for(const std::unique_ptr<FeedAttempt>& other : running){
+            if(other->url == attempt->url){
+                curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+            }
+        }
 
-                    break;
+        attempt->started = hedgePolicy.now();
+        curl_multi_add_handle(multi, curl);
+        running.push_back(std::move(attempt));
+    };
+
+    auto endRequest = [&](FeedAttempt& attempt, bool cancelled){
+        curl_multi_remove_handle(multi, attempt.transfer.curl);
+        stats.recordTransfer(attempt.transfer.curl, cancelled ? attempt.purpose + ":cancelled" : attempt.purpose, attempt.transfer.bodyBytes, attempt.validators.contentEncoding);
+        stats.parseSeconds += attempt.transfer.parseSeconds;
+        transferEngine.release(attempt.transfer.curl);
+        attempt.transfer.curl = nullptr;
+        curl_slist_free_all(attempt.conditionalHeaders);
+        attempt.conditionalHeaders = nullptr;
+    };
+
+    startRequest("feed");
+
+    while(!winner && (!running.empty() || requested < requestLimit)){
+        auto now = hedgePolicy.now();
+        auto wakeAt = now + std::chrono::seconds(1);
+
+        if(requested < requestLimit){
+            if(running.empty()){
+                // Retry once the backoff is over
+                if(now >= retryAt){
+                    startRequest("feed:retry");
+                }
+                else{
+                    wakeAt = retryAt;
                 }
             }
-            // If search is based on the release codename
-            else{
-                // If product codename matches
-                if(t_releaseCodename == releaseCodename){
-                    // Get all available version numbers
-                    auto versionNames = product["versions"].getMemberNames();
-
-                    // Merge version numbers together to display
-                    for(auto version: versionNames){
-                        t_availableVersions += version + ", ";
+            else if(running.size() < max_hedged_requests){
+                // Hedge while no request has produced its first byte, the newest one had its hedge delay to do so
+                bool answered = false;
+                for(const std::unique_ptr<FeedAttempt>& attempt : running){
+                    answered = answered || attempt->firstByte;
+                }
+                auto hedgeAt = hedgePolicy.hedgeAt(running.back()->started);
+                if(!answered && now >= hedgeAt){
+                    startRequest("feed:hedge");
+                }
+                else if(!answered){
+                    wakeAt = std::min(wakeAt, hedgeAt);
+                }
+            }
+        }
+
+        int stillRunning = 0;
+        curl_multi_perform(multi, &stillRunning);
+
+        // Times to the first byte adapt the hedge delay
+        for(const std::unique_ptr<FeedAttempt>& attempt : running){
+            curl_off_t firstByte = 0;
+            if(!attempt->firstByte && curl_easy_getinfo(attempt->transfer.curl, CURLINFO_STARTTRANSFER_TIME_T, &firstByte) == CURLE_OK && firstByte > 0){
+                attempt->firstByte = true;
+                hedgePolicy.recordFirstByte(static_cast<double>(firstByte) / 1000000.0);
+            }
+        }
+
+        int remaining = 0;
+        while(!winner){
+            CURLMsg* message = curl_multi_info_read(multi, &remaining);
+            if(!message){
+                break;
+            }
+            if(message->msg != CURLMSG_DONE){
+                continue;
+            }
+
+            FeedAttempt* attempt = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&attempt));
+            CURLcode curlCode = message->data.result;
+
+            curl_easy_getinfo(attempt->transfer.curl, CURLINFO_RESPONSE_CODE, &attempt->transfer.httpCode);
+            if(attempt->transfer.localFile && attempt->transfer.httpCode == 0 && curlCode == CURLE_OK){
+                attempt->transfer.httpCode = 200;
+            }
+
+            // A response is valid if the cached body is current and parses or the whole body is a json document, the
+            // watch polls do not parse an unchanged body
+            bool valid = false;
+            bool corruptCache = false;
+            std::string error;
+            if(curlCode == CURLE_OK && attempt->transfer.httpCode == 304){
+                valid = cacheEnabled && feedCache.hasBody() && (watching || loadCachedJsonFile(fields));
+                corruptCache = !valid && cacheEnabled && feedCache.hasBody();
+            }
+            else if(curlCode == CURLE_OK && attempt->transfer.httpCode == 200){
+                RunStats::Timer timer(attempt->transfer.parseSeconds);
+                if(attempt->parser){
+                    valid = attempt->parser->finish();
+                    if(valid){
+                        attempt->builder->finish();
+                    }
+                    else{
+                        error = parseErrorMessage("url " + attempt->url, attempt->parser->errorMessage(), attempt->transfer.body, attempt->parser->errorOffset());
                     }
+                }
+                else{
+                    valid = parseBody("url " + attempt->url, attempt->transfer.body, parserType, fields, attempt->view, error);
+                }
+            }
 
-                    // Delete last ', ' characters
-                    t_availableVersions = t_availableVersions.substr(0, t_availableVersions.size() - 2);
+            endRequest(*attempt, false);
 
-                    // Display the available version numbers for given release title/codename
-                    std::cout << "Please use one of the following version numbers : " << t_availableVersions << std::endl;
+            // Only the store of the winner is kept
+            if(attempt == storingAttempt && !(valid && attempt->transfer.httpCode == 200)){
+                if(attempt->transfer.storing){
+                    feedCache.abortStore();
+                    attempt->transfer.storing = false;
+                }
+                storingAttempt = nullptr;
+            }
 
-                    // Set flag as positive
-                    found = true;
+            auto position = std::find_if(running.begin(), running.end(), [attempt](const std::unique_ptr<FeedAttempt>& other){ return other.get() == attempt; });
+            std::unique_ptr<FeedAttempt> finished = std::move(*position);
+            running.erase(position);
+
+            if(valid){
+                winner = std::move(finished);
+                break;
+            }
 
-                    break;
+            // A corrupt cached body is dropped, the other conditional requests can only revalidate it and are cancelled
+            // in favour of an unconditional one that does not count as a retry
+            if(corruptCache){
+                feedCache.discard();
+                for(auto other = running.begin(); other != running.end();){
+                    if(!(*other)->conditionalHeaders){
+                        ++other;
+                        continue;
+                    }
+                    endRequest(**other, true);
+                    if(other->get() == storingAttempt){
+                        if((*other)->transfer.storing){
+                            feedCache.abortStore();
+                        }
+                        storingAttempt = nullptr;
+                    }
+                    other = running.erase(other);
                 }
+                requestLimit++;
+                startRequest("feed:retry");
+                continue;
+            }
+
+            failures++;
+            if(error.empty() && curlCode == CURLE_WRITE_ERROR && attempt->parser){
+                error = parseErrorMessage("url " + attempt->url, attempt->parser->errorMessage(), attempt->transfer.body, attempt->parser->errorOffset());
             }
+            if(error.empty()){
+                error = curlCode != CURLE_OK ? curl_easy_strerror(curlCode) : "HTTP " + std::to_string(finished->transfer.httpCode);
+            }
+            *warningStream << "Couldn't GET from " << finished->url << " - " << error << std::endl;
+
+            if(running.empty()){
+                retryAt = hedgePolicy.retryAt(failures);
+                wakeAt = retryAt;
+            }
+        }
+
+        if(!winner && (!running.empty() || requested < requestLimit)){
+            auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - hedgePolicy.now()).count();
+            curl_multi_poll(multi, nullptr, 0, static_cast<int>(std::max<long long>(timeout, 1)), nullptr);
         }
     }
 
-    // If a product by given release title or codename is not found
-    if(!found){
-        // Inform user
-        if(searchByReleaseTitle){
-            std::cout << "Could not find a matching ubuntu release title." << std::endl;
+    // The slower requests are cancelled, their partial bodies are dropped
+    for(const std::unique_ptr<FeedAttempt>& attempt : running){
+        endRequest(*attempt, true);
+        if(attempt.get() == storingAttempt && attempt->transfer.storing){
+            feedCache.abortStore();
         }
-        else{
-            std::cout << "Could not find a matching ubuntu release codename." << std::endl;
+    }
+
+    transferEngine.releaseMulti(multi);
+
+    // The body is not needed anymore unless it is to be stored
+    if(winner && !winner->transfer.keepBody){
+        std::string().swap(winner->transfer.body);
+    }
+
+    return winner;
+}
+
+// Progress of the transfer and the parsing of a single stream
+struct StreamFetch{
+    FeedTransfer transfer;
+    ResponseValidators validators;
+    struct curl_slist* conditionalHeaders{nullptr};
+    // Where the parsed body comes from, reported in the statistics
+    const char* source{""};
+    // Products of the stream, filled by the parsing thread
+    std::thread worker;
+    FeedView view;
+    bool parseOk{false};
+    bool cacheWriteFailed{false};
+    // The cached body is current (or the remote is unreachable)
+    bool unchanged{false};
+    double parseSeconds{0};
+    std::string error;
+};
+
+// Body parsed by the thread of a stream
+enum class StreamBody{
+    LocalFile,
+    Cached,
+    Downloaded
+};
+
+bool UCIIParser::fetchStreams(ViewFields fields){
+    feedView = FeedView();
+    catalog.reset();
+
+    std::vector<StreamFetch> fetches(streams.size());
+
+    // Every body is parsed by a thread of its own, the threads only touch their stream, its fetch and its cache
+    auto startParsing = [this, fields, &fetches](std::size_t index, StreamBody body){
+        fetches[index].worker = std::thread([this, fields, body, &fetch = fetches[index], &stream = streams[index]]{
+            RunStats::Timer timer(fetch.parseSeconds);
+
+            if(body == StreamBody::LocalFile){
+                // file:///path or file://localhost/path
+                std::string path = stream.url.substr(7);
+                if(path.compare(0, 9, "localhost") == 0){
+                    path.erase(0, 9);
+                }
+
+                MappedFile file;
+                if(!file.open(path)){
+                    fetch.error = file.errorMessage();
+                    return;
+                }
+                file.adviseSequential();
+                fetch.parseOk = parseBody("file " + path, std::string_view(file.data(), file.size()), parserType, fields, fetch.view, fetch.error);
+            }
+            else if(body == StreamBody::Cached){
+                MappedFile file;
+                if(!stream.cache.mapBody(file)){
+                    fetch.error = "Could not read the cached json file: " + file.errorMessage();
+                    return;
+                }
+                file.adviseSequential();
+                fetch.parseOk = parseBody("cache " + stream.cache.bodyPath(), std::string_view(file.data(), file.size()), parserType, fields,
+                                          fetch.view, fetch.error);
+            }
+            else{
+                fetch.parseOk = parseBody("url " + stream.url, fetch.transfer.body, parserType, fields, fetch.view, fetch.error);
+                std::string().swap(fetch.transfer.body);
+
+                // Store the body only if it is a valid json document
+                if(fetch.transfer.storing && !fetch.parseOk){
+                    stream.cache.abortStore();
+                }
+                else if(fetch.transfer.storing){
+                    fetch.cacheWriteFailed = !stream.cache.commitStore(fetch.validators.etag, fetch.validators.lastModified);
+                }
+            }
+        });
+    };
+
+    // Local files and fresh cached bodies are parsed right away, the others are requested at the same time
+    CURLM* multi = transferEngine.acquireMulti();
+    std::size_t pendingTransfers = 0;
+
+    for(std::size_t index = 0; index < streams.size(); index++){
+        FeedStream& stream = streams[index];
+        StreamFetch& fetch = fetches[index];
+
+        if(stream.url.compare(0, 7, "file://") == 0){
+            fetch.source = "local";
+            startParsing(index, StreamBody::LocalFile);
+            continue;
+        }
+
+        if(!watching && cacheEnabled && stream.cache.isFresh()){
+            fetch.source = "cache";
+            startParsing(index, StreamBody::Cached);
+            continue;
+        }
+
+        CURL* curl = transferEngine.acquire(stream.url);
+        fetch.transfer.curl = curl;
+        fetch.transfer.cache = cacheEnabled ? &stream.cache : nullptr;
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &fetch.transfer);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &fetch.validators);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, &fetch);
+
+        // Revalidate the cached body by a conditional request
+        if(cacheEnabled && stream.cache.hasBody()){
+            if(!stream.cache.etag().empty()){
+                fetch.conditionalHeaders = curl_slist_append(fetch.conditionalHeaders, ("If-None-Match: " + stream.cache.etag()).c_str());
+            }
+            if(!stream.cache.lastModified().empty()){
+                fetch.conditionalHeaders = curl_slist_append(fetch.conditionalHeaders, ("If-Modified-Since: " + stream.cache.lastModified()).c_str());
+            }
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, fetch.conditionalHeaders);
+        }
+
+        curl_multi_add_handle(multi, curl);
+        pendingTransfers++;
+    }
+
+    while(pendingTransfers > 0){
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        // Hand every completed body to its parsing thread while the other transfers go on
+        int remaining = 0;
+        while(CURLMsg* message = curl_multi_info_read(multi, &remaining)){
+            if(message->msg != CURLMSG_DONE){
+                continue;
+            }
+
+            StreamFetch* fetch = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&fetch));
+            curl_multi_remove_handle(multi, message->easy_handle);
+            pendingTransfers--;
+
+            std::size_t index = static_cast<std::size_t>(fetch - fetches.data());
+            FeedStream& stream = streams[index];
+
+            curl_easy_getinfo(fetch->transfer.curl, CURLINFO_RESPONSE_CODE, &fetch->transfer.httpCode);
+            stats.recordTransfer(fetch->transfer.curl, "feed:" + stream.name, fetch->transfer.bodyBytes, fetch->validators.contentEncoding);
+            transferEngine.release(fetch->transfer.curl);
+            curl_slist_free_all(fetch->conditionalHeaders);
+            fetch->conditionalHeaders = nullptr;
+
+            bool transferOk = message->data.result == CURLE_OK;
+
+            // If the cached body is still valid, the watch polls parse it only if another stream changed
+            if(transferOk && fetch->transfer.httpCode == 304 && cacheEnabled && stream.cache.hasBody()){
+                stream.cache.touch();
+                fetch->source = "cache";
+                fetch->unchanged = true;
+                if(!watching){
+                    startParsing(index, StreamBody::Cached);
+                }
+                continue;
+            }
+            if(transferOk && fetch->transfer.httpCode == 200){
+                fetch->source = "network";
+                startParsing(index, StreamBody::Downloaded);
+                continue;
+            }
+
+            if(fetch->transfer.storing){
+                stream.cache.abortStore();
+                fetch->transfer.storing = false;
+            }
+
+            // Fall back to the outdated cached body if the remote is unreachable
+            if(cacheEnabled && stream.cache.hasBody()){
+                *warningStream << "Couldn't GET from " << stream.url << " - using the cached copy" << std::endl;
+                fetch->source = "cache";
+                fetch->unchanged = true;
+                if(!watching){
+                    startParsing(index, StreamBody::Cached);
+                }
+            }
+            else{
+                fetch->error = "Couldn't GET from " + stream.url;
+            }
+        }
+
+        if(pendingTransfers > 0){
+            curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+    }
+
+    transferEngine.releaseMulti(multi);
+
+    // Nothing to parse for a watch poll if no stream changed, otherwise the cached bodies of the others are needed
+    if(watching){
+        bool allUnchanged = true;
+        for(const StreamFetch& fetch : fetches){
+            allUnchanged = allUnchanged && fetch.unchanged;
+        }
+        if(allUnchanged){
+            feedUnchanged = true;
+            return true;
+        }
+        for(std::size_t index = 0; index < streams.size(); index++){
+            if(fetches[index].unchanged){
+                startParsing(index, StreamBody::Cached);
+            }
+        }
+    }
+
+    // Merge the streams in the given order, lookups by title or codename find the product of the first stream
+    bool fetchOk = true;
+    std::time_t updatedAt = 0;
+    std::string sources;
+
+    for(std::size_t index = 0; index < streams.size(); index++){
+        StreamFetch& fetch = fetches[index];
+        if(fetch.worker.joinable()){
+            fetch.worker.join();
+        }
+        stats.parseSeconds += fetch.parseSeconds;
+
+        if(fetch.cacheWriteFailed){
+            *warningStream << "Could not write the cache directory " << streams[index].cache.directory() << std::endl;
+        }
+
+        if(!fetch.parseOk){
+            *errorStream << "Could not load the stream " << streams[index].name << ": " << fetch.error << " - exiting" << std::endl;
+            // A corrupt cached body is not revalidated again, the next run requests it unconditionally
+            if(cacheEnabled && std::string_view(fetch.source) == "cache"){
+                streams[index].cache.discard();
+            }
+            fetchOk = false;
+            continue;
+        }
+
+        for(ProductView& product : fetch.view.products){
+            product.stream = streams[index].name;
+            feedView.products.push_back(std::move(product));
+        }
+
+        // The catalog is as recent as its most recent stream
+        std::time_t streamUpdatedAt = CatalogSnapshot::parseFeedTimestamp(fetch.view.updated);
+        if(feedView.updated.empty() || streamUpdatedAt > updatedAt){
+            updatedAt = streamUpdatedAt;
+            feedView.updated = fetch.view.updated;
+        }
+
+        sources += (sources.empty() ? "" : ",") + streams[index].name + "=" + fetch.source;
+    }
+
+    if(!fetchOk){
+        feedView = FeedView();
+        return false;
+    }
+
+    stats.source = sources;
+    adoptFeedView(fields);
+
+    return true;
+}
+
+bool UCIIParser::parseBody(const std::string& source, std::string_view bytes, ParserType parser, ViewFields fields, FeedView& view,
+                           std::string& error) const{
+    std::string detail;
+    std::size_t offset = 0;
+
+    if(parser == ParserType::JsonCppParser){
+        // The structured errors of the reader tell the offset of the error
+        Json::Value jsonData;
+        Json::Reader reader;
+        if(reader.parse(bytes.data(), bytes.data() + bytes.size(), jsonData, false)){
+            ProductViewBuilder::fromJson(jsonData, view, "amd64", fields);
+            return true;
+        }
+
+        std::vector<Json::Reader::StructuredError> errors = reader.getStructuredErrors();
+        if(!errors.empty()){
+            offset = static_cast<std::size_t>(errors.front().offset_start);
+            detail = errors.front().message + " at offset " + std::to_string(offset);
+        }
+    }
+    else{
+        // The strings are passed to the builder as views into the body, the body outlives the parsing
+        ProductViewBuilder builder(view, "amd64", fields);
+        bool parseOk;
+
+        if(parser == ParserType::SimdParser){
+            JsonStructuralParser structuralParser(builder);
+            parseOk = structuralParser.parse(bytes.data(), bytes.size());
+            detail = structuralParser.errorMessage();
+            offset = structuralParser.errorOffset();
+        }
+        else{
+            JsonStreamParser streamParser(builder);
+            parseOk = streamParser.feed(bytes.data(), bytes.size()) && streamParser.finish();
+            detail = streamParser.errorMessage();
+            offset = streamParser.errorOffset();
+        }
+
+        if(parseOk){
+            builder.finish();
+            return true;
+        }
+    }
+
+    view = FeedView();
+    error = parseErrorMessage(source, detail, bytes, offset);
+    return false;
+}
+
+bool UCIIParser::isLocalSource() const{
+    return sourceUrl.compare(0, 7, "file://") == 0;
+}
+
+bool UCIIParser::loadLocalFile(ViewFields fields){
+    // file:///path or file://localhost/path
+    std::string path = sourceUrl.substr(7);
+    if(path.compare(0, 9, "localhost") == 0){
+        path.erase(0, 9);
+    }
+
+    MappedFile file;
+    if(!file.open(path)){
+        *errorStream << file.errorMessage() << " - exiting" << std::endl;
+        return false;
+    }
+    file.adviseSequential();
+
+    stats.source = "local";
+
+    // The whole document is a single chunk, the parsers pass the strings as views into the mapping
+    bool parseOk;
+    std::string error;
+    {
+    RunStats::Timer timer(stats.parseSeconds);
+    parseOk = parseBody("file " + path, std::string_view(file.data(), file.size()), parserType, fields, feedView, error);
+    }
+    if(!parseOk){
+        *errorStream << error << std::endl;
+        return false;
+    }
+
+    adoptFeedView(fields);
+
+    return true;
+}
+
+bool UCIIParser::fetchIndexStamp(std::string& stamp){
+    // The index is requested from the source only, with mirrors a slow source must not delay the hedged requests
+    if(!mirrorUrls.empty()){
+        return false;
+    }
+
+    // Only the simplestreams layout has an index, <root>/streams/v1/<content>.json
+    std::string root = mirrorRoot();
+    if(sourceUrl.compare(root.size(), 11, "streams/v1/") != 0){
+        return false;
+    }
+
+    std::string relativePath = sourceUrl.substr(root.size());
+    std::string url = root + "streams/v1/index.json";
+    if(url == sourceUrl){
+        return false;
+    }
+
+    CURL* curl = transferEngine.acquire(url);
+
+    // Collect the small body as it is
+    FeedTransfer transfer;
+    transfer.curl = curl;
+    transfer.localFile = url.compare(0, 7, "file://") == 0;
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+
+    ResponseValidators validators;
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &validators);
+
+    // The index only saves a request, it may take as long as the json file may wait for its first byte
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(hedgePolicy.hedgeDelay().count()));
+
+    CURLcode curlCode = curl_easy_perform(curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer.httpCode);
+    if(transfer.localFile && transfer.httpCode == 0 && curlCode == CURLE_OK){
+        transfer.httpCode = 200;
+    }
+    stats.recordTransfer(curl, "index", transfer.bodyBytes, validators.contentEncoding);
+    transferEngine.release(curl);
+
+    if(curlCode != CURLE_OK || transfer.httpCode != 200){
+        return false;
+    }
+
+    Json::Value indexDocument;
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    if(!reader->parse(transfer.body.data(), transfer.body.data() + transfer.body.size(), &indexDocument, nullptr) || !indexDocument.isObject()){
+        return false;
+    }
+
+    // Find the entry of the json file by its path
+    const Json::Value& index = indexDocument["index"];
+    if(!index.isObject()){
+        return false;
+    }
+    for(Json::Value::const_iterator entry = index.begin(); entry != index.end(); ++entry){
+        if((*entry)["path"].asString() == relativePath){
+            stamp = (*entry)["updated"].asString();
+            return !stamp.empty();
+        }
+    }
+
+    return false;
+}
+
+void UCIIParser::adoptFeedView(ViewFields fields){
+    RunStats::Timer timer(stats.catalogBuildSeconds);
+
+    // Catalog takes the ownership of the view and indexes it
+    catalog = std::make_shared<const Catalog>(std::move(feedView));
+    stats.products = catalog->products().size();
+    stats.versions = catalog->versionCount();
+    feedView = FeedView();
+    loadedFields = fields;
+
+    recordHistory();
+}
+
+bool UCIIParser::loadHistory(ViewFields fields){
+    if(fields == ViewFields::Items || !streams.empty()){
+        *errorStream << "The history keeps only the disk1.img items of amd64 of a single json file, 'where' and 'streams' can not be used with 'as-of'" << std::endl;
+        return false;
+    }
+
+    CatalogHistory history(feedCache.historyPath());
+    {
+    RunStats::Timer timer(stats.parseSeconds);
+    if(!history.load(asOf, feedView)){
+        *errorStream << history.errorMessage() << std::endl;
+        return false;
+    }
+    }
+
+    stats.source = "history";
+    adoptFeedView(fields);
+
+    return true;
+}
+
+void UCIIParser::recordHistory(){
+    // The view of the titles has no versions, an earlier catalog is only read from the history
+    if(!cacheEnabled || asOf != 0 || loadedFields != ViewFields::Versions || !streams.empty()){
+        return;
+    }
+
+    // The snapshot does not keep the 'updated' field, it can not be ordered against the recorded catalogs
+    if(stats.source == "snapshot"){
+        return;
+    }
+
+    // The catalog is already recorded if the history did not change since its last record saw the same feed
+    const FeedView& view = catalog->feedView();
+    std::error_code errorCode;
+    std::uint64_t historySize = std::filesystem::file_size(feedCache.historyPath(), errorCode);
+    if(!errorCode && !view.updated.empty() && historySize == feedCache.historySize()
+    && CatalogHistory::hashUpdated(view.updated) == feedCache.historyUpdatedHash()){
+        return;
+    }
+
+    CatalogHistory history(feedCache.historyPath());
+    if(!history.record(view, std::time(nullptr))){
+        *warningStream << history.errorMessage() << std::endl;
+        return;
+    }
+
+    if(history.size() != feedCache.historySize() || history.lastUpdatedHash() != feedCache.historyUpdatedHash()){
+        feedCache.setHistoryTail(history.size(), history.lastUpdatedHash());
+    }
+}
+
+bool UCIIParser::loadCachedJsonFile(ViewFields fields){
+    feedView = FeedView();
+    stats.source = "cache";
+
+    // A cached body that can not be parsed is reported as a warning, the caller discards it and fetches it again. The
+    // body is mapped and parsed in place, reading it is counted as parsing
+    bool parseOk;
+    std::string error;
+    {
+    RunStats::Timer timer(stats.parseSeconds);
+    MappedFile file;
+    parseOk = feedCache.mapBody(file);
+    if(parseOk){
+        file.adviseSequential();
+        parseOk = parseBody("cache " + feedCache.bodyPath(), std::string_view(file.data(), file.size()), parserType, fields, feedView, error);
+    }
+    else{
+        error = "Could not read the cached JSON data: " + file.errorMessage();
+    }
+    }
+
+    if(!parseOk){
+        *warningStream << error << " - discarding the cached copy" << std::endl;
+        feedView = FeedView();
+        return false;
+    }
+
+    adoptFeedView(fields);
+
+    return true;
+}
+
+int UCIIParser::doOperationAllSupportedUbuntuReleases(){
+    bool curlParseOk = obtainJsonFile(ViewFields::Titles);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    // Print the release title and the codename of all amd64 products of the catalog, and their stream if several
+    // streams are aggregated
+    if(!streams.empty()){
+        output.columns({"stream", release_title_key, release_codename_key, "arch"});
+        for(const ProductView& product : catalog->products()){
+            output.row({product.stream, product.releaseTitle, product.releaseCodename, "amd64"});
+        }
+        return 0;
+    }
+
+    output.columns({release_title_key, release_codename_key, "arch"});
+    for(const ProductView& product : catalog->products()){
+        output.row({product.releaseTitle, product.releaseCodename, "amd64"});
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationAllVersions(){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    // Every version of every amd64 product in a single pass
+    if(!streams.empty()){
+        output.columns({"stream", release_title_key, release_codename_key, "arch", version_key, "sha256"});
+        for(const ProductView& product : catalog->products()){
+            for(const VersionView& t_version : product.versions){
+                output.row({product.stream, product.releaseTitle, product.releaseCodename, "amd64", t_version.version, t_version.sha256});
+            }
+        }
+        return 0;
+    }
+
+    output.columns({release_title_key, release_codename_key, "arch", version_key, "sha256"});
+    for(const ProductView& product : catalog->products()){
+        for(const VersionView& t_version : product.versions){
+            output.row({product.releaseTitle, product.releaseCodename, "amd64", t_version.version, t_version.sha256});
+        }
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationCurrentUbuntuLTSVersion(){
+    bool curlParseOk = obtainJsonFile(ViewFields::Titles);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    const ProductView* product;
+    {
+    RunStats::Timer timer(stats.lookupSeconds);
+    product = catalog->latestLTS();
+    }
+
+    // Print the LTS release with the highest release version
+    if(product){
+        RunStats::Timer timer(stats.outputSeconds);
+        output.columns({release_title_key, release_codename_key, "arch"});
+        output.row({product->releaseTitle, product->releaseCodename, "amd64"});
+    }
+
+    return 0;
+}
+
+const ProductView* UCIIParser::resolveRelease(const std::string& release, bool byTitle, std::vector<ReleaseIndex::Candidate>* candidates) const{
+    if(candidates){
+        candidates->clear();
+    }
+
+    const ProductView* product = byTitle ? catalog->findByTitle(release) : catalog->findByCodename(release);
+    if(product || release.empty()){
+        return product;
+    }
+
+    return catalog->releaseIndex().resolve(release, candidates);
+}
+
+// Lists the releases whose names start with the given text, once per release
+static void writeAmbiguousRelease(OutputWriter& output, bool byTitle, const std::vector<ReleaseIndex::Candidate>& candidates){
+    output.text(byTitle ? "Several ubuntu release titles match, please use one of : " : "Several ubuntu release codenames match, please use one of : ");
+
+    std::vector<const ProductView*> listed;
+    for(const ReleaseIndex::Candidate& candidate : candidates){
+        if(std::find(listed.begin(), listed.end(), candidate.product) == listed.end()){
+            output.text(listed.empty() ? "" : ", ").text(byTitle ? candidate.product->releaseTitle : candidate.product->releaseCodename);
+            listed.push_back(candidate.product);
+        }
+    }
+    output.text("\n");
+}
+
+int UCIIParser::doOperationLatest(std::string releaseTitle, std::string releaseCodename){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    bool searchByReleaseTitle = !releaseTitle.empty();
+    bool releaseGiven = searchByReleaseTitle || !releaseCodename.empty();
+
+    // The release is resolved as in the sha256 operation, the latest release is precomputed by the catalog
+    const ProductView* product;
+    std::vector<ReleaseIndex::Candidate> candidates;
+    {
+    RunStats::Timer timer(stats.lookupSeconds);
+    product = !releaseGiven ? catalog->latestRelease() : resolveRelease(searchByReleaseTitle ? releaseTitle : releaseCodename, searchByReleaseTitle, &candidates);
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    if(!product){
+        if(!candidates.empty()){
+            writeAmbiguousRelease(output, searchByReleaseTitle, candidates);
+        }
+        else{
+            output.text(searchByReleaseTitle ? "Could not find a matching ubuntu release title.\n" : "Could not find a matching ubuntu release codename.\n");
+        }
+        return 1;
+    }
+
+    const VersionView* t_version = Catalog::latestVersion(*product);
+    std::string_view versionName = t_version ? std::string_view(t_version->version) : "";
+    std::string_view sha256 = t_version ? std::string_view(t_version->sha256) : "";
+
+    if(!streams.empty()){
+        output.columns({"stream", release_title_key, release_codename_key, "arch", version_key, "sha256"});
+        output.row({product->stream, product->releaseTitle, product->releaseCodename, "amd64", versionName, sha256});
+        return 0;
+    }
+
+    output.columns({release_title_key, release_codename_key, "arch", version_key, "sha256"});
+    output.row({product->releaseTitle, product->releaseCodename, "amd64", versionName, sha256});
+
+    return 0;
+}
+
+int UCIIParser::doOperationSupported(){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    // The supported releases are ordered by the catalog, each with its newest version
+    if(!streams.empty()){
+        output.columns({"stream", release_title_key, release_codename_key, "support_eol", version_key});
+        for(const ProductView* product : catalog->supportedReleases()){
+            const VersionView* t_version = Catalog::latestVersion(*product);
+            output.row({product->stream, product->releaseTitle, product->releaseCodename, product->supportEol, t_version ? std::string_view(t_version->version) : ""});
+        }
+        return 0;
+    }
+
+    output.columns({release_title_key, release_codename_key, "support_eol", version_key});
+    for(const ProductView* product : catalog->supportedReleases()){
+        const VersionView* t_version = Catalog::latestVersion(*product);
+        output.row({product->releaseTitle, product->releaseCodename, product->supportEol, t_version ? std::string_view(t_version->version) : ""});
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationHistory(){
+    CatalogHistory history(feedCache.historyPath());
+    if(!history.scan()){
+        *errorStream << history.errorMessage() << std::endl;
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    output.columns({"recorded", "kind", "changes", "bytes"});
+    for(const CatalogHistory::Record& record : history.records()){
+        output.row({CatalogHistory::formatDate(record.at), CatalogHistory::kindName(record.kind), std::to_string(record.changes), std::to_string(record.length)});
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationFetchSha256(std::string releaseTitle, std::string releaseCodename, std::string version){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    bool searchByReleaseTitle = true;
+
+    // Search by 'release title' is prioritized
+    if(releaseTitle.empty()){
+        // Switch to search by release codename
+        searchByReleaseTitle = false;
+        output.text("Searching by codename: ").text(releaseCodename).text("\n");
+    }
+    else{
+        output.text("Searching by title: ").text(releaseTitle).text("\n");
+    }
+
+    const std::string& releaseName = searchByReleaseTitle ? releaseTitle : releaseCodename;
+
+    // Resolve the product by its title or codename and the version among the available versions of the product
+    const ProductView* product;
+    const VersionView* t_version = nullptr;
+    std::vector<ReleaseIndex::Candidate> candidates;
+    {
+    RunStats::Timer timer(stats.lookupSeconds);
+    product = resolveRelease(releaseName, searchByReleaseTitle, &candidates);
+    if(product){
+        t_version = Catalog::findVersion(*product, version);
+    }
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    // Results and errors are rows of the same columns in the machine readable formats
+    if(output.structured()){
+        output.columns({"release", version_key, "sha256", "error"});
+        output.row({releaseName, version, t_version ? std::string_view(t_version->sha256) : "",
+                    !product ? (candidates.empty() ? "release not found" : "release is ambiguous") : !t_version ? "version not found" : ""});
+        return t_version ? 0 : 1;
+    }
+
+    // If the given text starts the names of several releases
+    if(!product && !candidates.empty()){
+        writeAmbiguousRelease(output, searchByReleaseTitle, candidates);
+        return 1;
+    }
+
+    // If there is no product based on the given release title nor release codename
+    if(!product){
+        // Inform user about that there is no product found
+        if(searchByReleaseTitle){
+            output.text("Could not find a matching ubuntu release title.\n");
+        }
+        else{
+            output.text("Could not find a matching ubuntu release codename.\n");
+        }
+
+        return 1;
+    }
+
+    // Tell which release a partial name is resolved to
+    const std::string& resolvedName = searchByReleaseTitle ? product->releaseTitle : product->releaseCodename;
+    if(resolvedName != releaseName){
+        output.text("Matching ubuntu release : ").text(product->releaseTitle).text(" (").text(product->releaseCodename).text(")\n");
+    }
+
+    // If both product found and a suitable version is found
+    if(t_version){
+        // Display the sha256 result by given release title or codename
+        output.text("sha256 of the disk1.img of the ubuntu release (").text(resolvedName).text(" amd64) is : ").text(t_version->sha256).text("\n");
+    }
+    // If product found but there is no matching version number for this product
+    else{
+        // Inform user about that there is no matching version and display available version numbers
+        if(searchByReleaseTitle){
+            output.text("Matching ubuntu release found by title but no matching version found.\n");
+        }
+        else{
+            output.text("Matching ubuntu release found by codename but no matching version found.\n");
+        }
+        // Listing the versions measures its own lookup and output
+        timer.stop();
+        doOperationFindVersions(releaseTitle, releaseCodename, true);
+        return 1;
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationFindVersions(std::string releaseTitle, std::string releaseCodename, bool bypassHeadingText){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    // Default behaviour is searching a product by input release title
+    bool searchByReleaseTitle = true;
+
+    // release title is prioritized
+    if(releaseTitle.empty()){
+        // switch to search by release codename
+        searchByReleaseTitle = false;
+        // Do not display the information if function is called by doOperationFetchSha256
+        if(!bypassHeadingText)
+            output.text("Searching by codename: ").text(releaseCodename).text("\n");
+    }
+    else{
+        // Do not display the information if function is called by doOperationFetchSha256
+        if(!bypassHeadingText)
+            output.text("Searching by title: ").text(releaseTitle).text("\n");
+    }
+
+    const std::string& releaseName = searchByReleaseTitle ? releaseTitle : releaseCodename;
+
+    // Resolve the product by its title or codename
+    const ProductView* product;
+    std::vector<ReleaseIndex::Candidate> candidates;
+    {
+    RunStats::Timer timer(stats.lookupSeconds);
+    product = resolveRelease(releaseName, searchByReleaseTitle, &candidates);
+    }
+
+    RunStats::Timer timer(stats.outputSeconds);
+
+    // One row per version in the machine readable formats
+    if(output.structured()){
+        output.columns({"release", version_key, "sha256", "error"});
+        if(!product){
+            output.row({releaseName, "", "", candidates.empty() ? "release not found" : "release is ambiguous"});
+            return 1;
+        }
+        for(const VersionView& t_version : product->versions){
+            output.row({releaseName, t_version.version, t_version.sha256, ""});
+        }
+        return 0;
+    }
+
+    // If the given text starts the names of several releases
+    if(!product && !candidates.empty()){
+        writeAmbiguousRelease(output, searchByReleaseTitle, candidates);
+        return 1;
+    }
+
+    // If a product by given release title or codename is not found
+    if(!product){
+        // Inform user
+        if(searchByReleaseTitle){
+            output.text("Could not find a matching ubuntu release title.\n");
+        }
+        else{
+            output.text("Could not find a matching ubuntu release codename.\n");
+        }
+
+        return 1;
+    }
+
+    // Tell which release a partial name is resolved to, unless the sha256 operation already did
+    if(!bypassHeadingText && releaseName != (searchByReleaseTitle ? product->releaseTitle : product->releaseCodename)){
+        output.text("Matching ubuntu release : ").text(product->releaseTitle).text(" (").text(product->releaseCodename).text(")\n");
+    }
+
+    // Display the available version numbers for given release title/codename separated by ', '
+    output.text("Please use one of the following version numbers : ");
+    for(std::size_t i = 0; i < product->versions.size(); i++){
+        output.text(i ? ", " : "").text(product->versions[i].version);
+    }
+    output.text("\n");
+
+    return 0;
+}
+
+int UCIIParser::doOperationBuildSnapshot(std::string path){
+    // Snapshot is always built from the json file
+    bool curlParseOk = fetchJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    std::string error;
+    if(!CatalogSnapshot::write(catalog->feedView(), path, error)){
+        output.text("Could not write the snapshot: ").text(error).text("\n");
+        return 1;
+    }
+
+    std::string releases = std::to_string(catalog->products().size());
+    std::string versions = std::to_string(catalog->versionCount());
+
+    if(output.structured()){
+        output.columns({"path", "releases", "versions"});
+        output.row({path, releases, versions});
+    }
+    else{
+        output.text("Snapshot of ").text(releases).text(" releases and ").text(versions).text(" versions is written to ").text(path).text("\n");
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationBatch(std::string source){
+    // Open the query source
+    std::ifstream queryFile;
+    if(source != "-"){
+        queryFile.open(source);
+
+        if(!queryFile){
+            *errorStream << "Could not open the query file " << source << std::endl;
+            return 1;
+        }
+    }
+    std::istream& queries = (source == "-") ? std::cin : queryFile;
+
+    // Fetch and index the catalog once for all queries
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::size_t queryCount = 0;
+    std::size_t failedCount = 0;
+
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> jsonReader(readerBuilder.newCharReader());
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = "";
+
+    // The text format answers every query in the format of the query, the others use the same columns for all
+    output.columns({"release", version_key, "sha256", "error"});
+
+    std::string line;
+    while(std::getline(queries, line)){
+        // Ignore the line endings of the windows files
+        if(!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+
+        // Skip the empty lines and the comments
+        std::size_t first = line.find_first_not_of(" \t");
+        if(first == std::string::npos || line[first] == '#'){
+            continue;
+        }
+
+        queryCount++;
+
+        bool jsonQuery = line[first] == '{';
+        std::string releaseTitle;
+        std::string releaseCodename;
+        std::string release;
+        std::string version;
+        std::string error;
+
+        if(jsonQuery){
+            // {"release_title": ..., "release_codename": ..., "release": ..., "version": ...}
+            Json::Value query;
+            std::string parseErrors;
+
+            if(!jsonReader->parse(line.data() + first, line.data() + line.size(), &query, &parseErrors) || !query.isObject()){
+                error = "invalid json query";
+            }
+            else{
+                releaseTitle = query.get(release_title_key, "").asString();
+                releaseCodename = query.get(release_codename_key, "").asString();
+                release = query.get("release", "").asString();
+                version = query.get(version_key, "").asString();
+            }
+        }
+        else{
+            // '<release> <version>', the version is the last field separated by a tab or a space
+            std::size_t last = line.find_last_not_of(" \t");
+            std::size_t separator = line.find_last_of(line.find('\t') != std::string::npos ? "\t" : " ", last);
+
+            if(separator == std::string::npos || separator < first){
+                error = "expected '<release> <version>'";
+            }
+            else{
+                version = line.substr(separator + 1, last - separator);
+                std::size_t releaseEnd = line.find_last_not_of(" \t", separator);
+                release = line.substr(first, releaseEnd - first + 1);
+            }
+        }
+
+        // Resolve the product, title is prioritized as in the single query operation
+        RunStats::Timer lookupTimer(stats.lookupSeconds);
+        const ProductView* product = nullptr;
+        if(error.empty()){
+            if(!releaseTitle.empty()){
+                product = catalog->findByTitle(releaseTitle);
+            }
+            else if(!releaseCodename.empty()){
+                product = catalog->findByCodename(releaseCodename);
+            }
+            else if(!release.empty()){
+                product = catalog->findRelease(release);
+            }
+            else{
+                error = "release title or codename is missing";
+            }
+
+            if(error.empty() && version.empty()){
+                error = "version is missing";
+            }
+            else if(error.empty() && !product){
+                error = "release not found";
+            }
+        }
+
+        const VersionView* t_version = error.empty() ? Catalog::findVersion(*product, version) : nullptr;
+        if(error.empty() && !t_version){
+            error = "version not found";
+        }
+
+        if(!error.empty()){
+            failedCount++;
+        }
+        lookupTimer.stop();
+
+        // Write the result in the format of the query
+        const std::string& releaseName = !releaseTitle.empty() ? releaseTitle : !releaseCodename.empty() ? releaseCodename : release;
+        if(output.structured()){
+            output.row({releaseName, version, error.empty() ? std::string_view(t_version->sha256) : "", error});
+        }
+        else if(jsonQuery){
+            Json::Value result;
+            result["release"] = releaseName;
+            result[version_key] = version;
+            if(error.empty()){
+                result["sha256"] = t_version->sha256;
+            }
+            else{
+                result["error"] = error;
+            }
+            output.text(Json::writeString(writerBuilder, result)).text("\n");
+        }
+        else{
+            output.text(releaseName).text("\t").text(version).text("\t");
+            if(error.empty()){
+                output.text(t_version->sha256).text("\n");
+            }
+            else{
+                output.text("error: ").text(error).text("\n");
+            }
+        }
+    }
+
+    output.flush();
+
+    // Report the throughput of the batch
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cerr << "Answered " << queryCount << " queries (" << failedCount << " failed) in " << std::fixed << std::setprecision(3)
+              << seconds * 1000.0 << " ms, " << std::setprecision(0)
+              << (seconds > 0 ? static_cast<double>(queryCount) / seconds : 0.0) << " queries/second" << std::endl;
+
+    // Like the single lookups, the batch fails if any of its queries is not found
+    return failedCount == 0 ? 0 : 1;
+}
+
+int UCIIParser::doOperationServe(std::string socketPath, long refreshSeconds){
+    // Load the initial catalog before accepting any client
+    std::shared_ptr<const ColumnarCatalog> served = columnarCatalog();
+
+    // Return immediately if json file reading caused an error
+    if(!served){
+        return 1;
+    }
+
+    // Refresh thread is the only user of the parser once the server is started
+    UCIIServer server(socketPath, served, [this, &served]() -> std::shared_ptr<const ColumnarCatalog> {
+        std::shared_ptr<const ColumnarCatalog> refreshed = columnarCatalog(served);
+        if(refreshed){
+            served = refreshed;
+        }
+        return refreshed;
+    }, refreshSeconds);
+
+    return server.run();
+}
+
+int UCIIParser::doOperationClientRequest(std::string socketPath, std::string request){
+    std::string responseLine;
+
+    if(!UCIIServer::query(socketPath, request, responseLine)){
+        std::cout << "Server request failed: " << responseLine << std::endl;
+        return 1;
+    }
+
+    Json::CharReaderBuilder readerBuilder;
+    std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    Json::Value response;
+    std::string parseErrors;
+
+    if(!reader->parse(responseLine.data(), responseLine.data() + responseLine.size(), &response, &parseErrors) || !response.isObject()){
+        std::cout << "Invalid server response: " << responseLine << std::endl;
+        return 1;
+    }
+
+    if(!response["ok"].asBool()){
+        std::cout << "Server error: " << response["error"].asString() << std::endl;
+        return 1;
+    }
+
+    // Print the result in the format of the local operations
+    if(response.isMember("releases")){
+        output.columns({"release"});
+        for(const Json::Value& release : response["releases"]){
+            output.row({release.asString()});
+        }
+    }
+    else if(response.isMember("release")){
+        output.columns({"release"});
+        output.row({response["release"].asString()});
+    }
+    else if(response.isMember("versions")){
+        const Json::Value& versions = response["versions"];
+        if(output.structured()){
+            output.columns({version_key});
+            for(const Json::Value& t_version : versions){
+                output.row({t_version.asString()});
+            }
+        }
+        else{
+            output.text("Please use one of the following version numbers : ");
+            for(Json::ArrayIndex i = 0; i < versions.size(); i++){
+                output.text(i ? ", " : "").text(versions[i].asString());
+            }
+            output.text("\n");
+        }
+    }
+    else if(response.isMember("sha256")){
+        output.columns({"sha256"});
+        output.row({response["sha256"].asString()});
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationVerify(std::string path, std::string releaseTitle, std::string releaseCodename, std::string version){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    // Resolve the expected sha256, release title is prioritized
+    const ProductView* product = releaseTitle.empty() ? resolveRelease(releaseCodename, false) : resolveRelease(releaseTitle, true);
+    if(!product){
+        std::cout << "Could not find a matching ubuntu release " << (releaseTitle.empty() ? "codename." : "title.") << std::endl;
+        return 1;
+    }
+
+    const VersionView* t_version = Catalog::findVersion(*product, version);
+    if(!t_version){
+        std::cout << "Matching ubuntu release found but no matching version found." << std::endl;
+        doOperationFindVersions(releaseTitle, releaseCodename, true);
+        return 1;
+    }
+
+    // Hash the image
+    FileHasher fileHasher;
+    std::uint8_t digest[32];
+    if(!fileHasher.hash(path, digest)){
+        std::cout << "Could not hash the image: " << fileHasher.errorMessage() << std::endl;
+        return 1;
+    }
+
+    std::string computed = Sha256::toHex(digest);
+    bool match = computed == t_version->sha256;
+
+    if(output.structured()){
+        output.columns({"path", "expected", "computed", "result"});
+        output.row({path, t_version->sha256, computed, match ? "OK" : "MISMATCH"});
+    }
+    else{
+        output.text("expected : ").text(t_version->sha256).text("\n");
+        output.text("computed : ").text(computed).text("\n");
+        output.text(match ? "OK: " : "MISMATCH: ").text(path).text("\n");
+    }
+    output.flush();
+
+    double seconds = fileHasher.elapsedSeconds();
+    std::cerr << "hashed " << fileHasher.bytesHashed() << " bytes in " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(2) << (seconds > 0 ? fileHasher.bytesHashed() / seconds / 1e9 : 0.0) << " GB/s, "
+              << Sha256::implementation() << ")" << std::endl;
+
+    return match ? 0 : 1;
+}
+
+int UCIIParser::doOperationAudit(std::string root, std::string where, unsigned jobs){
+    // Compile the filter before fetching anything
+    CatalogQuery query;
+    if(!query.compile(where, "path,sha256,size")){
+        std::cout << "Invalid query: " << query.errorMessage() << std::endl;
+        return 1;
+    }
+
+    bool curlParseOk = obtainJsonFile(ViewFields::Items);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    MirrorAudit audit(root, jobs);
+    query.run(*catalog, [&audit](const std::vector<std::string_view>& values){
+        // Items without a path are not files of the mirror
+        if(!values[0].empty()){
+            audit.expect(std::string(values[0]), std::string(values[1]), std::strtoull(std::string(values[2]).c_str(), nullptr, 10));
+        }
+    });
+
+    // Files of the items left out by the filter are not extra files
+    if(!where.empty()){
+        CatalogQuery allItems;
+        allItems.compile("", "path");
+        allItems.run(*catalog, [&audit](const std::vector<std::string_view>& values){
+            audit.ignore(std::string(values[0]));
+        });
+    }
+
+    // Only the problems are listed, the summary counts the rest
+    std::size_t okFiles = 0;
+    std::size_t failedFiles = 0;
+    output.columns({"result", "path", "expected", "computed", "detail"});
+    audit.run([&](const MirrorAudit::Entry& entry){
+        if(entry.result == MirrorAudit::Result::Ok){
+            okFiles++;
+            return;
+        }
+        failedFiles += entry.result != MirrorAudit::Result::Extra;
+        output.row({MirrorAudit::resultName(entry.result), entry.path, entry.expected, entry.computed, entry.detail});
+    });
+    output.flush();
+
+    double seconds = audit.elapsedSeconds();
+    std::cerr << okFiles << " files ok, " << failedFiles << " missing, corrupt or unreadable, hashed " << audit.filesHashed() << " files, "
+              << audit.bytesHashed() << " bytes in " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(2) << (seconds > 0 ? audit.bytesHashed() / seconds / 1e9 : 0.0) << " GB/s, "
+              << audit.workerCount() << " workers, " << audit.stealCount() << " steals, " << Sha256::implementation() << ")" << std::endl;
+
+    return failedFiles == 0 ? 0 : 1;
+}
+
+std::string UCIIParser::mirrorRoot(const std::string& stream) const{
+    const std::string* url = &sourceUrl;
+    for(const FeedStream& t_stream : streams){
+        if(t_stream.name == stream){
+            url = &t_stream.url;
+        }
+    }
+
+    // Simplestreams indexes live under <root>/streams/v1/
+    std::size_t position = url->rfind("streams/v1/");
+    if(position == std::string::npos){
+        position = url->rfind('/') + 1;
+    }
+
+    return url->substr(0, position);
+}
+
+int UCIIParser::doOperationDownload(std::string path, std::string releaseTitle, std::string releaseCodename, std::string version, unsigned connections, std::size_t chunkSize){
+    bool curlParseOk = obtainJsonFile(ViewFields::Versions);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    // Resolve the item, release title is prioritized
+    const ProductView* product = releaseTitle.empty() ? resolveRelease(releaseCodename, false) : resolveRelease(releaseTitle, true);
+    if(!product){
+        std::cout << "Could not find a matching ubuntu release " << (releaseTitle.empty() ? "codename." : "title.") << std::endl;
+        return 1;
+    }
+
+    const VersionView* t_version = Catalog::findVersion(*product, version);
+    if(!t_version){
+        std::cout << "Matching ubuntu release found but no matching version found." << std::endl;
+        doOperationFindVersions(releaseTitle, releaseCodename, true);
+        return 1;
+    }
+    if(t_version->path.empty()){
+        std::cout << "The catalog has no disk1.img path for this version." << std::endl;
+        return 1;
+    }
+
+    // Keep the name of the item if a directory is given
+    std::error_code fileError;
+    if(std::filesystem::is_directory(path, fileError)){
+        path = (std::filesystem::path(path) / std::filesystem::path(t_version->path).filename()).string();
+    }
+
+    std::string url = mirrorRoot(product->stream) + t_version->path;
+    output.text("Downloading ").text(url).text(" to ").text(path).text("\n");
+    output.flush();
+
+    RangedDownloader downloader(transferEngine, connections, chunkSize);
+    std::uint8_t digest[32];
+    if(!downloader.download(url, path, t_version->size, digest)){
+        std::cout << "Could not download the image: " << downloader.errorMessage() << std::endl;
+        return 1;
+    }
+
+    std::string computed = Sha256::toHex(digest);
+    bool match = computed == t_version->sha256;
+
+    output.text("expected : ").text(t_version->sha256).text("\n");
+    output.text("computed : ").text(computed).text("\n");
+
+    double seconds = downloader.elapsedSeconds();
+    std::cerr << "downloaded " << downloader.bytesDownloaded() << " bytes over " << downloader.connectionsUsed() << " connections in "
+              << std::fixed << std::setprecision(3) << seconds << " s (" << std::setprecision(1)
+              << (seconds > 0 ? downloader.bytesDownloaded() / seconds / 1e6 : 0.0) << " MB/s)" << std::endl;
+
+    // Do not leave a corrupt image behind
+    if(!match){
+        std::filesystem::remove(path, fileError);
+    }
+
+    if(output.structured()){
+        output.columns({"path", "url", "expected", "computed", "result"});
+        output.row({path, url, t_version->sha256, computed, match ? "OK" : "MISMATCH"});
+    }
+    else{
+        output.text(match ? "OK: " : "MISMATCH: ").text(path).text(match ? "\n" : " is removed\n");
+    }
+
+    if(!match){
+        return 1;
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationComplete(std::string prefix, std::string releaseTitle, std::string releaseCodename){
+    bool completeVersions = !releaseTitle.empty() || !releaseCodename.empty();
+
+    // Releases are completed from the titles alone
+    bool curlParseOk = obtainJsonFile(completeVersions ? ViewFields::Versions : ViewFields::Titles);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.lookupSeconds);
+
+    if(output.structured()){
+        output.columns({"candidate", "kind"});
+    }
+
+    if(!completeVersions){
+        std::vector<ReleaseIndex::Candidate> candidates;
+        catalog->releaseIndex().complete(prefix, candidates);
+
+        for(const ReleaseIndex::Candidate& candidate : candidates){
+            if(output.structured()){
+                output.row({candidate.name, ReleaseIndex::kindName(candidate.kind)});
+            }
+            else{
+                output.text(candidate.name).text("\n");
+            }
+        }
+
+        return 0;
+    }
+
+    const ProductView* product = releaseTitle.empty() ? resolveRelease(releaseCodename, false) : resolveRelease(releaseTitle, true);
+    if(!product){
+        return 1;
+    }
+
+    // Versions are sorted, the ones starting with the prefix are contiguous
+    auto first = std::lower_bound(product->versions.begin(), product->versions.end(), prefix, [](const VersionView& lhs, const std::string& rhs){
+        return lhs.version < rhs;
+    });
+    auto last = first;
+    while(last != product->versions.end() && last->version.compare(0, prefix.size(), prefix) == 0){
+        ++last;
+    }
+
+    for(auto t_version = last; t_version != first; ){
+        --t_version;
+        if(output.structured()){
+            output.row({t_version->version, "version"});
+        }
+        else{
+            output.text(t_version->version).text("\n");
+        }
+    }
+
+    return 0;
+}
+
+int UCIIParser::doOperationQuery(std::string where, std::string select){
+    // Rows of several streams are told apart by their stream
+    if(select.empty() && streams.size() > 1){
+        select = std::string("stream,") + default_columns;
+    }
+
+    // Compile the query before fetching anything
+    CatalogQuery query;
+    if(!query.compile(where, select)){
+        std::cout << "Invalid query: " << query.errorMessage() << std::endl;
+        return 1;
+    }
+
+    bool curlParseOk = obtainJsonFile(ViewFields::Items);
+
+    // Return immediately if json file reading caused an error
+    if(!curlParseOk){
+        return 1;
+    }
+
+    RunStats::Timer timer(stats.lookupSeconds);
+
+    output.columns(query.selectedColumns());
+    query.run(*catalog, [this](const std::vector<std::string_view>& values){
+        output.row(values);
+    });
+
+    return 0;
+}
+
+// Set by the signal handler to stop watching
+static volatile std::sig_atomic_t stopWatching = 0;
+
+static void requestWatchStop(int){
+    stopWatching = 1;
+}
+
+int UCIIParser::doOperationWatch(long intervalSeconds){
+    // The events are the only output, the problems of the polls are warnings
+    setMessageStreams(std::cerr, std::cerr);
+
+    CatalogDiff diff;
+
+    // Start from the catalog of the previous run if there is one
+    if(!snapshotPath.empty()){
+        CatalogSnapshot snapshot;
+        if(snapshot.open(snapshotPath)){
+            FeedView baseline;
+            snapshot.toView(baseline, ViewFields::Versions);
+            diff.reset(std::make_shared<const Catalog>(std::move(baseline)));
+        }
+    }
+
+    output.columns({"event", "stream", release_title_key, release_codename_key, "arch", version_key, "sha256", "previous_sha256"});
+    output.flush();
+
+    CatalogDiff::Consumer writeEvent = [this](CatalogDiff::Event event, const ProductView& product, const VersionView* t_version, const VersionView* previous){
+        std::string_view versionName = t_version ? std::string_view(t_version->version) : previous ? std::string_view(previous->version) : "";
+        output.row({CatalogDiff::eventName(event), product.stream, product.releaseTitle, product.releaseCodename, product.arch, versionName,
+                    t_version ? std::string_view(t_version->sha256) : "", previous ? std::string_view(previous->sha256) : ""});
+    };
+
+    stopWatching = 0;
+    std::signal(SIGINT, requestWatchStop);
+    std::signal(SIGTERM, requestWatchStop);
+
+    while(!stopWatching){
+        // The first catalog is taken from a fresh or unchanged cached json file as well
+        watching = diff.hasBaseline();
+        feedUnchanged = false;
+
+        if(!fetchJsonFile(ViewFields::Versions)){
+            std::cerr << "Poll failed, the next poll is in " << intervalSeconds << " seconds" << std::endl;
+        }
+        // Only a changed json file is parsed and compared
+        else if(!feedUnchanged){
+            std::shared_ptr<const Catalog> polled = catalog;
+            catalog.reset();
+
+            std::size_t changes = 0;
+            if(diff.hasBaseline()){
+                changes = diff.update(polled, writeEvent);
+            }
+            else{
+                diff.reset(polled);
+            }
+
+            // Keep the catalog of the next run up to date
+            std::string error;
+            if(!snapshotPath.empty() && (changes > 0 || !std::filesystem::exists(snapshotPath)) && !CatalogSnapshot::write(polled->feedView(), snapshotPath, error)){
+                std::cerr << error << std::endl;
+            }
+        }
+
+        output.flush();
+
+        // Sleep in short steps to stop soon after a signal
+        auto wakeUp = std::chrono::steady_clock::now() + std::chrono::seconds(intervalSeconds);
+        while(!stopWatching && std::chrono::steady_clock::now() < wakeUp){
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }
 
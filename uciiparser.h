@@ -9,12 +9,69 @@
 #define UCIIPARSER_H
 
 #include "canonicalinterface.h"
+#include "catalog.h"
+#include "catalogsnapshot.h"
+#include "columnarcatalog.h"
+#include "feedcache.h"
+#include "hedgepolicy.h"
+#include "outputwriter.h"
+#include "productview.h"
+#include "releaseindex.h"
+#include "runstats.h"
+#include "transferengine.h"
+#include "ucii.h"
 #include <json/json.h>
 
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
 #define sha_key "sha"
 #define release_title_key "release_title"
 #define release_codename_key "release_codename"
 #define version_key "version"
+#define cache_dir_key "cache_dir"
+#define max_age_key "max_age"
+#define no_cache_key "no_cache"
+#define parser_key "parser"
+#define snapshot_key "snapshot"
+#define build_snapshot_key "build-snapshot"
+#define batch_key "batch"
+#define source_key "source"
+#define serve_key "serve"
+#define refresh_key "refresh"
+#define connect_key "connect"
+#define verify_key "verify"
+#define download_key "download"
+#define connections_key "connections"
+#define chunk_size_key "chunk_size"
+#define connect_timeout_key "connect_timeout"
+#define low_speed_time_key "low_speed_time"
+#define stats_key "stats"
+#define stats_json_key "stats-json"
+#define format_key "format"
+#define listversions_key "listversions"
+#define where_key "where"
+#define select_key "select"
+#define streams_key "streams"
+#define watch_key "watch"
+#define interval_key "interval"
+#define audit_key "audit"
+#define jobs_key "jobs"
+#define complete_key "complete"
+#define latest_key "latest"
+#define supported_key "supported"
+#define mirrors_key "mirrors"
+#define hedge_key "hedge"
+#define retries_key "retries"
+#define as_of_key "as-of"
+#define history_key "history"
+
+#define default_source_url "https://cloud-images.ubuntu.com/releases/streams/v1/com.ubuntu.cloud:released:download.json"
+
+// A request of the json file, defined by the parser
+struct FeedAttempt;
 
 /**
  * @class UCIIParser
@@ -38,9 +95,33 @@ public:
     enum OperationType{
         Undefined,
         AllSupportedUbuntuRelases,
+        AllVersions,
         CurrentUbuntuLTSVersion,
         FetchSha256,
-        ListVersions
+        ListVersions,
+        BuildSnapshot,
+        BatchSha256,
+        Serve,
+        ClientRequest,
+        Verify,
+        Download,
+        Query,
+        Watch,
+        Audit,
+        Complete,
+        Latest,
+        Supported,
+        History
+    };
+
+    /**
+     * @enum Available json parsers
+    */
+    enum ParserType{
+        StreamParser,
+        JsonCppParser,
+        // Structural index built with simd instructions over the complete body
+        SimdParser
     };
 
     /**
@@ -50,25 +131,226 @@ public:
     */
     virtual int requestOperation(boost::any operationType, boost::program_options::variables_map& args = Hidden::AVAL) override;
 
+    /**
+     * @brief applies the operation independent cli options (cache directory, max-age etc.) to the parser.
+     * @param args list of arguments given via cli.
+    */
+    void configure(boost::program_options::variables_map& args);
+
+    /**
+     * @brief applies the feed settings (source, streams, cache, parser and timeouts) to the parser.
+     * @throws std::invalid_argument if the parser or a stream is unknown
+    */
+    void configure(const UCIIOptions& options);
+
+    /**
+     * @brief fetches the json file and returns its compact columnar catalog, the parsed view is released. The given
+     * catalog is returned as it is if the simplestreams index shows that the json file did not change since it was built.
+     * @param current catalog built by a previous call, null for the first load
+     * @return null if the json file could not be fetched or parsed, the problem is written to the error stream.
+    */
+    std::shared_ptr<const ColumnarCatalog> columnarCatalog(const std::shared_ptr<const ColumnarCatalog>& current = nullptr);
+
+    /**
+     * @brief redirects the errors (the standard output by default) and the warnings (the standard error by default) of
+     * fetching and parsing the json file.
+    */
+    void setMessageStreams(std::ostream& errors, std::ostream& warnings);
+
 private:
-    // Fetched json data from the url
-    Json::Value jsonData;
+    // Products of the fetched json data while they are being parsed, only the fields needed by the operations are kept
+    FeedView feedView;
+    // Indexed catalog built from feedView, all operations query the catalog. It is reused by the following operations
+    // of the same process
+    std::shared_ptr<const Catalog> catalog;
+    // Fields kept in the catalog
+    ViewFields loadedFields{ViewFields::Titles};
+
+    // Parser used to build feedView, the stream parser consumes the body while it is being downloaded
+    ParserType parserType{ParserType::StreamParser};
+
+    // Location of the json file, any url supported by curl (https:// etc.) or a local file:// url
+    std::string sourceUrl{default_source_url};
+    // Equivalent copies of the json file, requested after the source fails or when it is slow to answer
+    std::vector<std::string> mirrorUrls;
+    // When the requests of the json file are hedged and retried
+    HedgePolicy hedgePolicy;
+
+    // A simplestreams feed aggregated into the catalog together with the other streams
+    struct FeedStream{
+        // Name the products of the feed are tagged with, e.g. 'daily'
+        std::string name;
+        std::string url;
+        // Every stream is cached under its own name
+        FeedCache cache;
+    };
+
+    // Streams given by the streams option, the catalog is the union of their products in this order. Empty if only
+    // the json file of the source is read.
+    std::vector<FeedStream> streams;
+
+    // Binary snapshot to answer the operations from, empty if the json file is used directly
+    std::string snapshotPath;
+
+    // If not 0, the operations are answered from the catalog that was current at this time, rebuilt from the history
+    std::time_t asOf{0};
+
+    // Provides the curl handles of all transfers, connections and dns/tls caches are reused across the fetches
+    TransferEngine transferEngine;
+
+    // Results of the operations are written through a single buffer in the selected format
+    OutputWriter output{std::cout};
+
+    // Errors and warnings of fetching and parsing the json file
+    std::ostream* errorStream{&std::cout};
+    std::ostream* warningStream{&std::cerr};
+
+    // Timings of the transfers and the phases of the invocation, reported to the standard error if requested
+    RunStats stats;
+    bool statsEnabled{false};
+    bool statsAsJson{false};
+
+    // Set while watching, the polls revalidate the json file regardless of the max-age and an unchanged json file is
+    // reported by feedUnchanged instead of being parsed again
+    bool watching{false};
+    bool feedUnchanged{false};
+
+    // On-disk cache of the downloaded json file
+    FeedCache feedCache;
+    // If false, the cache is neither read nor written
+    bool cacheEnabled{true};
+
+    /**
+     * @brief reads the json file from the cache or the url and builds the catalog of the requested fields of the amd64
+     * products. A cached body younger than the max-age is used without any network access, an older one is
+     * revalidated by a conditional request.
+     * @param fields fields of the products required by the operation
+    */
+    bool obtainJsonFile(ViewFields fields = ViewFields::Versions);
+
+    /**
+     * @brief downloads (or revalidates) the json file and parses it into feedView parameter, snapshot is not used.
+     * @param fields fields of the products required by the operation
+    */
+    bool fetchJsonFile(ViewFields fields);
+
+    /**
+     * @brief requests the json file from the source and its mirrors on a single curl multi handle. A request that has
+     * not produced its first byte within the hedge delay is hedged by a request to the next mirror, the first complete
+     * and valid response wins and the others are cancelled. Failed requests are retried after a jittered backoff.
+     * @param fields fields of the products required by the operation
+     * @return the winning request (a 304 or a 200 whose body is parsed into its view), null if every request failed.
+    */
+    std::unique_ptr<FeedAttempt> requestJsonFile(ViewFields fields);
+
+    /**
+     * @brief fetches the json files of all streams concurrently by a single curl multi handle, parses every body in its
+     * own thread as soon as its transfer completes and builds the catalog from the union of the products tagged by
+     * their stream. Fresh cached bodies and local files are parsed without waiting for the transfers, outdated cached
+     * bodies are revalidated by conditional requests.
+     * @param fields fields of the products required by the operation
+    */
+    bool fetchStreams(ViewFields fields);
+
+    /**
+     * @brief parses a complete json body into the given view. Every complete body goes through here: a response, the
+     * cached copy, a local file and the json file a snapshot is rebuilt from. Touches neither the members nor the
+     * statistics, so that several bodies can be parsed at the same time.
+     * @param source where the body comes from, e.g. 'url <url>', 'cache <path>' or 'file <path>', named in the error
+     * @param bytes the body, the strings of the view are copied out of it
+     * @param parser parser of the body, the stream parser takes the whole body as a single chunk
+     * @param error description of the problem if the body could not be parsed
+    */
+    bool parseBody(const std::string& source, std::string_view bytes, ParserType parser, ViewFields fields, FeedView& view,
+                   std::string& error) const;
+
+    /**
+     * @brief fetches the simplestreams index (streams/v1/index.json) next to the json file and returns the 'updated'
+     * stamp of the entry of the json file. The index is a few KB, comparing its stamp with the stamp of the cached body
+     * or the snapshot tells whether the large json file changed without downloading it.
+     * @param stamp 'updated' stamp of the entry
+     * @return false if the source has no index, the entry can not be found, the index does not arrive within the hedge
+     * delay or mirrors are given (the hedged requests are not delayed by the index of a slow source).
+    */
+    bool fetchIndexStamp(std::string& stamp);
+
+    /**
+     * @brief maps the binary snapshot and fills feedView parameter from it. A missing, corrupt or stale snapshot is
+     * rebuilt from the json file first.
+     * @param fields fields of the products required by the operation
+    */
+    bool loadSnapshot(ViewFields fields);
 
     /**
-     * @brief reads the json file from the url and stores it into jsonData parameter.
+     * @brief rebuilds feedView parameter from the history as it was at the time given by 'as-of'.
+     * @param fields fields of the products required by the operation, the history has no items
     */
-    bool obtainJsonFile();
+    bool loadHistory(ViewFields fields);
+
+    /**
+     * @brief appends the catalog to the history of the json file if it changed since the last record. Only the
+     * catalogs of the versions of a single json file are recorded, and only while the cache is enabled.
+    */
+    void recordHistory();
+
+    /**
+     * @brief builds the catalog from feedView parameter.
+     * @param fields fields of the products kept in feedView
+    */
+    void adoptFeedView(ViewFields fields);
+
+    /**
+     * @brief parses the cached json file into feedView parameter.
+    */
+    bool loadCachedJsonFile(ViewFields fields);
+
+    /**
+     * @brief returns true if the json file is a local file (file:// url), it is read without curl and the cache.
+    */
+    bool isLocalSource() const;
+
+    /**
+     * @brief maps the local json file into the memory and parses it in place into the catalog, the body is never copied.
+     * @param fields fields of the products required by the operation
+    */
+    bool loadLocalFile(ViewFields fields);
 
     /**
      * @brief parse all of the amd64 architecture ubuntu release versions and print them line by line.
     */
     int doOperationAllSupportedUbuntuReleases();
 
+    /**
+     * @brief print every version of all amd64 architecture ubuntu releases with the sha256 of its disk1.img, one row
+     * per version.
+    */
+    int doOperationAllVersions();
+
     /**
      * @brief parse the last released amd64 architecture LTS ubuntu version and print it.
     */
     int doOperationCurrentUbuntuLTSVersion();
 
+    /**
+     * @brief prints the newest version (serial) of the given ubuntu release and the sha256 of its disk1.img, of the
+     * release with the highest release version if none is given.
+     * @param releaseTitle ubuntu release's title, may be empty
+     * @param releaseCodename ubuntu release's codename, may be empty
+    */
+    int doOperationLatest(std::string releaseTitle, std::string releaseCodename);
+
+    /**
+     * @brief prints the supported amd64 ubuntu releases in release version order with their end of support date and
+     * newest version (serial).
+    */
+    int doOperationSupported();
+
+    /**
+     * @brief prints the catalogs recorded in the history of the json file with their time, kind, number of changes
+     * and size.
+    */
+    int doOperationHistory();
+
     /**
      * @brief parse the all amd64 architecture ubuntu releases by release title or release codename and prints the 
      * sha64 number of the disk1.img item of the given version.
@@ -86,6 +368,118 @@ private:
      * @param bypassHeadingText if true, does not display the informative text displayed on the command line at first.
     */
     int doOperationFindVersions(std::string releaseTitle, std::string releaseCodename, bool bypassHeadingText = false);
+
+    /**
+     * @brief fetch the json file and write the amd64 products and their versions into a binary snapshot file.
+     * @param path destination of the snapshot
+    */
+    int doOperationBuildSnapshot(std::string path);
+
+    /**
+     * @brief reads (release, version) queries line by line from the given file or the standard input, fetches the catalog
+     * once and prints the sha256 of the disk1.img item of every query in input order. Queries are either plain lines
+     * ('<release title or codename> <version>') or json objects ({"release_title"|"release_codename"|"release": ...,
+     * "version": ...}), results are written in the format of their query. Failed queries are reported without aborting
+     * the batch and the throughput is printed to the standard error at the end.
+     * @param source path of the query file, '-' for the standard input
+    */
+    int doOperationBatch(std::string source);
+
+    /**
+     * @brief keeps the catalog resident and answers the lookups over the given unix domain socket until interrupted.
+     * @param socketPath path of the unix domain socket
+     * @param refreshSeconds interval of the background catalog refresh, 0 disables the refresh
+    */
+    int doOperationServe(std::string socketPath, long refreshSeconds);
+
+    /**
+     * @brief sends the operation given by the cli options to a running server and prints its response.
+     * @param socketPath path of the server socket
+     * @param request request line of the operation
+    */
+    int doOperationClientRequest(std::string socketPath, std::string request);
+
+    /**
+     * @brief hashes the given local disk1.img and compares its sha256 with the one of the given ubuntu release and
+     * version in the catalog. Prints whether the digests match and the hashing throughput.
+     * @param path local image to be verified
+     * @param releaseTitle ubuntu release's title
+     * @param releaseCodename ubuntu release's codename
+     * @param version version of the given ubuntu release
+     * @return 0 if the digests match, 1 otherwise.
+    */
+    int doOperationVerify(std::string path, std::string releaseTitle, std::string releaseCodename, std::string version);
+
+    /**
+     * @brief downloads the disk1.img of the given ubuntu release and version from the mirror of the json file by
+     * concurrent range requests and verifies its sha256 while it is being downloaded.
+     * @param path destination file, or directory to keep the name of the item in
+     * @param releaseTitle ubuntu release's title
+     * @param releaseCodename ubuntu release's codename
+     * @param version version of the given ubuntu release
+     * @param connections number of concurrent range requests
+     * @param chunkSize size of each range in bytes
+     * @return 0 if the image is downloaded and its sha256 matches, 1 otherwise.
+    */
+    int doOperationDownload(std::string path, std::string releaseTitle, std::string releaseCodename, std::string version, unsigned connections, std::size_t chunkSize);
+
+    /**
+     * @brief checks a local mirror against the items of the catalog, of every version and architecture, and reports
+     * the missing, corrupt and extra files. Prints the hashing throughput.
+     * @param root root directory of the mirror
+     * @param where filter of the items to be expected, e.g. 'arch=amd64,item=disk1.img', empty for all of them
+     * @param jobs number of hashing threads, 0 for one per core
+     * @return 0 if no file is missing, corrupt or unreadable, 1 otherwise.
+    */
+    int doOperationAudit(std::string root, std::string where, unsigned jobs);
+
+    /**
+     * @brief writes the collected statistics to the standard error, as a single json line if requested.
+    */
+    void reportStats() const;
+
+    /**
+     * @brief prints the given columns of the items, versions or products of all architectures that match the given
+     * conditions, see CatalogQuery for the syntax.
+     * @param where comma separated conditions, e.g. 'arch=arm64,release>=20.04,item=*.img'
+     * @param select comma separated columns, e.g. 'version,sha256,size'
+    */
+    int doOperationQuery(std::string where, std::string select);
+
+    /**
+     * @brief polls the json file every given seconds by conditional requests until interrupted and writes the changes
+     * of the releases, versions and sha256 of the amd64 disk1.img items as events, one row per change. The first poll
+     * only sets the baseline, unless the snapshot option gives the catalog of a previous run, which is then kept up to
+     * date after every change.
+     * @param intervalSeconds interval of the polls
+    */
+    int doOperationWatch(long intervalSeconds);
+
+    /**
+     * @brief prints the release titles, codenames, release names and release versions starting with the given text (case
+     * insensitive), best candidates first, one per line for shell completion. If a release is given, prints its versions
+     * starting with the given text instead, newest first.
+     * @param prefix text typed so far, may be empty
+     * @param releaseTitle ubuntu release's title, empty to complete the release names
+     * @param releaseCodename ubuntu release's codename, empty to complete the release names
+    */
+    int doOperationComplete(std::string prefix, std::string releaseTitle, std::string releaseCodename);
+
+    /**
+     * @brief finds the product of the given release title or codename. The exact name is looked up first, otherwise the
+     * text is resolved case insensitively as the start of a title, codename, release name or release version, which
+     * succeeds if a single release matches.
+     * @param release release title or codename given by the user
+     * @param byTitle true if the release is a title, the exact lookup is done on the titles then, on the codenames otherwise
+     * @param candidates ranked candidates of the text if it is not an exact name, may be null
+    */
+    const ProductView* resolveRelease(const std::string& release, bool byTitle, std::vector<ReleaseIndex::Candidate>* candidates = nullptr) const;
+
+    /**
+     * @brief returns the root of the mirror the json file is read from, item paths of the catalog are relative to it.
+     * @param stream stream of the item, the json file of the source is used if it is not one of the streams
+    */
+    std::string mirrorRoot(const std::string& stream = "") const;
 };
 
 #endif // UCIIPARSER_H
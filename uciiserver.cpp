@@ -0,0 +1,533 @@
+/**
+ * @file uciiserver.cpp
+ * @brief This source file contains the definitions of the unix domain socket lookup server and its client
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "uciiserver.h"
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Longest request line accepted from a client
+#define max_request_length 65536
+// Responses kept for a client before its requests are no longer read, a client that does not read its responses can
+// not grow them without bounds
+#define output_high_water_mark (1 << 20)
+
+// Set by the signal handler to stop the server
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void requestStop(int){
+    stopRequested = 1;
+}
+
+UCIIServer::UCIIServer(std::string socketPath, std::shared_ptr<const ColumnarCatalog> catalog, CatalogLoader loader, long refreshSeconds)
+    : socketPath(socketPath), served(serve(catalog)), loader(loader), refreshSeconds(refreshSeconds)
+{
+
+}
+
+std::shared_ptr<const UCIIServer::ServedCatalog> UCIIServer::serve(std::shared_ptr<const ColumnarCatalog> catalog){
+    auto t_served = std::make_shared<ServedCatalog>();
+    t_served->catalog = std::move(catalog);
+    // The index refers to the strings of the catalog it is kept with
+    t_served->releases.build(*t_served->catalog);
+    return t_served;
+}
+
+// Writes the given json value as a single line
+static std::string toLine(const Json::Value& value){
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = "";
+    return Json::writeString(writerBuilder, value);
+}
+
+static std::string errorResponse(const std::string& message){
+    Json::Value response;
+    response["ok"] = false;
+    response["error"] = message;
+    return toLine(response);
+}
+
+std::string UCIIServer::handleRequest(const ColumnarCatalog& catalog, const ReleaseIndex& releases, const std::string& request){
+    std::string operation;
+    std::string releaseTitle;
+    std::string releaseCodename;
+    std::string release;
+    std::string version;
+
+    std::size_t first = request.find_first_not_of(" \t");
+    if(first == std::string::npos){
+        return errorResponse("empty request");
+    }
+
+    if(request[first] == '{'){
+        // {"op": ..., "release": ..., "release_title": ..., "release_codename": ..., "version": ...}
+        Json::CharReaderBuilder readerBuilder;
+        std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+        Json::Value query;
+        std::string parseErrors;
+
+        if(!reader->parse(request.data() + first, request.data() + request.size(), &query, &parseErrors) || !query.isObject()){
+            return errorResponse("invalid json request");
+        }
+
+        // Every field is optional but must be a string, asString() throws for the arrays and objects
+        for(const char* field : {"op", "release_title", "release_codename", "release", "version"}){
+            if(query.isMember(field) && !query[field].isString()){
+                return errorResponse("invalid json request");
+            }
+        }
+
+        operation = query.get("op", "").asString();
+        releaseTitle = query.get("release_title", "").asString();
+        releaseCodename = query.get("release_codename", "").asString();
+        release = query.get("release", "").asString();
+        version = query.get("version", "").asString();
+    }
+    else{
+        // '<op> [<release>] [<version>]', tab separated fields are split on tabs, others on spaces
+        char separator = request.find('\t') != std::string::npos ? '\t' : ' ';
+        std::size_t last = request.find_last_not_of(" \t\r");
+        std::string line = request.substr(first, last - first + 1);
+
+        std::size_t operationEnd = line.find(separator);
+        operation = line.substr(0, operationEnd);
+
+        if(operationEnd != std::string::npos){
+            std::string arguments = line.substr(operationEnd + 1);
+
+            // The version is the last field of a sha request
+            if(operation == "sha"){
+                std::size_t versionStart = arguments.find_last_of(separator);
+                if(versionStart != std::string::npos){
+                    version = arguments.substr(versionStart + 1);
+                    arguments = arguments.substr(0, versionStart);
+                }
+            }
+
+            release = arguments;
+        }
+    }
+
+    Json::Value response;
+    response["ok"] = true;
+
+    if(operation == "listall"){
+        Json::Value releases(Json::arrayValue);
+        for(std::uint32_t product = 0; product < catalog.productCount(); product++){
+            std::string release = std::string(catalog.releaseTitle(product)) + " " + std::string(catalog.releaseCodename(product)) + " "
+                + std::string(catalog.arch(product));
+            // Products of an aggregated catalog are tagged by their stream
+            if(!catalog.stream(product).empty()){
+                release += " " + std::string(catalog.stream(product));
+            }
+            releases.append(release);
+        }
+        response["releases"] = releases;
+        return toLine(response);
+    }
+
+    if(operation == "listcurr"){
+        std::uint32_t product = catalog.latestLTS();
+        if(product == ColumnarCatalog::npos){
+            return errorResponse("no LTS release found");
+        }
+        response["release"] = std::string(catalog.releaseTitle(product)) + " " + std::string(catalog.releaseCodename(product)) + " "
+            + std::string(catalog.arch(product));
+        return toLine(response);
+    }
+
+    if(operation != "versions" && operation != "sha"){
+        return errorResponse("unknown operation '" + operation + "'");
+    }
+
+    // Resolve the release, title is prioritized. An exact name is looked up first, a partial one is resolved by the
+    // prefix index if a single release matches it
+    std::uint32_t product = ColumnarCatalog::npos;
+    std::string name;
+    if(!releaseTitle.empty()){
+        name = releaseTitle;
+        product = catalog.findByTitle(releaseTitle);
+    }
+    else if(!releaseCodename.empty()){
+        name = releaseCodename;
+        product = catalog.findByCodename(releaseCodename);
+    }
+    else if(!release.empty()){
+        name = release;
+        product = catalog.findRelease(release);
+    }
+    else{
+        return errorResponse("release title or codename is missing");
+    }
+
+    if(product == ColumnarCatalog::npos){
+        std::vector<ReleaseIndex::Candidate> candidates;
+        product = releases.resolvePosition(name, &candidates);
+
+        if(product == ColumnarCatalog::npos && !candidates.empty()){
+            // List every matching release once
+            std::string matches;
+            std::vector<std::uint32_t> listed;
+            for(const ReleaseIndex::Candidate& candidate : candidates){
+                if(std::find(listed.begin(), listed.end(), candidate.position) == listed.end()){
+                    matches += (listed.empty() ? "" : ", ") + std::string(catalog.releaseTitle(candidate.position));
+                    listed.push_back(candidate.position);
+                }
+            }
+            return errorResponse("several releases match '" + name + "': " + matches);
+        }
+        if(product == ColumnarCatalog::npos){
+            return errorResponse("release not found");
+        }
+
+        // Tell which release a partial name is resolved to
+        response["release"] = std::string(catalog.releaseTitle(product)) + " " + std::string(catalog.releaseCodename(product)) + " "
+            + std::string(catalog.arch(product));
+    }
+
+    if(operation == "versions"){
+        Json::Value versions(Json::arrayValue);
+        for(std::uint32_t t_version = catalog.versionsBegin(product); t_version < catalog.versionsEnd(product); t_version++){
+            versions.append(std::string(catalog.version(t_version)));
+        }
+        response["versions"] = versions;
+        return toLine(response);
+    }
+
+    std::uint32_t t_version = catalog.findVersion(product, version);
+    if(t_version == ColumnarCatalog::npos){
+        return errorResponse(version.empty() ? "version is missing" : "version not found");
+    }
+
+    response["sha256"] = catalog.versionSha256(t_version);
+    return toLine(response);
+}
+
+void UCIIServer::refreshLoop(){
+    std::unique_lock<std::mutex> lock(refreshMutex);
+
+    while(!stopping){
+        // Sleep until the next refresh or the shutdown
+        if(refreshCondition.wait_for(lock, std::chrono::seconds(refreshSeconds), [this]{ return stopping; })){
+            break;
+        }
+
+        lock.unlock();
+
+        // Keep serving the current catalog if the refresh fails
+        std::shared_ptr<const ColumnarCatalog> refreshed;
+        try{
+            refreshed = loader();
+        }
+        catch(std::exception& e){
+            std::cerr << "Catalog refresh failed: " << e.what() << std::endl;
+        }
+
+        if(refreshed){
+            // Requests in progress keep their own reference to the previous catalog, the index is built before the swap
+            std::atomic_store(&served, serve(refreshed));
+        }
+
+        lock.lock();
+    }
+}
+
+#ifdef _WIN32
+
+int UCIIServer::run(){
+    std::cout << "Serving over a unix domain socket is not supported on this platform." << std::endl;
+    return 1;
+}
+
+bool UCIIServer::query(const std::string&, const std::string&, std::string& response){
+    response = errorResponse("unix domain sockets are not supported on this platform");
+    return false;
+}
+
+#else
+
+// Fills the socket address of the given path
+static bool socketAddress(const std::string& path, sockaddr_un& address){
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if(path.size() >= sizeof(address.sun_path)){
+        return false;
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+int UCIIServer::run(){
+    sockaddr_un address;
+    if(!socketAddress(socketPath, address)){
+        std::cout << "Socket path is too long: " << socketPath << std::endl;
+        return 1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0){
+        std::cout << "Could not create the socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // Remove the socket left by a previous server
+    struct stat status;
+    if(lstat(socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)){
+        unlink(socketPath.c_str());
+    }
+
+    if(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0){
+        std::cout << "Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listener);
+        return 1;
+    }
+
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+
+    // Stop on interrupt or terminate, a client closing its socket must not kill the server
+    stopRequested = 0;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::thread refreshThread;
+    if(refreshSeconds > 0 && loader){
+        refreshThread = std::thread(&UCIIServer::refreshLoop, this);
+    }
+
+    std::shared_ptr<const ColumnarCatalog> initial = std::atomic_load(&served)->catalog;
+    std::cerr << "Serving " << initial->productCount() << " releases (" << (initial->memoryBytes() + 1023) / 1024 << " KiB catalog) on "
+              << socketPath << std::endl;
+    initial.reset();
+
+    // Connected clients and their pending input and output
+    struct Client{
+        int descriptor;
+        std::string input;
+        // Start of the input not answered yet, the answered requests are dropped once per read
+        std::size_t inputOffset{0};
+        std::string output;
+        // The client closed its side, the descriptor is closed once its responses are sent
+        bool readClosed{false};
+    };
+    std::vector<Client> clients;
+    std::vector<pollfd> descriptors;
+    std::vector<char> buffer(1 << 16);
+
+    // Every request is answered against a single catalog, even if a refresh swaps it meanwhile
+    auto answer = [](Client& client, const ServedCatalog& current, std::string_view request){
+        // A request that fails is answered with an error, it must not stop the server
+        try{
+            client.output += handleRequest(*current.catalog, current.releases, std::string(request));
+        }
+        catch(const std::exception& exception){
+            client.output += errorResponse(std::string("internal error: ") + exception.what());
+        }
+        client.output += '\n';
+    };
+
+    while(!stopRequested){
+        descriptors.clear();
+        descriptors.push_back(pollfd{listener, POLLIN, 0});
+        for(const Client& client : clients){
+            // Stop reading the requests of a client while its responses pile up
+            short events = 0;
+            if(!client.readClosed && client.output.size() < output_high_water_mark){
+                events |= POLLIN;
+            }
+            if(!client.output.empty()){
+                events |= POLLOUT;
+            }
+            descriptors.push_back(pollfd{client.descriptor, events, 0});
+        }
+
+        // Wake up periodically to notice the stop request
+        int ready = poll(descriptors.data(), descriptors.size(), 500);
+        if(ready < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // Accept the new clients
+        if(descriptors[0].revents & POLLIN){
+            int descriptor;
+            while((descriptor = accept(listener, nullptr, nullptr)) >= 0){
+                fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+                clients.push_back(Client{descriptor, "", 0, "", false});
+            }
+        }
+
+        // Serve the clients polled in this round, new clients are at the end of the list
+        std::size_t polledClients = descriptors.size() - 1;
+        for(std::size_t i = 0; i < polledClients; i++){
+            Client& client = clients[i];
+            short events = descriptors[i + 1].revents;
+            bool closing = (events & (POLLERR | POLLNVAL)) != 0;
+            bool reading = (descriptors[i + 1].events & POLLIN) != 0;
+
+            if(!closing && reading && (events & (POLLIN | POLLHUP))){
+                ssize_t length = read(client.descriptor, buffer.data(), buffer.size());
+
+                if(length > 0){
+                    client.input.append(buffer.data(), static_cast<std::size_t>(length));
+
+                    std::shared_ptr<const ServedCatalog> current = std::atomic_load(&served);
+
+                    std::size_t lineEnd;
+                    while((lineEnd = client.input.find('\n', client.inputOffset)) != std::string::npos){
+                        answer(client, *current, std::string_view(client.input).substr(client.inputOffset, lineEnd - client.inputOffset));
+                        client.inputOffset = lineEnd + 1;
+                    }
+
+                    // Drop the answered requests once per read
+                    client.input.erase(0, client.inputOffset);
+                    client.inputOffset = 0;
+
+                    if(client.input.size() > max_request_length){
+                        closing = true;
+                    }
+                }
+                else if(length == 0){
+                    // The client is done sending, a last request without a line ending is answered too
+                    client.readClosed = true;
+                    if(client.input.find_first_not_of(" \t\r") != std::string::npos){
+                        answer(client, *std::atomic_load(&served), client.input);
+                    }
+                    std::string().swap(client.input);
+                }
+                else if(errno != EAGAIN && errno != EWOULDBLOCK){
+                    closing = true;
+                }
+            }
+
+            if(!closing && !client.output.empty()){
+                ssize_t length = send(client.descriptor, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+
+                if(length > 0){
+                    client.output.erase(0, static_cast<std::size_t>(length));
+                }
+                else if(length < 0 && errno != EAGAIN && errno != EWOULDBLOCK){
+                    closing = true;
+                }
+            }
+
+            // A client that closed its side is closed once its responses are sent
+            if(client.readClosed && client.output.empty()){
+                closing = true;
+            }
+
+            if(closing){
+                close(client.descriptor);
+                client.descriptor = -1;
+            }
+        }
+
+        // Drop the closed clients
+        std::vector<Client> openClients;
+        for(Client& client : clients){
+            if(client.descriptor >= 0){
+                openClients.push_back(std::move(client));
+            }
+        }
+        clients.swap(openClients);
+    }
+
+    // Stop the refresh thread and release the socket
+    {
+        std::lock_guard<std::mutex> lock(refreshMutex);
+        stopping = true;
+    }
+    refreshCondition.notify_all();
+    if(refreshThread.joinable()){
+        refreshThread.join();
+    }
+
+    for(const Client& client : clients){
+        close(client.descriptor);
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+
+    return 0;
+}
+
+bool UCIIServer::query(const std::string& socketPath, const std::string& request, std::string& response){
+    sockaddr_un address;
+    if(!socketAddress(socketPath, address)){
+        response = errorResponse("socket path is too long");
+        return false;
+    }
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(descriptor < 0 || connect(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0){
+        response = errorResponse("could not connect to " + socketPath + ": " + std::strerror(errno));
+        if(descriptor >= 0){
+            close(descriptor);
+        }
+        return false;
+    }
+
+    // Send the request line
+    std::string line = request + "\n";
+    std::size_t sent = 0;
+    while(sent < line.size()){
+        ssize_t length = send(descriptor, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+        if(length <= 0){
+            response = errorResponse("could not send the request");
+            close(descriptor);
+            return false;
+        }
+        sent += static_cast<std::size_t>(length);
+    }
+
+    // Read the response line
+    response.clear();
+    char buffer[4096];
+    while(response.find('\n') == std::string::npos){
+        ssize_t length = read(descriptor, buffer, sizeof(buffer));
+        if(length <= 0){
+            break;
+        }
+        response.append(buffer, static_cast<std::size_t>(length));
+    }
+    close(descriptor);
+
+    std::size_t lineEnd = response.find('\n');
+    if(lineEnd == std::string::npos){
+        response = errorResponse("connection closed before the response");
+        return false;
+    }
+    response.erase(lineEnd);
+
+    return true;
+}
+
+#endif
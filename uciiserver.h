@@ -0,0 +1,92 @@
+/**
+ * @file uciiserver.h
+ * @brief This header file contains the declarations of the unix domain socket lookup server and its client
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef UCIISERVER_H
+#define UCIISERVER_H
+
+#include "columnarcatalog.h"
+#include "releaseindex.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @class UCIIServer
+ * @brief This class keeps a columnar catalog resident and answers lookups over a unix domain socket. The catalog is
+ * refreshed by a background thread and swapped atomically, requests always read a complete catalog and never wait
+ * for a refresh.
+ *
+ * Every request is a single line and every response is a single json line. Requests are either plain text
+ *   listall | listcurr | versions <release> | sha <release> <version>
+ * (fields may also be separated by tabs, the version is the last field) or json objects
+ *   {"op": "listall|listcurr|versions|sha", "release": ..., "release_title": ..., "release_codename": ..., "version": ...}
+ * and the responses are {"ok": true, ...} or {"ok": false, "error": ...}. Release names are resolved as by the cli: an
+ * exact title or codename first, otherwise the only release whose names start with the given text (case insensitive),
+ * in which case the response tells the resolved release.
+ */
+class UCIIServer
+{
+public:
+    // Produces a new catalog, returns null if the catalog can not be loaded
+    using CatalogLoader = std::function<std::shared_ptr<const ColumnarCatalog>()>;
+
+    /**
+     * @brief UCIIServer class constructor
+     * @param socketPath path of the unix domain socket to listen on
+     * @param catalog initial catalog to be served
+     * @param loader called by the refresh thread to obtain a new catalog
+     * @param refreshSeconds interval of the background refresh, 0 disables the refresh
+    */
+    UCIIServer(std::string socketPath, std::shared_ptr<const ColumnarCatalog> catalog, CatalogLoader loader, long refreshSeconds);
+
+    /**
+     * @brief serves the requests until SIGINT or SIGTERM is received.
+     * @return 0 on a clean shutdown, 1 if the socket can not be created.
+    */
+    int run();
+
+    /**
+     * @brief answers a single request line against the given catalog.
+     * @param releases prefix index of the release names of the catalog
+    */
+    static std::string handleRequest(const ColumnarCatalog& catalog, const ReleaseIndex& releases, const std::string& request);
+
+    /**
+     * @brief sends a single request to a running server and waits for its response.
+     * @param socketPath path of the server socket
+     * @param request request line without the line ending
+     * @param response response line without the line ending
+    */
+    static bool query(const std::string& socketPath, const std::string& request, std::string& response);
+
+private:
+    // A catalog and the prefix index of its release names, swapped together
+    struct ServedCatalog{
+        std::shared_ptr<const ColumnarCatalog> catalog;
+        ReleaseIndex releases;
+    };
+
+    std::string socketPath;
+    std::shared_ptr<const ServedCatalog> served;
+    CatalogLoader loader;
+    long refreshSeconds;
+
+    // Wakes the refresh thread up on shutdown
+    std::mutex refreshMutex;
+    std::condition_variable refreshCondition;
+    bool stopping{false};
+
+    static std::shared_ptr<const ServedCatalog> serve(std::shared_ptr<const ColumnarCatalog> catalog);
+
+    void refreshLoop();
+};
+
+#endif // UCIISERVER_H
@@ -0,0 +1,108 @@
+/**
+ * @file utf8validation.cpp
+ * @brief This source file contains the definitions of the utf-8 checks shared by the json parsers
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "utf8validation.h"
+
+#include <cstring>
+
+std::size_t Utf8Validator::validate(const unsigned char* bytes, std::size_t length){
+    std::size_t i = 0;
+
+    while(i < length){
+        // Skip the ascii text eight bytes at a time
+        if(!pending && i + 8 <= length){
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            if(!(word & 0x8080808080808080ull)){
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned char c = bytes[i];
+
+        if(pending){
+            if(c < low || c > high){
+                return i;
+            }
+            low = 0x80;
+            high = 0xBF;
+            pending--;
+        }
+        // Overlong encodings, surrogates and code points above U+10FFFF are rejected by the range of the second byte
+        else if(c >= 0x80){
+            if(c >= 0xC2 && c <= 0xDF){ pending = 1; }
+            else if(c == 0xE0){ pending = 2; low = 0xA0; }
+            else if(c == 0xED){ pending = 2; high = 0x9F; }
+            else if(c >= 0xE1 && c <= 0xEF){ pending = 2; }
+            else if(c == 0xF0){ pending = 3; low = 0x90; }
+            else if(c == 0xF4){ pending = 3; high = 0x8F; }
+            else if(c >= 0xF1 && c <= 0xF3){ pending = 3; }
+            else{
+                return i;
+            }
+        }
+
+        i++;
+    }
+
+    return npos;
+}
+
+void Utf8Validator::reset(){
+    pending = 0;
+    low = 0x80;
+    high = 0xBF;
+}
+
+bool UnicodeEscapes::append(std::string& text, std::uint32_t unit){
+    if(unit >= 0xD800 && unit <= 0xDBFF){
+        // Two high surrogates in a row
+        if(highSurrogate){
+            return false;
+        }
+        highSurrogate = unit;
+        return true;
+    }
+
+    if(unit >= 0xDC00 && unit <= 0xDFFF){
+        if(!highSurrogate){
+            return false;
+        }
+        appendCodePoint(text, 0x10000 + ((highSurrogate - 0xD800) << 10) + (unit - 0xDC00));
+        highSurrogate = 0;
+        return true;
+    }
+
+    if(highSurrogate){
+        return false;
+    }
+    appendCodePoint(text, unit);
+    return true;
+}
+
+void UnicodeEscapes::appendCodePoint(std::string& text, std::uint32_t codePoint){
+    // Encode the code point as utf-8
+    if(codePoint < 0x80){
+        text.push_back(static_cast<char>(codePoint));
+    }
+    else if(codePoint < 0x800){
+        text.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if(codePoint < 0x10000){
+        text.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else{
+        text.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
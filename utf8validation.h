@@ -0,0 +1,77 @@
+/**
+ * @file utf8validation.h
+ * @brief This header file contains the declarations of the utf-8 checks shared by the json parsers
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef UTF8VALIDATION_H
+#define UTF8VALIDATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Utf8Validator
+ * @brief This class validates utf-8 text that arrives in pieces, a sequence may be split between two pieces. Overlong
+ * encodings, encoded surrogates and code points above U+10FFFF are rejected. Both json parsers validate their input
+ * through it, so that they accept and reject the same documents.
+ */
+class Utf8Validator
+{
+public:
+    // Returned by validate() if the piece is valid
+    static constexpr std::size_t npos = SIZE_MAX;
+
+    /**
+     * @brief validates the next piece of the text.
+     * @return position of the first invalid byte within the piece, npos if the piece is valid so far.
+    */
+    std::size_t validate(const unsigned char* bytes, std::size_t length);
+
+    /**
+     * @brief returns false if the last piece ended inside a sequence, the text is truncated if it ends there.
+    */
+    bool complete() const { return pending == 0; }
+
+    void reset();
+
+private:
+    // Continuation bytes expected by an unfinished sequence and the range of the next one
+    unsigned pending{0};
+    unsigned char low{0x80};
+    unsigned char high{0xBF};
+};
+
+/**
+ * @class UnicodeEscapes
+ * @brief This class decodes the \uXXXX escapes of a json string into utf-8. A high surrogate must be followed by a low
+ * surrogate escape and a low surrogate must follow a high one, a lone surrogate is not valid utf-8 once decoded.
+ */
+class UnicodeEscapes
+{
+public:
+    /**
+     * @brief appends the code unit of an escape to the text, a high surrogate waits for the low surrogate.
+     * @return false if the unit is a lone surrogate.
+    */
+    bool append(std::string& text, std::uint32_t unit);
+
+    /**
+     * @brief returns true while a high surrogate waits for its low surrogate, anything but a \u escape makes it lone.
+    */
+    bool waiting() const { return highSurrogate != 0; }
+
+    void reset() { highSurrogate = 0; }
+
+    /**
+     * @brief appends the utf-8 encoding of the given code point.
+    */
+    static void appendCodePoint(std::string& text, std::uint32_t codePoint);
+
+private:
+    std::uint32_t highSurrogate{0};
+};
+
+#endif // UTF8VALIDATION_H
@@ -0,0 +1,104 @@
+/**
+ * @file workstealingpool.cpp
+ * @brief This source file contains the definitions of the work-stealing thread pool
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#include "workstealingpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Queue of a single worker, aligned so that the locks of the workers do not share a cache line
+struct alignas(64) WorkerQueue
+{
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+};
+
+}
+
+WorkStealingPool::WorkStealingPool(unsigned workers)
+    : workers(workers)
+{
+    if(this->workers == 0){
+        this->workers = std::thread::hardware_concurrency();
+    }
+    if(this->workers == 0){
+        this->workers = 1;
+    }
+}
+
+void WorkStealingPool::run(std::size_t count, const std::function<void(std::size_t index, unsigned worker)>& task){
+    steals = 0;
+    if(count == 0){
+        return;
+    }
+
+    // No more threads than tasks
+    unsigned threads = static_cast<unsigned>(std::min<std::size_t>(workers, count));
+
+    std::unique_ptr<WorkerQueue[]> queues(new WorkerQueue[threads]);
+    for(std::size_t index = 0; index < count; index++){
+        queues[index % threads].tasks.push_back(index);
+    }
+
+    std::atomic<std::size_t> stolen{0};
+
+    auto work = [&](unsigned self){
+        for(;;){
+            std::size_t index = 0;
+            bool found = false;
+
+            {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if(!queues[self].tasks.empty()){
+                index = queues[self].tasks.front();
+                queues[self].tasks.pop_front();
+                found = true;
+            }
+            }
+
+            // No task is added during a run, so a worker that finds every queue empty is done
+            for(unsigned offset = 1; !found && offset < threads; offset++){
+                WorkerQueue& victim = queues[(self + offset) % threads];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if(!victim.tasks.empty()){
+                    index = victim.tasks.back();
+                    victim.tasks.pop_back();
+                    found = true;
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            if(!found){
+                return;
+            }
+
+            task(index, self);
+        }
+    };
+
+    // The calling thread is the first worker
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for(unsigned worker = 1; worker < threads; worker++){
+        pool.emplace_back(work, worker);
+    }
+    work(0);
+
+    for(std::thread& thread : pool){
+        thread.join();
+    }
+
+    steals = stolen.load();
+}
@@ -0,0 +1,48 @@
+/**
+ * @file workstealingpool.h
+ * @brief This header file contains the declarations of the work-stealing thread pool
+ * @author Batuhan KOÇ
+ * @date 2026-10-17
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @class WorkStealingPool
+ * @brief This class runs a batch of independent tasks on a fixed number of worker threads. The tasks are dealt to the
+ * queues of the workers in turn, every worker takes its own tasks from the front of its queue and, once it runs out,
+ * steals from the back of the queue of another worker. Tasks given in descending order of their cost are therefore
+ * started largest first and the workers that finish early take over the small ones left at the back of the others.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * @brief WorkStealingPool class constructor
+     * @param workers number of worker threads, 0 for one per core
+    */
+    explicit WorkStealingPool(unsigned workers = 0);
+
+    /**
+     * @brief runs task(index, worker) for every index in [0, count) and returns when all of them are done. Tasks must
+     * not throw.
+    */
+    void run(std::size_t count, const std::function<void(std::size_t index, unsigned worker)>& task);
+
+    unsigned workerCount() const { return workers; }
+
+    /**
+     * @brief returns the number of tasks taken from the queue of another worker by the last run.
+    */
+    std::size_t stealCount() const { return steals; }
+
+private:
+    unsigned workers;
+    std::size_t steals{0};
+};
+
+#endif // WORKSTEALINGPOOL_H